@@ -0,0 +1,394 @@
+#include "bc_encoder.h"
+#include <emmintrin.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+
+using Color = std::array<int, 4>;
+
+struct BlockBounds
+{
+    Color start;
+    Color end;
+};
+
+class BlockBitWriter
+{
+  public:
+    explicit BlockBitWriter(std::uint8_t* block) : _block(block), _position(0)
+    {
+        std::memset(_block, 0, 16);
+    }
+
+    void write(std::uint32_t value, int bitCount)
+    {
+        for (int bit = 0; bit < bitCount; bit++, _position++)
+        {
+            auto bitValue = static_cast<std::uint8_t>((value >> bit) & 1);
+            _block[_position / 8] |= static_cast<std::uint8_t>(bitValue << (_position % 8));
+        }
+    }
+
+  private:
+    std::uint8_t* _block;
+    int _position;
+};
+
+// Per-channel minimum and maximum of the block's texels.
+BlockBounds computeBounds(const std::uint8_t* texels)
+{
+    const auto* rows = reinterpret_cast<const __m128i*>(texels);
+    __m128i row0 = _mm_loadu_si128(rows);
+    __m128i row1 = _mm_loadu_si128(rows + 1);
+    __m128i row2 = _mm_loadu_si128(rows + 2);
+    __m128i row3 = _mm_loadu_si128(rows + 3);
+
+    __m128i minimum = _mm_min_epu8(_mm_min_epu8(row0, row1), _mm_min_epu8(row2, row3));
+    __m128i maximum = _mm_max_epu8(_mm_max_epu8(row0, row1), _mm_max_epu8(row2, row3));
+    minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+    maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+    minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+    maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    auto packedMinimum = static_cast<std::uint32_t>(_mm_cvtsi128_si32(minimum));
+    auto packedMaximum = static_cast<std::uint32_t>(_mm_cvtsi128_si32(maximum));
+    BlockBounds bounds{};
+    for (int channel = 0; channel < 4; channel++)
+    {
+        bounds.start[channel] = static_cast<int>((packedMinimum >> (channel * 8)) & 0xFF);
+        bounds.end[channel] = static_cast<int>((packedMaximum >> (channel * 8)) & 0xFF);
+    }
+    return bounds;
+}
+
+// Swap the bounds of channels that are anti-correlated with the channel of
+// largest extent, so the box diagonal from start to end follows the texels.
+void alignDiagonal(const std::uint8_t* texels, BlockBounds& bounds, int channelCount)
+{
+    int dominant = 0;
+    Color center{};
+    for (int channel = 0; channel < channelCount; channel++)
+    {
+        center[channel] = (bounds.start[channel] + bounds.end[channel]) / 2;
+        if (bounds.end[channel] - bounds.start[channel] >
+            bounds.end[dominant] - bounds.start[dominant])
+        {
+            dominant = channel;
+        }
+    }
+    for (int channel = 0; channel < channelCount; channel++)
+    {
+        if (channel == dominant)
+        {
+            continue;
+        }
+        int covariance = 0;
+        for (int texel = 0; texel < 16; texel++)
+        {
+            covariance += (texels[texel * 4 + dominant] - center[dominant]) *
+                          (texels[texel * 4 + channel] - center[channel]);
+        }
+        if (covariance < 0)
+        {
+            std::swap(bounds.start[channel], bounds.end[channel]);
+        }
+    }
+}
+
+// Pull both endpoints inwards by 1/16 of the extent to reduce the error of
+// the texels around the middle of the range.
+void insetBounds(BlockBounds& bounds, int channelCount)
+{
+    for (int channel = 0; channel < channelCount; channel++)
+    {
+        int inset = (bounds.end[channel] - bounds.start[channel]) / 16;
+        bounds.start[channel] += inset;
+        bounds.end[channel] -= inset;
+    }
+}
+
+// dot(texel - origin, axis) for each of the 16 texels.
+std::array<std::int32_t, 16> projectTexels(
+    const std::uint8_t* texels, const Color& origin, const Color& axis
+)
+{
+    const auto* rows = reinterpret_cast<const __m128i*>(texels);
+    __m128i zero = _mm_setzero_si128();
+    __m128i originWide = _mm_setr_epi16(
+        static_cast<short>(origin[0]), static_cast<short>(origin[1]),
+        static_cast<short>(origin[2]), static_cast<short>(origin[3]),
+        static_cast<short>(origin[0]), static_cast<short>(origin[1]),
+        static_cast<short>(origin[2]), static_cast<short>(origin[3])
+    );
+    __m128i axisWide = _mm_setr_epi16(
+        static_cast<short>(axis[0]), static_cast<short>(axis[1]), static_cast<short>(axis[2]),
+        static_cast<short>(axis[3]), static_cast<short>(axis[0]), static_cast<short>(axis[1]),
+        static_cast<short>(axis[2]), static_cast<short>(axis[3])
+    );
+
+    std::array<std::int32_t, 16> dots;
+    for (int row = 0; row < 4; row++)
+    {
+        __m128i texelRow = _mm_loadu_si128(rows + row);
+        __m128i low = _mm_sub_epi16(_mm_unpacklo_epi8(texelRow, zero), originWide);
+        __m128i high = _mm_sub_epi16(_mm_unpackhi_epi8(texelRow, zero), originWide);
+        // (r * ar + g * ag, b * ab + a * aa) per texel, then the sum of each pair.
+        __m128i lowProducts = _mm_madd_epi16(low, axisWide);
+        __m128i highProducts = _mm_madd_epi16(high, axisWide);
+        lowProducts =
+            _mm_add_epi32(lowProducts, _mm_shuffle_epi32(lowProducts, _MM_SHUFFLE(2, 3, 0, 1)));
+        highProducts =
+            _mm_add_epi32(highProducts, _mm_shuffle_epi32(highProducts, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m128i rowDots = _mm_castps_si128(_mm_shuffle_ps(
+            _mm_castsi128_ps(lowProducts), _mm_castsi128_ps(highProducts), _MM_SHUFFLE(2, 0, 2, 0)
+        ));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dots.data() + row * 4), rowDots);
+    }
+    return dots;
+}
+
+std::uint16_t packRgb565(const Color& color)
+{
+    int red = (color[0] * 31 + 127) / 255;
+    int green = (color[1] * 63 + 127) / 255;
+    int blue = (color[2] * 31 + 127) / 255;
+    return static_cast<std::uint16_t>((red << 11) | (green << 5) | blue);
+}
+
+Color unpackRgb565(std::uint16_t packed)
+{
+    int red = (packed >> 11) & 0x1F;
+    int green = (packed >> 5) & 0x3F;
+    int blue = packed & 0x1F;
+    return Color{
+        (red << 3) | (red >> 2), (green << 2) | (green >> 4), (blue << 3) | (blue >> 2), 0
+    };
+}
+
+void encodeColorBlock(const std::uint8_t* texels, std::uint8_t* block)
+{
+    BlockBounds bounds = computeBounds(texels);
+    alignDiagonal(texels, bounds, 3);
+    insetBounds(bounds, 3);
+
+    std::uint16_t color0 = packRgb565(bounds.end);
+    std::uint16_t color1 = packRgb565(bounds.start);
+    // color0 > color1 selects the opaque four-color palette.
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    std::uint32_t indices = 0;
+    if (color0 != color1)
+    {
+        Color endpoint0 = unpackRgb565(color0);
+        Color endpoint1 = unpackRgb565(color1);
+        Color axis{};
+        int lengthSquared = 0;
+        for (int channel = 0; channel < 3; channel++)
+        {
+            axis[channel] = endpoint1[channel] - endpoint0[channel];
+            lengthSquared += axis[channel] * axis[channel];
+        }
+        auto dots = projectTexels(texels, endpoint0, axis);
+        // Palette order along the axis is color0, 2/3 color0, 1/3 color0, color1.
+        constexpr std::array<std::uint32_t, 4> PaletteIndex = {0, 2, 3, 1};
+        for (int texel = 0; texel < 16; texel++)
+        {
+            int scaled = dots[texel] * 6;
+            int position = (scaled >= lengthSquared) + (scaled >= 3 * lengthSquared) +
+                           (scaled >= 5 * lengthSquared);
+            indices |= PaletteIndex[position] << (texel * 2);
+        }
+    }
+
+    block[0] = static_cast<std::uint8_t>(color0);
+    block[1] = static_cast<std::uint8_t>(color0 >> 8);
+    block[2] = static_cast<std::uint8_t>(color1);
+    block[3] = static_cast<std::uint8_t>(color1 >> 8);
+    for (int byte = 0; byte < 4; byte++)
+    {
+        block[4 + byte] = static_cast<std::uint8_t>(indices >> (byte * 8));
+    }
+}
+
+void encodeAlphaBlock(const std::uint8_t* texels, std::uint8_t* block)
+{
+    BlockBounds bounds = computeBounds(texels);
+    int alpha0 = bounds.end[3];
+    int alpha1 = bounds.start[3];
+
+    std::uint64_t indices = 0;
+    if (alpha0 > alpha1)
+    {
+        int range = alpha0 - alpha1;
+        for (int texel = 0; texel < 16; texel++)
+        {
+            // Position 0 is alpha1 and 7 is alpha0, with six interpolated values between.
+            int position = ((texels[texel * 4 + 3] - alpha1) * 7 + range / 2) / range;
+            int index = position == 7 ? 0 : position == 0 ? 1 : 8 - position;
+            indices |= static_cast<std::uint64_t>(index) << (texel * 3);
+        }
+    }
+
+    block[0] = static_cast<std::uint8_t>(alpha0);
+    block[1] = static_cast<std::uint8_t>(alpha1);
+    for (int byte = 0; byte < 6; byte++)
+    {
+        block[2 + byte] = static_cast<std::uint8_t>(indices >> (byte * 8));
+    }
+}
+
+// Quantize an endpoint to 7 bits per channel plus the p-bit shared by all
+// channels, choosing the p-bit with the smaller reconstruction error.
+void quantizeMode6Endpoint(const Color& color, Color& quantized, int& pbit)
+{
+    int bestError = -1;
+    for (int candidate = 0; candidate < 2; candidate++)
+    {
+        Color candidateQuantized{};
+        int error = 0;
+        for (int channel = 0; channel < 4; channel++)
+        {
+            candidateQuantized[channel] = std::clamp((color[channel] - candidate + 1) / 2, 0, 127);
+            int reconstructed = (candidateQuantized[channel] << 1) | candidate;
+            error += (reconstructed - color[channel]) * (reconstructed - color[channel]);
+        }
+        if (bestError < 0 || error < bestError)
+        {
+            bestError = error;
+            quantized = candidateQuantized;
+            pbit = candidate;
+        }
+    }
+}
+
+void extractBlock(
+    const assets::Image& image, std::uint32_t blockX, std::uint32_t blockY, std::uint8_t* texels
+)
+{
+    for (std::uint32_t y = 0; y < 4; y++)
+    {
+        std::uint32_t sourceY = std::min(blockY * 4 + y, image.height - 1);
+        for (std::uint32_t x = 0; x < 4; x++)
+        {
+            std::uint32_t sourceX = std::min(blockX * 4 + x, image.width - 1);
+            std::memcpy(
+                texels + (y * 4 + x) * 4,
+                &image.pixels[(std::size_t{sourceY} * image.width + sourceX) * 4],
+                4
+            );
+        }
+    }
+}
+
+}
+
+void encodeBC1Block(const std::uint8_t* texels, std::uint8_t* block)
+{
+    encodeColorBlock(texels, block);
+}
+
+void encodeBC3Block(const std::uint8_t* texels, std::uint8_t* block)
+{
+    encodeAlphaBlock(texels, block);
+    encodeColorBlock(texels, block + 8);
+}
+
+void encodeBC7Block(const std::uint8_t* texels, std::uint8_t* block)
+{
+    BlockBounds bounds = computeBounds(texels);
+    alignDiagonal(texels, bounds, 4);
+    insetBounds(bounds, 4);
+
+    Color quantized0{}, quantized1{};
+    int pbit0 = 0, pbit1 = 0;
+    quantizeMode6Endpoint(bounds.start, quantized0, pbit0);
+    quantizeMode6Endpoint(bounds.end, quantized1, pbit1);
+
+    Color endpoint0{};
+    Color axis{};
+    int lengthSquared = 0;
+    for (int channel = 0; channel < 4; channel++)
+    {
+        endpoint0[channel] = (quantized0[channel] << 1) | pbit0;
+        axis[channel] = ((quantized1[channel] << 1) | pbit1) - endpoint0[channel];
+        lengthSquared += axis[channel] * axis[channel];
+    }
+
+    std::array<int, 16> indices{};
+    if (lengthSquared > 0)
+    {
+        auto dots = projectTexels(texels, endpoint0, axis);
+        float scale = 15.0f / static_cast<float>(lengthSquared);
+        for (int texel = 0; texel < 16; texel++)
+        {
+            indices[texel] = std::clamp(static_cast<int>(dots[texel] * scale + 0.5f), 0, 15);
+        }
+    }
+    // The anchor index is stored without its most significant bit, which must be zero.
+    if (indices[0] >= 8)
+    {
+        std::swap(quantized0, quantized1);
+        std::swap(pbit0, pbit1);
+        for (auto& index : indices)
+        {
+            index = 15 - index;
+        }
+    }
+
+    BlockBitWriter writer(block);
+    writer.write(1 << 6, 7);
+    for (int channel = 0; channel < 4; channel++)
+    {
+        writer.write(static_cast<std::uint32_t>(quantized0[channel]), 7);
+        writer.write(static_cast<std::uint32_t>(quantized1[channel]), 7);
+    }
+    writer.write(static_cast<std::uint32_t>(pbit0), 1);
+    writer.write(static_cast<std::uint32_t>(pbit1), 1);
+    writer.write(static_cast<std::uint32_t>(indices[0]), 3);
+    for (int texel = 1; texel < 16; texel++)
+    {
+        writer.write(static_cast<std::uint32_t>(indices[texel]), 4);
+    }
+}
+
+std::vector<std::uint8_t> encodeImage(const assets::Image& image, assets::TextureFormat format)
+{
+    if (!assets::isBlockCompressed(format))
+    {
+        return image.pixels;
+    }
+
+    std::vector<std::uint8_t> encoded(assets::levelSize(format, image.width, image.height));
+    std::uint32_t blockSize = assets::formatUnitSize(format);
+    std::uint32_t blocksX = (image.width + 3) / 4;
+    std::uint32_t blocksY = (image.height + 3) / 4;
+    std::array<std::uint8_t, 64> texels;
+    std::uint8_t* block = encoded.data();
+    for (std::uint32_t blockY = 0; blockY < blocksY; blockY++)
+    {
+        for (std::uint32_t blockX = 0; blockX < blocksX; blockX++, block += blockSize)
+        {
+            extractBlock(image, blockX, blockY, texels.data());
+            switch (format)
+            {
+            case assets::TextureFormat::BC1:
+                encodeBC1Block(texels.data(), block);
+                break;
+            case assets::TextureFormat::BC3:
+                encodeBC3Block(texels.data(), block);
+                break;
+            default:
+                encodeBC7Block(texels.data(), block);
+                break;
+            }
+        }
+    }
+    return encoded;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <assets/image.h>
+#include <assets/texture_container.h>
+
+// Block-compression encoders for 4x4 blocks of RGBA8 texels (64 bytes, row-major).
+// Endpoints come from the inset bounding box of the block along its dominant
+// color diagonal and texels are projected onto that axis with SSE2.
+//
+// BC1 writes 8 bytes (opaque four-color mode), BC3 and BC7 write 16 bytes.
+// BC7 always uses mode 6: a single RGBA subset with 4-bit indices.
+void encodeBC1Block(const std::uint8_t* texels, std::uint8_t* block);
+void encodeBC3Block(const std::uint8_t* texels, std::uint8_t* block);
+void encodeBC7Block(const std::uint8_t* texels, std::uint8_t* block);
+
+// Encode a whole image in the given format. Edge blocks are padded by repeating
+// the last row and column. RGBA8 returns the pixels unchanged.
+std::vector<std::uint8_t> encodeImage(const assets::Image& image, assets::TextureFormat format);
@@ -0,0 +1,271 @@
+#include <logging/logs.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "commands.h"
+#include "mesh_import.h"
+#include "parallel.h"
+
+namespace
+{
+
+constexpr std::size_t DefaultTriangleCount = 2'000'000;
+constexpr int RunCount = 3;
+
+// Square grid with a wavy height field, one vertex per grid point.
+struct Grid
+{
+    std::size_t side;
+
+    std::size_t vertexCount() const
+    {
+        return (side + 1) * (side + 1);
+    }
+
+    void vertex(std::size_t index, float* position, float* texCoord, float* normal) const
+    {
+        float u = static_cast<float>(index % (side + 1)) / side;
+        float v = static_cast<float>(index / (side + 1)) / side;
+        position[0] = u * 2.0f - 1.0f;
+        position[1] = 0.05f * std::sin(u * 40.0f) * std::cos(v * 40.0f);
+        position[2] = v * 2.0f - 1.0f;
+        texCoord[0] = u;
+        texCoord[1] = v;
+        normal[0] = 0.0f;
+        normal[1] = 1.0f;
+        normal[2] = 0.0f;
+    }
+
+    // Corners of the two triangles of a grid cell.
+    std::array<std::size_t, 6> cellCorners(std::size_t cell) const
+    {
+        std::size_t x = cell % side;
+        std::size_t y = cell / side;
+        std::size_t a = y * (side + 1) + x;
+        std::size_t b = a + 1;
+        std::size_t c = a + side + 1;
+        std::size_t d = c + 1;
+        return {a, c, b, b, c, d};
+    }
+};
+
+// Wavefront OBJ with shared vertices and one quad per cell.
+bool writeObj(const std::filesystem::path& path, const Grid& grid)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        logging::error(std::format("Failed to create {}", path.string()));
+        return false;
+    }
+    std::string text;
+    float position[3], texCoord[2], normal[3];
+    for (std::size_t i = 0; i < grid.vertexCount(); i++)
+    {
+        grid.vertex(i, position, texCoord, normal);
+        text += std::format("v {} {} {}\n", position[0], position[1], position[2]);
+    }
+    for (std::size_t i = 0; i < grid.vertexCount(); i++)
+    {
+        grid.vertex(i, position, texCoord, normal);
+        text += std::format("vt {} {}\n", texCoord[0], texCoord[1]);
+    }
+    text += "vn 0 1 0\n";
+    for (std::size_t cell = 0; cell < grid.side * grid.side; cell++)
+    {
+        auto corners = grid.cellCorners(cell);
+        text += "f";
+        for (std::size_t corner : {corners[0], corners[1], corners[5], corners[2]})
+        {
+            text += std::format(" {}/{}/1", corner + 1, corner + 1);
+        }
+        text += '\n';
+        if (text.size() > (1 << 20))
+        {
+            file.write(text.data(), text.size());
+            text.clear();
+        }
+    }
+    file.write(text.data(), text.size());
+    return file.good();
+}
+
+// Binary glTF without indices, so every triangle corner is a separate vertex to weld.
+bool writeGlb(const std::filesystem::path& path, const Grid& grid)
+{
+    std::size_t cornerCount = grid.side * grid.side * 6;
+    std::vector<float> positions(cornerCount * 3);
+    std::vector<float> texCoords(cornerCount * 2);
+    std::vector<float> normals(cornerCount * 3);
+    for (std::size_t cell = 0; cell < grid.side * grid.side; cell++)
+    {
+        auto corners = grid.cellCorners(cell);
+        for (std::size_t k = 0; k < corners.size(); k++)
+        {
+            std::size_t corner = cell * 6 + k;
+            grid.vertex(
+                corners[k], &positions[corner * 3], &texCoords[corner * 2], &normals[corner * 3]
+            );
+            // glTF puts the texture origin at the top left.
+            texCoords[corner * 2 + 1] = 1.0f - texCoords[corner * 2 + 1];
+        }
+    }
+
+    std::size_t positionSize = positions.size() * sizeof(float);
+    std::size_t texCoordSize = texCoords.size() * sizeof(float);
+    std::size_t normalSize = normals.size() * sizeof(float);
+    std::string json = std::format(
+        R"({{"asset":{{"version":"2.0"}},)"
+        R"("buffers":[{{"byteLength":{}}}],)"
+        R"("bufferViews":[{{"buffer":0,"byteOffset":0,"byteLength":{}}},)"
+        R"({{"buffer":0,"byteOffset":{},"byteLength":{}}},)"
+        R"({{"buffer":0,"byteOffset":{},"byteLength":{}}}],)"
+        R"("accessors":[{{"bufferView":0,"componentType":5126,"count":{},"type":"VEC3"}},)"
+        R"({{"bufferView":1,"componentType":5126,"count":{},"type":"VEC2"}},)"
+        R"({{"bufferView":2,"componentType":5126,"count":{},"type":"VEC3"}}],)"
+        R"("meshes":[{{"primitives":[{{"attributes":)"
+        R"({{"POSITION":0,"TEXCOORD_0":1,"NORMAL":2}}}}]}}]}})",
+        positionSize + texCoordSize + normalSize,
+        positionSize,
+        positionSize,
+        texCoordSize,
+        positionSize + texCoordSize,
+        normalSize,
+        cornerCount,
+        cornerCount,
+        cornerCount
+    );
+    json.resize((json.size() + 3) / 4 * 4, ' ');
+
+    auto binarySize = static_cast<std::uint32_t>(positionSize + texCoordSize + normalSize);
+    auto jsonSize = static_cast<std::uint32_t>(json.size());
+    std::uint32_t header[] = {0x46546C67, 2, 12 + 8 + jsonSize + 8 + binarySize};
+    std::uint32_t jsonChunk[] = {jsonSize, 0x4E4F534A};
+    std::uint32_t binaryChunk[] = {binarySize, 0x004E4942};
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        logging::error(std::format("Failed to create {}", path.string()));
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(jsonChunk), sizeof(jsonChunk));
+    file.write(json.data(), json.size());
+    file.write(reinterpret_cast<const char*>(binaryChunk), sizeof(binaryChunk));
+    file.write(reinterpret_cast<const char*>(positions.data()), positionSize);
+    file.write(reinterpret_cast<const char*>(texCoords.data()), texCoordSize);
+    file.write(reinterpret_cast<const char*>(normals.data()), normalSize);
+    return file.good();
+}
+
+// Import the file a few times and log the best throughput. Returns it in MB/s, or 0 on failure.
+double measure(const std::filesystem::path& path, std::size_t threadCount, ImportedMesh& mesh)
+{
+    double best = 0.0;
+    for (int run = 0; run < RunCount; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!importMesh(path.string(), mesh, threadCount))
+        {
+            return 0.0;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::max(best, std::filesystem::file_size(path) / 1e6 / elapsed.count());
+    }
+    logging::info(std::format(
+        "  {} thread(s): {:.1f} MB/s, {} vertices, {} triangles",
+        threadCount,
+        best,
+        mesh.vertexCount(),
+        mesh.indices.size() / 3
+    ));
+    return best;
+}
+
+bool benchmark(const std::filesystem::path& path)
+{
+    logging::info(std::format(
+        "{} ({:.1f} MB)", path.filename().string(), std::filesystem::file_size(path) / 1e6
+    ));
+    ImportedMesh serialMesh{};
+    ImportedMesh parallelMesh{};
+    double serial = measure(path, 1, serialMesh);
+    double parallel = measure(path, defaultThreadCount(), parallelMesh);
+    if (serial == 0.0 || parallel == 0.0)
+    {
+        return false;
+    }
+    // Welding must give the same vertices in the same order on any thread count.
+    bool sameSubmeshes = std::equal(
+        serialMesh.submeshes.begin(),
+        serialMesh.submeshes.end(),
+        parallelMesh.submeshes.begin(),
+        parallelMesh.submeshes.end(),
+        [](const assets::Submesh& a, const assets::Submesh& b) {
+            return a.firstIndex == b.firstIndex && a.indexCount == b.indexCount &&
+                   a.materialIndex == b.materialIndex;
+        }
+    );
+    if (serialMesh.positions != parallelMesh.positions ||
+        serialMesh.texCoords != parallelMesh.texCoords ||
+        serialMesh.normals != parallelMesh.normals || serialMesh.indices != parallelMesh.indices ||
+        !sameSubmeshes)
+    {
+        logging::error("Serial and parallel imports differ");
+        return false;
+    }
+    logging::info(std::format("  speedup {:.2f}x", parallel / serial));
+    return true;
+}
+
+}
+
+int benchImport(std::span<const std::string_view> arguments)
+{
+    std::size_t triangleCount = DefaultTriangleCount;
+    bool validCount = arguments.size() == 0;
+    if (arguments.size() == 1)
+    {
+        std::string_view text = arguments[0];
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), triangleCount);
+        validCount = error == std::errc{} && end == text.data() + text.size();
+    }
+    if (!validCount)
+    {
+        logging::error("bench-import expects an optional triangle count");
+        return 1;
+    }
+
+    Grid grid{std::max<std::size_t>(
+        static_cast<std::size_t>(std::sqrt(static_cast<double>(triangleCount) / 2)), 1
+    )};
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "asset_tool_bench_import";
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    std::filesystem::path objPath = directory / "grid.obj";
+    std::filesystem::path glbPath = directory / "grid.glb";
+
+    logging::info(std::format(
+        "Writing a {}x{} grid with {} triangles to {}",
+        grid.side,
+        grid.side,
+        grid.side * grid.side * 2,
+        directory.string()
+    ));
+    bool succeeded = writeObj(objPath, grid) && writeGlb(glbPath, grid) &&
+                     benchmark(objPath) && benchmark(glbPath);
+    std::filesystem::remove_all(directory, error);
+    return succeeded ? 0 : 1;
+}
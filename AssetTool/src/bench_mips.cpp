@@ -0,0 +1,130 @@
+#include <assets/image.h>
+#include <logging/logs.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <utility>
+#include <vector>
+
+#include "commands.h"
+
+namespace
+{
+
+constexpr std::uint32_t DefaultSize = 4096;
+constexpr int RunCount = 5;
+
+// Plain 2x2 box filter with the same edge clamping and rounding as
+// assets::downsample, which must match it bit for bit.
+assets::Image downsampleScalar(const assets::Image& image)
+{
+    assets::Image result{
+        std::max<std::uint32_t>(image.width / 2, 1), std::max<std::uint32_t>(image.height / 2, 1)
+    };
+    result.pixels.resize(std::size_t{result.width} * result.height * 4);
+    for (std::uint32_t y = 0; y < result.height; y++)
+    {
+        std::size_t y0 = std::min(y * 2, image.height - 1);
+        std::size_t y1 = std::min(y * 2 + 1, image.height - 1);
+        for (std::uint32_t x = 0; x < result.width; x++)
+        {
+            std::size_t x0 = std::min(x * 2, image.width - 1);
+            std::size_t x1 = std::min(x * 2 + 1, image.width - 1);
+            for (std::size_t channel = 0; channel < 4; channel++)
+            {
+                int sum = image.pixels[(y0 * image.width + x0) * 4 + channel] +
+                          image.pixels[(y0 * image.width + x1) * 4 + channel] +
+                          image.pixels[(y1 * image.width + x0) * 4 + channel] +
+                          image.pixels[(y1 * image.width + x1) * 4 + channel];
+                result.pixels[(std::size_t{y} * result.width + x) * 4 + channel] =
+                    static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<assets::Image> generateMipChainScalar(assets::Image base)
+{
+    std::vector<assets::Image> levels;
+    levels.push_back(std::move(base));
+    while (levels.back().width > 1 || levels.back().height > 1)
+    {
+        levels.push_back(downsampleScalar(levels.back()));
+    }
+    return levels;
+}
+
+// Build the mip chain a few times and log the best time in milliseconds.
+template <typename Generate>
+double measure(
+    const char* name,
+    const assets::Image& base,
+    Generate generate,
+    std::vector<assets::Image>& chain
+)
+{
+    double best = 0.0;
+    for (int run = 0; run < RunCount; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        chain = generate(base);
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    logging::info(std::format("  {}: {:.2f} ms", name, best));
+    return best;
+}
+
+}
+
+int benchMips(std::span<const std::string_view> arguments)
+{
+    std::uint32_t size = DefaultSize;
+    bool validSize = arguments.size() == 0;
+    if (arguments.size() == 1)
+    {
+        std::string_view text = arguments[0];
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), size);
+        validSize = error == std::errc{} && end == text.data() + text.size() && size > 0;
+    }
+    if (!validSize)
+    {
+        logging::error("bench-mips expects an optional image size");
+        return 1;
+    }
+
+    // Noise, so the sums of neighbours hit every rounding case.
+    assets::Image base{size, size, std::vector<std::uint8_t>(std::size_t{size} * size * 4)};
+    std::uint32_t state = 1;
+    for (std::uint8_t& channel : base.pixels)
+    {
+        state = state * 1664525 + 1013904223;
+        channel = static_cast<std::uint8_t>(state >> 24);
+    }
+
+    logging::info(std::format("Mip chain of a {}x{} RGBA8 image", size, size));
+    std::vector<assets::Image> scalarChain;
+    std::vector<assets::Image> chain;
+    double scalar = measure("scalar", base, generateMipChainScalar, scalarChain);
+    double vectorized = measure("SSE2", base, assets::generateMipChain, chain);
+    bool identical = std::equal(
+        chain.begin(),
+        chain.end(),
+        scalarChain.begin(),
+        scalarChain.end(),
+        [](const assets::Image& a, const assets::Image& b) {
+            return a.width == b.width && a.height == b.height && a.pixels == b.pixels;
+        }
+    );
+    if (!identical)
+    {
+        logging::error("SSE2 and scalar mip chains differ");
+        return 1;
+    }
+    logging::info(std::format("  bit-identical, speedup {:.2f}x", scalar / vectorized));
+    return 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <span>
+#include <string_view>
+
+// Entry points of the asset tool's sub-commands. Each receives the arguments
+// following the command name and returns the process exit code.
+
+// compress-texture <input image> <output .ltex> [rgba8|bc1|bc3|bc7]
+int compressTexture(std::span<const std::string_view> arguments);
+
+// convert-mesh <input .obj/.gltf/.glb> <output .lmesh>
+//              [--no-optimize] [--quantize[=half]] [--lods]
+int convertMesh(std::span<const std::string_view> arguments);
+
+// bench-import [triangle count]
+int benchImport(std::span<const std::string_view> arguments);
+
+// bench-mips [image size]
+int benchMips(std::span<const std::string_view> arguments);
@@ -0,0 +1,126 @@
+#include <stb/stb_image.h>
+#include <logging/logs.h>
+#include <assets/image.h>
+#include <assets/texture_container.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bc_encoder.h"
+#include "commands.h"
+
+namespace
+{
+
+std::optional<assets::TextureFormat> parseFormat(std::string_view name)
+{
+    if (name == "rgba8")
+    {
+        return assets::TextureFormat::RGBA8;
+    }
+    if (name == "bc1")
+    {
+        return assets::TextureFormat::BC1;
+    }
+    if (name == "bc3")
+    {
+        return assets::TextureFormat::BC3;
+    }
+    if (name == "bc7")
+    {
+        return assets::TextureFormat::BC7;
+    }
+    return std::nullopt;
+}
+
+bool isOpaque(const assets::Image& image)
+{
+    for (std::size_t i = 3; i < image.pixels.size(); i += 4)
+    {
+        if (image.pixels[i] != 255)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int compressTexture(std::span<const std::string_view> arguments)
+{
+    if (arguments.size() < 2 || arguments.size() > 3)
+    {
+        logging::error("compress-texture expects an input image, an output file and a format");
+        return 1;
+    }
+
+    std::string inputPath(arguments[0]);
+    std::string outputPath(arguments[1]);
+
+    int width, height, colorChannelCount;
+    // Match the runtime, which stores rows bottom to top.
+    stbi_set_flip_vertically_on_load(1);
+    stbi_uc* data =
+        stbi_load(inputPath.c_str(), &width, &height, &colorChannelCount, STBI_rgb_alpha);
+    if (data == nullptr)
+    {
+        logging::error(std::format("Failed to load {}: {}", inputPath, stbi_failure_reason()));
+        return 1;
+    }
+    assets::Image base{static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)};
+    base.pixels.assign(data, data + std::size_t{base.width} * base.height * 4);
+    stbi_image_free(data);
+
+    assets::TextureFormat format =
+        isOpaque(base) ? assets::TextureFormat::BC1 : assets::TextureFormat::BC3;
+    if (arguments.size() == 3)
+    {
+        auto requestedFormat = parseFormat(arguments[2]);
+        if (!requestedFormat)
+        {
+            logging::error(std::format("Unknown texture format: {}", arguments[2]));
+            return 1;
+        }
+        format = *requestedFormat;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<assets::Image> mipChain = assets::generateMipChain(std::move(base));
+
+    std::vector<std::vector<std::uint8_t>> levelData(mipChain.size());
+    for (std::size_t level = 0; level < mipChain.size(); level++)
+    {
+        levelData[level] = encodeImage(mipChain[level], format);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint32_t baseWidth = mipChain.front().width;
+    std::uint32_t baseHeight = mipChain.front().height;
+    if (!assets::writeTextureContainer(outputPath, format, baseWidth, baseHeight, levelData))
+    {
+        logging::error(std::format("Failed to write {}", outputPath));
+        return 1;
+    }
+
+    std::uint64_t uncompressedSize = std::uint64_t{baseWidth} * baseHeight * 4;
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(outputPath, error);
+    logging::info(std::format(
+        "{} -> {}: {}x{}, {} levels, {} bytes (base level {:.2f}x smaller than RGBA8) in {:.1f} ms",
+        inputPath,
+        outputPath,
+        baseWidth,
+        baseHeight,
+        levelData.size(),
+        fileSize,
+        static_cast<double>(uncompressedSize) / static_cast<double>(levelData.front().size()),
+        elapsed.count()
+    ));
+    return 0;
+}
@@ -0,0 +1,304 @@
+#include <logging/logs.h>
+#include <assets/mesh_container.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "commands.h"
+#include "mesh_import.h"
+#include "mesh_optimize.h"
+#include "mesh_simplify.h"
+#include "vertex_encode.h"
+
+namespace
+{
+
+// Meshes up to this many vertices get 16-bit indices. 0xFFFF stays unused as
+// it doubles as the primitive restart index.
+constexpr std::size_t MaxUInt16VertexCount = 0xFFFF;
+
+// How positions are stored. Texture coordinates and normals follow: unquantized
+// meshes keep floats, quantized ones use 16-bit texture coordinates and
+// octahedral normals.
+enum class PositionFormat
+{
+    Float32,
+    Float16,
+    SNorm16,
+};
+
+// Interleave the imported attributes in the order position, texture coordinates, normal.
+assets::MeshData interleave(const ImportedMesh& mesh, PositionFormat positionFormat)
+{
+    bool quantized = positionFormat != PositionFormat::Float32;
+    assets::MeshData data{};
+    data.boundsMin.fill(std::numeric_limits<float>::max());
+    data.boundsMax.fill(std::numeric_limits<float>::lowest());
+    for (std::size_t vertex = 0; vertex < mesh.vertexCount(); vertex++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float value = mesh.positions[vertex * 3 + axis];
+            data.boundsMin[axis] = std::min(data.boundsMin[axis], value);
+            data.boundsMax[axis] = std::max(data.boundsMax[axis], value);
+        }
+    }
+    // Quantized positions are stored relative to the centre of the bounds, and
+    // normalized ones also relative to their extent.
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float extent = (data.boundsMax[axis] - data.boundsMin[axis]) / 2.0f;
+        data.positionBias[axis] = quantized ? data.boundsMin[axis] + extent : 0.0f;
+        data.positionScale[axis] =
+            positionFormat == PositionFormat::SNorm16 && extent > 0.0f ? extent : 1.0f;
+    }
+
+    // Normalized texture coordinates cannot repeat, fall back to half floats for those.
+    auto texCoordType = assets::VertexComponentType::Float32;
+    if (quantized)
+    {
+        bool normalized = std::all_of(mesh.texCoords.begin(), mesh.texCoords.end(), [](float v) {
+            return v >= 0.0f && v <= 1.0f;
+        });
+        texCoordType = normalized ? assets::VertexComponentType::UNorm16
+                                  : assets::VertexComponentType::Float16;
+    }
+    auto positionType = positionFormat == PositionFormat::Float16
+                            ? assets::VertexComponentType::Float16
+                        : positionFormat == PositionFormat::SNorm16
+                            ? assets::VertexComponentType::SNorm16
+                            : assets::VertexComponentType::Float32;
+
+    // Attributes start at multiples of 4 bytes as vertex fetch expects.
+    std::uint32_t stride = 0;
+    auto addAttribute = [&](assets::VertexSemantic semantic,
+                            assets::VertexComponentType type,
+                            std::uint32_t componentCount) {
+        data.attributes.push_back(assets::VertexAttribute{semantic, type, componentCount, stride});
+        stride += (componentCount * assets::componentSize(type) + 3) & ~3u;
+        return data.attributes.back();
+    };
+    assets::VertexAttribute position =
+        addAttribute(assets::VertexSemantic::Position, positionType, 3);
+    assets::VertexAttribute texCoord{};
+    if (!mesh.texCoords.empty())
+    {
+        texCoord = addAttribute(assets::VertexSemantic::TexCoord, texCoordType, 2);
+    }
+    assets::VertexAttribute normal{};
+    if (!mesh.normals.empty())
+    {
+        normal = quantized ? addAttribute(
+                                 assets::VertexSemantic::Normal,
+                                 assets::VertexComponentType::SNorm16,
+                                 2
+                             )
+                           : addAttribute(
+                                 assets::VertexSemantic::Normal,
+                                 assets::VertexComponentType::Float32,
+                                 3
+                             );
+    }
+    data.vertexStride = stride;
+
+    auto writeComponents = [](std::uint8_t* out,
+                              assets::VertexComponentType type,
+                              const float* values,
+                              std::size_t count) {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            switch (type)
+            {
+            case assets::VertexComponentType::Float16:
+            {
+                std::uint16_t half = encodeHalf(values[i]);
+                std::memcpy(out + i * sizeof(half), &half, sizeof(half));
+                break;
+            }
+            case assets::VertexComponentType::SNorm16:
+            {
+                std::int16_t snorm = encodeSNorm16(values[i]);
+                std::memcpy(out + i * sizeof(snorm), &snorm, sizeof(snorm));
+                break;
+            }
+            case assets::VertexComponentType::UNorm16:
+            {
+                std::uint16_t unorm = encodeUNorm16(values[i]);
+                std::memcpy(out + i * sizeof(unorm), &unorm, sizeof(unorm));
+                break;
+            }
+            default:
+                std::memcpy(out + i * sizeof(float), &values[i], sizeof(float));
+                break;
+            }
+        }
+    };
+
+    data.vertices.resize(mesh.vertexCount() * stride);
+    for (std::size_t vertex = 0; vertex < mesh.vertexCount(); vertex++)
+    {
+        std::uint8_t* out = &data.vertices[vertex * stride];
+        float stored[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            stored[axis] = (mesh.positions[vertex * 3 + axis] - data.positionBias[axis]) /
+                           data.positionScale[axis];
+        }
+        writeComponents(out + position.offset, position.componentType, stored, 3);
+        if (!mesh.texCoords.empty())
+        {
+            writeComponents(
+                out + texCoord.offset, texCoord.componentType, &mesh.texCoords[vertex * 2], 2
+            );
+        }
+        if (!mesh.normals.empty())
+        {
+            if (quantized)
+            {
+                std::array<float, 2> encoded = encodeOctahedral(&mesh.normals[vertex * 3]);
+                writeComponents(out + normal.offset, normal.componentType, encoded.data(), 2);
+            }
+            else
+            {
+                writeComponents(
+                    out + normal.offset, normal.componentType, &mesh.normals[vertex * 3], 3
+                );
+            }
+        }
+    }
+
+    if (mesh.vertexCount() <= MaxUInt16VertexCount)
+    {
+        data.indexFormat = assets::IndexFormat::UInt16;
+        std::vector<std::uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+        data.indices.resize(indices.size() * sizeof(std::uint16_t));
+        std::memcpy(data.indices.data(), indices.data(), data.indices.size());
+    }
+    else
+    {
+        data.indexFormat = assets::IndexFormat::UInt32;
+        data.indices.resize(mesh.indices.size() * sizeof(std::uint32_t));
+        std::memcpy(data.indices.data(), mesh.indices.data(), data.indices.size());
+    }
+    data.submeshes = mesh.submeshes;
+    return data;
+}
+
+}
+
+int convertMesh(std::span<const std::string_view> arguments)
+{
+    if (arguments.size() < 2)
+    {
+        logging::error("convert-mesh expects an input mesh and an output file");
+        return 1;
+    }
+    bool optimize = true;
+    bool generateLevels = false;
+    PositionFormat positionFormat = PositionFormat::Float32;
+    for (std::string_view option : arguments.subspan(2))
+    {
+        if (option == "--no-optimize")
+        {
+            optimize = false;
+        }
+        else if (option == "--lods")
+        {
+            generateLevels = true;
+        }
+        else if (option == "--quantize")
+        {
+            positionFormat = PositionFormat::SNorm16;
+        }
+        else if (option == "--quantize=half")
+        {
+            positionFormat = PositionFormat::Float16;
+        }
+        else
+        {
+            logging::error(std::format("Unknown convert-mesh option {}", option));
+            return 1;
+        }
+    }
+
+    std::string inputPath(arguments[0]);
+    std::string outputPath(arguments[1]);
+
+    auto start = std::chrono::steady_clock::now();
+    ImportedMesh mesh{};
+    if (!importMesh(inputPath, mesh))
+    {
+        return 1;
+    }
+    if (mesh.indices.empty())
+    {
+        logging::error(std::format("{} contains no triangles", inputPath));
+        return 1;
+    }
+    std::size_t triangleCount = mesh.indices.size() / 3;
+    std::size_t submeshCount = mesh.submeshes.size();
+    std::vector<assets::MeshLod> lods{
+        assets::MeshLod{0, static_cast<std::uint32_t>(mesh.submeshes.size()), 0.0f, 0}
+    };
+    if (generateLevels)
+    {
+        lods = generateLods(mesh);
+        for (std::size_t i = 0; i < lods.size(); i++)
+        {
+            std::size_t indexCount = 0;
+            for (std::uint32_t k = 0; k < lods[i].submeshCount; k++)
+            {
+                indexCount += mesh.submeshes[lods[i].firstSubmesh + k].indexCount;
+            }
+            logging::info(std::format(
+                "LOD {}: {} triangles, error {:.6f}", i, indexCount / 3, lods[i].error
+            ));
+        }
+    }
+    if (optimize)
+    {
+        VertexCacheStatistics before = analyzeVertexCache(mesh.indices, mesh.vertexCount());
+        optimizeMesh(mesh);
+        VertexCacheStatistics after = analyzeVertexCache(mesh.indices, mesh.vertexCount());
+        logging::info(std::format(
+            "Vertex cache of {} entries: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+            VertexCacheSize,
+            before.acmr,
+            after.acmr,
+            before.atvr,
+            after.atvr
+        ));
+    }
+    assets::MeshData data = interleave(mesh, positionFormat);
+    data.lods = lods;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!assets::writeMeshContainer(outputPath, data))
+    {
+        logging::error(std::format("Failed to write {}", outputPath));
+        return 1;
+    }
+
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(outputPath, error);
+    logging::info(std::format(
+        "{} -> {}: {} vertices of {} bytes, {} triangles, {} submeshes, {} levels of detail, "
+        "{} bytes in {:.1f} ms",
+        inputPath,
+        outputPath,
+        mesh.vertexCount(),
+        data.vertexStride,
+        triangleCount,
+        submeshCount,
+        lods.size(),
+        fileSize,
+        elapsed.count()
+    ));
+    return 0;
+}
@@ -0,0 +1,527 @@
+#include <logging/logs.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+#include "mesh_import.h"
+#include "parallel.h"
+#include "vertex_weld.h"
+
+namespace
+{
+
+constexpr std::uint32_t GlbMagic = 0x46546C67;
+constexpr std::uint32_t GlbJsonChunk = 0x4E4F534A;
+constexpr std::uint32_t GlbBinaryChunk = 0x004E4942;
+
+constexpr std::uint32_t ComponentUnsignedByte = 5121;
+constexpr std::uint32_t ComponentUnsignedShort = 5123;
+constexpr std::uint32_t ComponentUnsignedInt = 5125;
+constexpr std::uint32_t ComponentFloat = 5126;
+constexpr std::size_t PrimitiveTriangles = 4;
+
+std::optional<std::string> readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+std::optional<std::vector<std::uint8_t>> decodeBase64(std::string_view text)
+{
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(text.size() / 4 * 3);
+    std::uint32_t bits = 0;
+    int bitCount = 0;
+    for (char character : text)
+    {
+        std::uint32_t value;
+        if (character >= 'A' && character <= 'Z')
+        {
+            value = character - 'A';
+        }
+        else if (character >= 'a' && character <= 'z')
+        {
+            value = character - 'a' + 26;
+        }
+        else if (character >= '0' && character <= '9')
+        {
+            value = character - '0' + 52;
+        }
+        else if (character == '+')
+        {
+            value = 62;
+        }
+        else if (character == '/')
+        {
+            value = 63;
+        }
+        else if (character == '=')
+        {
+            break;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+        bits = (bits << 6) | value;
+        bitCount += 6;
+        if (bitCount >= 8)
+        {
+            bitCount -= 8;
+            bytes.push_back(static_cast<std::uint8_t>(bits >> bitCount));
+        }
+    }
+    return bytes;
+}
+
+class GltfReader
+{
+  public:
+    GltfReader(std::string path, JsonValue document, std::vector<std::uint8_t> binaryChunk)
+        : _path(std::move(path)),
+          _document(std::move(document)),
+          _binaryChunk(std::move(binaryChunk))
+    {
+    }
+
+    bool loadBuffers()
+    {
+        const JsonValue& buffers = _document["buffers"];
+        for (std::size_t i = 0; i < buffers.size(); i++)
+        {
+            std::string_view uri = buffers[i]["uri"].string();
+            std::optional<std::vector<std::uint8_t>> data;
+            if (uri.empty())
+            {
+                // Only the first buffer of a .glb file may refer to the binary chunk.
+                data = i == 0 ? std::optional(std::move(_binaryChunk)) : std::nullopt;
+            }
+            else if (uri.starts_with("data:"))
+            {
+                std::size_t separator = uri.find(";base64,");
+                if (separator != std::string_view::npos)
+                {
+                    data = decodeBase64(uri.substr(separator + 8));
+                }
+            }
+            else
+            {
+                auto contents =
+                    readFile(std::filesystem::path(_path).parent_path() / std::string(uri));
+                if (contents)
+                {
+                    data = std::vector<std::uint8_t>(contents->begin(), contents->end());
+                }
+            }
+            auto byteLength = static_cast<std::size_t>(buffers[i]["byteLength"].number());
+            if (!data || data->size() < byteLength)
+            {
+                logging::error(std::format("{}: failed to load buffer {}", _path, i));
+                return false;
+            }
+            _buffers.push_back(std::move(*data));
+        }
+        return true;
+    }
+
+    // Read the float elements of an accessor with the given component count.
+    bool readFloats(
+        std::size_t accessor, std::size_t componentCount, std::vector<float>& values
+    ) const
+    {
+        const JsonValue& description = _document["accessors"][accessor];
+        if (description["componentType"].index() != ComponentFloat ||
+            typeComponentCount(description["type"].string()) != componentCount)
+        {
+            logging::error(std::format("{}: accessor {} is not a float vector", _path, accessor));
+            return false;
+        }
+        std::size_t count = description["count"].index();
+        values.resize(count * componentCount);
+        return forEachElement(
+            description,
+            componentCount * sizeof(float),
+            [&](std::size_t element, const std::uint8_t* data) {
+                std::memcpy(
+                    &values[element * componentCount], data, componentCount * sizeof(float)
+                );
+            }
+        );
+    }
+
+    bool readIndices(std::size_t accessor, std::vector<std::uint32_t>& indices) const
+    {
+        const JsonValue& description = _document["accessors"][accessor];
+        std::size_t componentType = description["componentType"].index();
+        std::size_t size = componentType == ComponentUnsignedByte    ? 1
+                           : componentType == ComponentUnsignedShort ? 2
+                           : componentType == ComponentUnsignedInt   ? 4
+                                                                     : 0;
+        if (size == 0 || typeComponentCount(description["type"].string()) != 1)
+        {
+            logging::error(std::format("{}: accessor {} is not an index list", _path, accessor));
+            return false;
+        }
+        indices.resize(description["count"].index());
+        return forEachElement(
+            description,
+            size,
+            [&](std::size_t element, const std::uint8_t* data) {
+                std::uint32_t index = 0;
+                std::memcpy(&index, data, size);
+                indices[element] = index;
+            }
+        );
+    }
+
+    const JsonValue& document() const
+    {
+        return _document;
+    }
+
+    const std::string& path() const
+    {
+        return _path;
+    }
+
+  private:
+    std::string _path;
+    JsonValue _document;
+    std::vector<std::uint8_t> _binaryChunk;
+    std::vector<std::vector<std::uint8_t>> _buffers;
+
+    static std::size_t typeComponentCount(std::string_view type)
+    {
+        if (type == "SCALAR")
+        {
+            return 1;
+        }
+        if (type.size() == 4 && type.starts_with("VEC") && type[3] >= '2' && type[3] <= '4')
+        {
+            return static_cast<std::size_t>(type[3] - '0');
+        }
+        return 0;
+    }
+
+    // Call the function with the bytes of every element, checking all ranges first.
+    template <typename Function>
+    bool forEachElement(
+        const JsonValue& accessor, std::size_t elementSize, Function function
+    ) const
+    {
+        std::size_t count = accessor["count"].index();
+        if (accessor["bufferView"].isNull() || !accessor["sparse"].isNull())
+        {
+            logging::error(std::format("{}: sparse or empty accessors are not supported", _path));
+            return false;
+        }
+        const JsonValue& view = _document["bufferViews"][accessor["bufferView"].index()];
+        std::size_t buffer = view["buffer"].index(_buffers.size());
+        std::size_t stride = view["byteStride"].index(elementSize);
+        std::size_t offset = view["byteOffset"].index() + accessor["byteOffset"].index();
+        std::size_t viewEnd = view["byteOffset"].index() + view["byteLength"].index();
+        if (buffer >= _buffers.size() || stride < elementSize ||
+            (count > 0 && offset + (count - 1) * stride + elementSize > viewEnd) ||
+            viewEnd > _buffers[buffer].size())
+        {
+            logging::error(std::format("{}: accessor out of buffer bounds", _path));
+            return false;
+        }
+        for (std::size_t element = 0; element < count; element++)
+        {
+            function(element, &_buffers[buffer][offset + element * stride]);
+        }
+        return true;
+    }
+};
+
+std::optional<GltfReader> openGltf(const std::string& path)
+{
+    auto contents = readFile(path);
+    if (!contents)
+    {
+        logging::error(std::format("Failed to open {}", path));
+        return std::nullopt;
+    }
+
+    std::string_view json = *contents;
+    std::vector<std::uint8_t> binaryChunk;
+    std::uint32_t magic = 0;
+    if (contents->size() >= 4)
+    {
+        std::memcpy(&magic, contents->data(), 4);
+    }
+    if (magic == GlbMagic)
+    {
+        // 12 byte header followed by chunks of length, type and data.
+        json = {};
+        std::size_t position = 12;
+        while (position + 8 <= contents->size())
+        {
+            std::uint32_t length, type;
+            std::memcpy(&length, contents->data() + position, 4);
+            std::memcpy(&type, contents->data() + position + 4, 4);
+            position += 8;
+            if (position + length > contents->size())
+            {
+                break;
+            }
+            if (type == GlbJsonChunk && json.empty())
+            {
+                json = std::string_view(*contents).substr(position, length);
+            }
+            else if (type == GlbBinaryChunk && binaryChunk.empty())
+            {
+                binaryChunk.assign(
+                    contents->begin() + static_cast<std::ptrdiff_t>(position),
+                    contents->begin() + static_cast<std::ptrdiff_t>(position + length)
+                );
+            }
+            position += length;
+        }
+    }
+
+    auto document = parseJson(json);
+    if (!document || !document->isObject())
+    {
+        logging::error(std::format("{}: invalid glTF document", path));
+        return std::nullopt;
+    }
+    GltfReader reader(path, std::move(*document), std::move(binaryChunk));
+    if (!reader.loadBuffers())
+    {
+        return std::nullopt;
+    }
+    return reader;
+}
+
+// Triangle primitive of one of the meshes and the data read from it.
+struct Primitive
+{
+    std::size_t mesh;
+    const JsonValue* description;
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<float> normals;
+    std::vector<std::uint32_t> indices;
+};
+
+bool readPrimitive(const GltfReader& reader, Primitive& primitive, bool texCoords, bool normals)
+{
+    const JsonValue& attributes = (*primitive.description)["attributes"];
+    if (!reader.readFloats(attributes["POSITION"].index(), 3, primitive.positions))
+    {
+        return false;
+    }
+    std::size_t vertexCount = primitive.positions.size() / 3;
+
+    // Attributes present on other primitives are zero where missing.
+    if (texCoords)
+    {
+        if (attributes["TEXCOORD_0"].isNull())
+        {
+            primitive.texCoords.assign(vertexCount * 2, 0.0f);
+        }
+        else if (!reader.readFloats(attributes["TEXCOORD_0"].index(), 2, primitive.texCoords))
+        {
+            return false;
+        }
+        // glTF puts the texture origin at the top left.
+        for (std::size_t i = 1; i < primitive.texCoords.size(); i += 2)
+        {
+            primitive.texCoords[i] = 1.0f - primitive.texCoords[i];
+        }
+    }
+    if (normals)
+    {
+        if (attributes["NORMAL"].isNull())
+        {
+            primitive.normals.assign(vertexCount * 3, 0.0f);
+        }
+        else if (!reader.readFloats(attributes["NORMAL"].index(), 3, primitive.normals))
+        {
+            return false;
+        }
+    }
+    if (primitive.texCoords.size() / 2 != (texCoords ? vertexCount : 0) ||
+        primitive.normals.size() / 3 != (normals ? vertexCount : 0))
+    {
+        logging::error(std::format(
+            "{}: attribute counts of mesh {} differ", reader.path(), primitive.mesh
+        ));
+        return false;
+    }
+
+    const JsonValue& indices = (*primitive.description)["indices"];
+    if (indices.isNull())
+    {
+        primitive.indices.resize(vertexCount);
+        for (std::size_t i = 0; i < vertexCount; i++)
+        {
+            primitive.indices[i] = static_cast<std::uint32_t>(i);
+        }
+    }
+    else if (!reader.readIndices(indices.index(), primitive.indices))
+    {
+        return false;
+    }
+    primitive.indices.resize(primitive.indices.size() / 3 * 3);
+    for (std::uint32_t index : primitive.indices)
+    {
+        if (index >= vertexCount)
+        {
+            logging::error(std::format(
+                "{}: index out of range in mesh {}", reader.path(), primitive.mesh
+            ));
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+bool importGltf(const std::string& path, ImportedMesh& mesh, std::size_t threadCount)
+{
+    auto reader = openGltf(path);
+    if (!reader)
+    {
+        return false;
+    }
+
+    std::vector<Primitive> primitives;
+    bool hasTexCoords = false;
+    bool hasNormals = false;
+    const JsonValue& meshes = reader->document()["meshes"];
+    for (std::size_t i = 0; i < meshes.size(); i++)
+    {
+        const JsonValue& meshPrimitives = meshes[i]["primitives"];
+        for (std::size_t j = 0; j < meshPrimitives.size(); j++)
+        {
+            const JsonValue& primitive = meshPrimitives[j];
+            const JsonValue& attributes = primitive["attributes"];
+            if (primitive["mode"].index(PrimitiveTriangles) != PrimitiveTriangles ||
+                attributes["POSITION"].isNull())
+            {
+                logging::info(std::format(
+                    "{}: skipping primitive {} of mesh {} without triangles", path, j, i
+                ));
+                continue;
+            }
+            hasTexCoords |= !attributes["TEXCOORD_0"].isNull();
+            hasNormals |= !attributes["NORMAL"].isNull();
+            primitives.push_back(Primitive{i, &primitive});
+        }
+    }
+
+    std::vector<char> primitiveValid(primitives.size());
+    parallelFor(primitives.size(), threadCount, [&](std::size_t i) {
+        primitiveValid[i] = readPrimitive(*reader, primitives[i], hasTexCoords, hasNormals);
+    });
+    if (std::find(primitiveValid.begin(), primitiveValid.end(), false) != primitiveValid.end())
+    {
+        return false;
+    }
+
+    // Concatenate the primitives, one submesh each.
+    ImportedMesh merged{};
+    for (const Primitive& primitive : primitives)
+    {
+        auto baseVertex = static_cast<std::uint32_t>(merged.vertexCount());
+        merged.positions.insert(
+            merged.positions.end(), primitive.positions.begin(), primitive.positions.end()
+        );
+        merged.texCoords.insert(
+            merged.texCoords.end(), primitive.texCoords.begin(), primitive.texCoords.end()
+        );
+        merged.normals.insert(
+            merged.normals.end(), primitive.normals.begin(), primitive.normals.end()
+        );
+        merged.submeshes.push_back(assets::Submesh{
+            static_cast<std::uint32_t>(merged.indices.size()),
+            static_cast<std::uint32_t>(primitive.indices.size()),
+            static_cast<std::uint32_t>((*primitive.description)["material"].index()),
+            0,
+        });
+        for (std::uint32_t index : primitive.indices)
+        {
+            merged.indices.push_back(baseVertex + index);
+        }
+    }
+
+    // Exporters often split vertices that are identical, weld them by value.
+    auto bitsEqual = [](const std::vector<float>& values, std::size_t width, std::size_t a,
+                        std::size_t b) {
+        return std::memcmp(&values[a * width], &values[b * width], width * sizeof(float)) == 0;
+    };
+    WeldResult weld = weldElements(
+        merged.vertexCount(),
+        [&](std::size_t i) {
+            std::uint64_t hash = 0;
+            auto mixValues = [&](const std::vector<float>& values, std::size_t width) {
+                for (std::size_t k = 0; k < width && !values.empty(); k++)
+                {
+                    std::uint32_t bits;
+                    std::memcpy(&bits, &values[i * width + k], sizeof(bits));
+                    hash = mixHash(hash, bits);
+                }
+            };
+            mixValues(merged.positions, 3);
+            mixValues(merged.texCoords, 2);
+            mixValues(merged.normals, 3);
+            return hash;
+        },
+        [&](std::size_t a, std::size_t b) {
+            return bitsEqual(merged.positions, 3, a, b) &&
+                   (merged.texCoords.empty() || bitsEqual(merged.texCoords, 2, a, b)) &&
+                   (merged.normals.empty() || bitsEqual(merged.normals, 3, a, b));
+        },
+        threadCount
+    );
+
+    std::size_t vertexCount = weld.representatives.size();
+    mesh = {};
+    mesh.positions.resize(vertexCount * 3);
+    mesh.texCoords.resize(hasTexCoords ? vertexCount * 2 : 0);
+    mesh.normals.resize(hasNormals ? vertexCount * 3 : 0);
+    parallelRanges(vertexCount, threadCount, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t vertex = begin; vertex < end; vertex++)
+        {
+            std::size_t source = weld.representatives[vertex];
+            std::copy_n(&merged.positions[source * 3], 3, &mesh.positions[vertex * 3]);
+            if (hasTexCoords)
+            {
+                std::copy_n(&merged.texCoords[source * 2], 2, &mesh.texCoords[vertex * 2]);
+            }
+            if (hasNormals)
+            {
+                std::copy_n(&merged.normals[source * 3], 3, &mesh.normals[vertex * 3]);
+            }
+        }
+    });
+    mesh.indices.resize(merged.indices.size());
+    parallelRanges(mesh.indices.size(), threadCount, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            mesh.indices[i] = weld.remap[merged.indices[i]];
+        }
+    });
+    mesh.submeshes = std::move(merged.submeshes);
+    return true;
+}
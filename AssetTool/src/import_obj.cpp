@@ -0,0 +1,450 @@
+#include <logging/logs.h>
+#include <assets/mapped_file.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mesh_import.h"
+#include "parallel.h"
+#include "vertex_weld.h"
+
+namespace
+{
+
+// Chunks per thread, so threads finishing early can pick up more work.
+constexpr std::size_t ChunksPerThread = 4;
+// Smallest chunk worth handing to a thread.
+constexpr std::size_t MinChunkSize = 64 * 1024;
+// Relative indices are stored minus this bias until the element counts of the
+// preceding chunks are known.
+constexpr std::int64_t RelativeIndexBias = std::int64_t{1} << 48;
+
+// Position, texture coordinate and normal indices of a face corner, 1-based and 0 if absent.
+struct Corner
+{
+    std::uint32_t position;
+    std::uint32_t texCoord;
+    std::uint32_t normal;
+};
+
+// Corner indices as written in a chunk: positive absolute indices, 0 if absent
+// and relative indices resolved against the chunk's own element counts.
+struct ChunkCorner
+{
+    std::int64_t position;
+    std::int64_t texCoord;
+    std::int64_t normal;
+};
+
+// Everything read from a range of whole lines of the file.
+struct ObjChunk
+{
+    std::string_view text;
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<float> normals;
+    // Three corners per triangle.
+    std::vector<ChunkCorner> corners;
+    // Material names set at the given triangle. Triangles before the first run
+    // keep the material of the previous chunk.
+    std::vector<std::pair<std::size_t, std::string>> materialRuns;
+    std::size_t lineCount;
+    bool hasTexCoords;
+    bool hasNormals;
+    // Line within the chunk of the first error and its keyword.
+    std::size_t errorLine;
+    std::string_view errorKeyword;
+
+    // Material of every triangle, filled in after parsing.
+    std::vector<std::uint32_t> triangleMaterials;
+};
+
+std::string_view nextToken(std::string_view& line)
+{
+    std::size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+    std::size_t end = line.find_first_of(" \t\r", begin);
+    std::string_view token = line.substr(begin, end - begin);
+    line = end == std::string_view::npos ? std::string_view{} : line.substr(end);
+    return token;
+}
+
+bool parseFloats(std::string_view line, std::vector<float>& values, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        std::string_view token = nextToken(line);
+        float value{};
+        auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (token.empty() || error != std::errc{})
+        {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return true;
+}
+
+// Parse one index of a face corner. Negative indices count back from the
+// elements read so far in the chunk.
+bool parseIndex(std::string_view token, std::size_t chunkElementCount, std::int64_t& index)
+{
+    if (token.empty())
+    {
+        index = 0;
+        return true;
+    }
+    std::int64_t value{};
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (error != std::errc{} || end != token.data() + token.size() || value == 0)
+    {
+        return false;
+    }
+    index = value > 0 ? value
+                      : static_cast<std::int64_t>(chunkElementCount) + value + 1 -
+                            RelativeIndexBias;
+    return true;
+}
+
+bool parseFace(std::string_view line, ObjChunk& chunk)
+{
+    constexpr auto None = std::string_view::npos;
+    ChunkCorner first{};
+    ChunkCorner previous{};
+    std::size_t cornerCount = 0;
+    for (std::string_view token = nextToken(line); !token.empty(); token = nextToken(line))
+    {
+        // v, v/vt, v//vn or v/vt/vn
+        std::size_t firstSlash = token.find('/');
+        std::size_t secondSlash = firstSlash == None ? None : token.find('/', firstSlash + 1);
+        std::string_view positionToken = token.substr(0, firstSlash);
+        std::string_view texCoordToken =
+            firstSlash == None ? std::string_view{}
+                               : token.substr(firstSlash + 1, secondSlash - firstSlash - 1);
+        std::string_view normalToken =
+            secondSlash == None ? std::string_view{} : token.substr(secondSlash + 1);
+
+        ChunkCorner corner{};
+        if (positionToken.empty() ||
+            !parseIndex(positionToken, chunk.positions.size() / 3, corner.position) ||
+            !parseIndex(texCoordToken, chunk.texCoords.size() / 2, corner.texCoord) ||
+            !parseIndex(normalToken, chunk.normals.size() / 3, corner.normal))
+        {
+            return false;
+        }
+        chunk.hasTexCoords |= corner.texCoord != 0;
+        chunk.hasNormals |= corner.normal != 0;
+
+        // Triangulate as a fan around the first corner.
+        if (cornerCount == 0)
+        {
+            first = corner;
+        }
+        else if (cornerCount >= 2)
+        {
+            chunk.corners.insert(chunk.corners.end(), {first, previous, corner});
+        }
+        previous = corner;
+        cornerCount++;
+    }
+    return cornerCount >= 3;
+}
+
+void parseChunk(ObjChunk& chunk)
+{
+    std::string_view remaining = chunk.text;
+    while (!remaining.empty())
+    {
+        std::size_t lineEnd = remaining.find('\n');
+        std::string_view line = remaining.substr(0, lineEnd);
+        remaining = lineEnd == std::string_view::npos ? std::string_view{}
+                                                      : remaining.substr(lineEnd + 1);
+        chunk.lineCount++;
+
+        std::string_view keyword = nextToken(line);
+        bool valid = true;
+        if (keyword == "v")
+        {
+            valid = parseFloats(line, chunk.positions, 3);
+        }
+        else if (keyword == "vt")
+        {
+            valid = parseFloats(line, chunk.texCoords, 2);
+        }
+        else if (keyword == "vn")
+        {
+            valid = parseFloats(line, chunk.normals, 3);
+        }
+        else if (keyword == "f")
+        {
+            valid = parseFace(line, chunk);
+        }
+        else if (keyword == "usemtl")
+        {
+            chunk.materialRuns.emplace_back(chunk.corners.size() / 3, nextToken(line));
+        }
+        if (!valid)
+        {
+            chunk.errorLine = chunk.lineCount;
+            chunk.errorKeyword = keyword;
+            return;
+        }
+    }
+}
+
+// Resolve a chunk index given the elements in preceding chunks and in the whole file.
+// Returns false if the index is out of range.
+bool resolveIndex(std::int64_t index, std::size_t base, std::size_t total, std::uint32_t& resolved)
+{
+    if (index < 0)
+    {
+        index += RelativeIndexBias + static_cast<std::int64_t>(base);
+        if (index <= 0)
+        {
+            return false;
+        }
+    }
+    if (index > static_cast<std::int64_t>(total))
+    {
+        return false;
+    }
+    resolved = static_cast<std::uint32_t>(index);
+    return true;
+}
+
+}
+
+bool importObj(const std::string& path, ImportedMesh& mesh, std::size_t threadCount)
+{
+    assets::MappedFile file(path);
+    if (!file.isOpen())
+    {
+        logging::error(std::format("Failed to open {}", path));
+        return false;
+    }
+    std::string_view text(
+        reinterpret_cast<const char*>(file.bytes().data()), file.bytes().size()
+    );
+
+    // Split the file at line ends into chunks of about the same size and parse them in parallel.
+    std::size_t chunkCount = std::clamp<std::size_t>(
+        text.size() / MinChunkSize, 1, std::max<std::size_t>(threadCount, 1) * ChunksPerThread
+    );
+    std::vector<ObjChunk> chunks(chunkCount);
+    std::size_t chunkBegin = 0;
+    for (std::size_t i = 0; i < chunkCount; i++)
+    {
+        std::size_t chunkEnd = text.size();
+        if (i + 1 < chunkCount)
+        {
+            std::size_t split = std::max(text.size() * (i + 1) / chunkCount, chunkBegin);
+            std::size_t lineEnd = text.find('\n', split);
+            chunkEnd = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+        }
+        chunks[i].text = text.substr(chunkBegin, chunkEnd - chunkBegin);
+        chunkBegin = chunkEnd;
+    }
+    parallelFor(chunkCount, threadCount, [&](std::size_t i) { parseChunk(chunks[i]); });
+
+    // Element and corner offsets of each chunk, and materials in order of first use.
+    // Material 0 holds the faces before the first usemtl statement.
+    std::vector<std::size_t> positionBase(chunkCount + 1);
+    std::vector<std::size_t> texCoordBase(chunkCount + 1);
+    std::vector<std::size_t> normalBase(chunkCount + 1);
+    std::vector<std::size_t> cornerBase(chunkCount + 1);
+    std::unordered_map<std::string, std::uint32_t> materials;
+    std::uint32_t material = 0;
+    bool hasTexCoords = false;
+    bool hasNormals = false;
+    std::size_t lineNumber = 0;
+    for (std::size_t i = 0; i < chunkCount; i++)
+    {
+        ObjChunk& chunk = chunks[i];
+        if (chunk.errorLine != 0)
+        {
+            logging::error(std::format(
+                "{}:{}: invalid {} statement",
+                path,
+                lineNumber + chunk.errorLine,
+                chunk.errorKeyword
+            ));
+            return false;
+        }
+        lineNumber += chunk.lineCount;
+        positionBase[i + 1] = positionBase[i] + chunk.positions.size() / 3;
+        texCoordBase[i + 1] = texCoordBase[i] + chunk.texCoords.size() / 2;
+        normalBase[i + 1] = normalBase[i] + chunk.normals.size() / 3;
+        cornerBase[i + 1] = cornerBase[i] + chunk.corners.size();
+        hasTexCoords |= chunk.hasTexCoords;
+        hasNormals |= chunk.hasNormals;
+
+        chunk.triangleMaterials.resize(chunk.corners.size() / 3);
+        auto runBegin = chunk.triangleMaterials.begin();
+        for (const auto& [firstTriangle, name] : chunk.materialRuns)
+        {
+            auto runEnd = chunk.triangleMaterials.begin() + firstTriangle;
+            std::fill(runBegin, runEnd, material);
+            auto newMaterial = static_cast<std::uint32_t>(materials.size() + 1);
+            material = materials.try_emplace(name, newMaterial).first->second;
+            runBegin = runEnd;
+        }
+        std::fill(runBegin, chunk.triangleMaterials.end(), material);
+    }
+    if (positionBase[chunkCount] > UINT32_MAX || cornerBase[chunkCount] > UINT32_MAX)
+    {
+        logging::error(std::format("{}: too many elements for 32-bit indices", path));
+        return false;
+    }
+
+    // Gather the elements into single arrays and resolve the corners against them.
+    std::vector<Corner> corners(cornerBase[chunkCount]);
+    std::vector<float> positions(positionBase[chunkCount] * 3);
+    std::vector<float> texCoords(texCoordBase[chunkCount] * 2);
+    std::vector<float> normals(normalBase[chunkCount] * 3);
+    std::vector<char> chunkValid(chunkCount, true);
+    parallelFor(chunkCount, threadCount, [&](std::size_t i) {
+        const ObjChunk& chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), &positions[positionBase[i] * 3]);
+        std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), &texCoords[texCoordBase[i] * 2]);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), &normals[normalBase[i] * 3]);
+        for (std::size_t j = 0; j < chunk.corners.size(); j++)
+        {
+            const ChunkCorner& corner = chunk.corners[j];
+            Corner& resolved = corners[cornerBase[i] + j];
+            bool valid =
+                resolveIndex(
+                    corner.position, positionBase[i], positionBase[chunkCount], resolved.position
+                ) &&
+                resolved.position != 0 &&
+                resolveIndex(
+                    corner.texCoord, texCoordBase[i], texCoordBase[chunkCount], resolved.texCoord
+                ) &&
+                resolveIndex(corner.normal, normalBase[i], normalBase[chunkCount], resolved.normal);
+            if (!valid)
+            {
+                chunkValid[i] = false;
+                return;
+            }
+        }
+    });
+    if (std::find(chunkValid.begin(), chunkValid.end(), false) != chunkValid.end())
+    {
+        logging::error(std::format("{}: face index out of range", path));
+        return false;
+    }
+
+    // Corners referencing the same elements become one vertex.
+    WeldResult weld = weldElements(
+        corners.size(),
+        [&](std::size_t i) {
+            return mixHash(mixHash(corners[i].position, corners[i].texCoord), corners[i].normal);
+        },
+        [&](std::size_t a, std::size_t b) {
+            return corners[a].position == corners[b].position &&
+                   corners[a].texCoord == corners[b].texCoord &&
+                   corners[a].normal == corners[b].normal;
+        },
+        threadCount
+    );
+
+    std::size_t vertexCount = weld.representatives.size();
+    mesh = {};
+    mesh.positions.resize(vertexCount * 3);
+    mesh.texCoords.resize(hasTexCoords ? vertexCount * 2 : 0);
+    mesh.normals.resize(hasNormals ? vertexCount * 3 : 0);
+    parallelRanges(vertexCount, threadCount, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t vertex = begin; vertex < end; vertex++)
+        {
+            const Corner& corner = corners[weld.representatives[vertex]];
+            std::copy_n(&positions[(corner.position - 1) * 3], 3, &mesh.positions[vertex * 3]);
+            if (hasTexCoords && corner.texCoord != 0)
+            {
+                std::copy_n(&texCoords[(corner.texCoord - 1) * 2], 2, &mesh.texCoords[vertex * 2]);
+            }
+            if (hasNormals && corner.normal != 0)
+            {
+                std::copy_n(&normals[(corner.normal - 1) * 3], 3, &mesh.normals[vertex * 3]);
+            }
+        }
+    });
+
+    // One submesh per material, keeping file order within each material.
+    // triangleBase[material][chunk] is where the chunk's triangles of the material go.
+    std::size_t materialCount = materials.size() + 1;
+    std::vector<std::vector<std::size_t>> triangleBase(
+        materialCount, std::vector<std::size_t>(chunkCount + 1)
+    );
+    for (std::size_t i = 0; i < chunkCount; i++)
+    {
+        for (std::uint32_t triangleMaterial : chunks[i].triangleMaterials)
+        {
+            triangleBase[triangleMaterial][i + 1]++;
+        }
+    }
+    std::size_t triangleCount = 0;
+    for (std::size_t m = 0; m < materialCount; m++)
+    {
+        std::size_t materialBegin = triangleCount;
+        for (std::size_t i = 0; i < chunkCount; i++)
+        {
+            std::size_t chunkTriangleCount = triangleBase[m][i + 1];
+            triangleBase[m][i] = triangleCount;
+            triangleCount += chunkTriangleCount;
+        }
+        if (triangleCount > materialBegin)
+        {
+            mesh.submeshes.push_back(assets::Submesh{
+                static_cast<std::uint32_t>(materialBegin * 3),
+                static_cast<std::uint32_t>((triangleCount - materialBegin) * 3),
+                static_cast<std::uint32_t>(m),
+                0,
+            });
+        }
+    }
+    mesh.indices.resize(triangleCount * 3);
+    parallelFor(chunkCount, threadCount, [&](std::size_t i) {
+        std::vector<std::size_t> nextTriangle(materialCount);
+        for (std::size_t m = 0; m < materialCount; m++)
+        {
+            nextTriangle[m] = triangleBase[m][i];
+        }
+        const std::vector<std::uint32_t>& triangleMaterials = chunks[i].triangleMaterials;
+        for (std::size_t triangle = 0; triangle < triangleMaterials.size(); triangle++)
+        {
+            std::size_t target = nextTriangle[triangleMaterials[triangle]]++ * 3;
+            for (std::size_t corner = 0; corner < 3; corner++)
+            {
+                mesh.indices[target + corner] = weld.remap[cornerBase[i] + triangle * 3 + corner];
+            }
+        }
+    });
+    return true;
+}
+
+bool importMesh(const std::string& path, ImportedMesh& mesh, std::size_t threadCount)
+{
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    if (extension == ".obj")
+    {
+        return importObj(path, mesh, threadCount);
+    }
+    if (extension == ".gltf" || extension == ".glb")
+    {
+        return importGltf(path, mesh, threadCount);
+    }
+    logging::error(std::format("Unsupported mesh format: {}", path));
+    return false;
+}
@@ -0,0 +1,391 @@
+#include "json.h"
+#include <charconv>
+#include <cstdint>
+
+namespace
+{
+
+const JsonValue NullValue{};
+
+class JsonParser
+{
+  public:
+    explicit JsonParser(std::string_view text) : _text(text), _position{}
+    {
+    }
+
+    std::optional<JsonValue> parseDocument()
+    {
+        auto value = parseValue();
+        skipWhitespace();
+        if (!value || _position != _text.size())
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+  private:
+    // Nesting deeper than this is rejected rather than risking the stack.
+    static constexpr int MaxDepth = 256;
+
+    std::string_view _text;
+    std::size_t _position;
+    int _depth{};
+
+    void skipWhitespace()
+    {
+        while (_position < _text.size() &&
+               (_text[_position] == ' ' || _text[_position] == '\t' ||
+                _text[_position] == '\n' || _text[_position] == '\r'))
+        {
+            _position++;
+        }
+    }
+
+    bool consume(char expected)
+    {
+        skipWhitespace();
+        if (_position < _text.size() && _text[_position] == expected)
+        {
+            _position++;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeWord(std::string_view word)
+    {
+        if (_text.substr(_position, word.size()) == word)
+        {
+            _position += word.size();
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<JsonValue> parseValue()
+    {
+        skipWhitespace();
+        if (_position == _text.size() || _depth > MaxDepth)
+        {
+            return std::nullopt;
+        }
+        switch (_text[_position])
+        {
+        case '{':
+            return parseObject();
+        case '[':
+            return parseArray();
+        case '"':
+        {
+            auto string = parseString();
+            if (!string)
+            {
+                return std::nullopt;
+            }
+            return JsonValue(std::move(*string));
+        }
+        case 't':
+            return consumeWord("true") ? std::optional(JsonValue(true)) : std::nullopt;
+        case 'f':
+            return consumeWord("false") ? std::optional(JsonValue(false)) : std::nullopt;
+        case 'n':
+            return consumeWord("null") ? std::optional(JsonValue()) : std::nullopt;
+        default:
+            return parseNumber();
+        }
+    }
+
+    std::optional<JsonValue> parseObject()
+    {
+        _position++;
+        _depth++;
+        JsonValue::Object members;
+        if (!consume('}'))
+        {
+            do
+            {
+                skipWhitespace();
+                auto name = parseString();
+                if (!name || !consume(':'))
+                {
+                    return std::nullopt;
+                }
+                auto value = parseValue();
+                if (!value)
+                {
+                    return std::nullopt;
+                }
+                members.emplace_back(std::move(*name), std::move(*value));
+            } while (consume(','));
+            if (!consume('}'))
+            {
+                return std::nullopt;
+            }
+        }
+        _depth--;
+        return JsonValue(std::move(members));
+    }
+
+    std::optional<JsonValue> parseArray()
+    {
+        _position++;
+        _depth++;
+        JsonValue::Array elements;
+        if (!consume(']'))
+        {
+            do
+            {
+                auto value = parseValue();
+                if (!value)
+                {
+                    return std::nullopt;
+                }
+                elements.push_back(std::move(*value));
+            } while (consume(','));
+            if (!consume(']'))
+            {
+                return std::nullopt;
+            }
+        }
+        _depth--;
+        return JsonValue(std::move(elements));
+    }
+
+    std::optional<JsonValue> parseNumber()
+    {
+        double value{};
+        const char* begin = _text.data() + _position;
+        const char* end = _text.data() + _text.size();
+        auto [next, error] = std::from_chars(begin, end, value);
+        if (error != std::errc{})
+        {
+            return std::nullopt;
+        }
+        _position += static_cast<std::size_t>(next - begin);
+        return JsonValue(value);
+    }
+
+    std::optional<std::uint32_t> parseHexDigits()
+    {
+        std::uint32_t codePoint{};
+        const char* begin = _text.data() + _position;
+        if (_text.size() - _position < 4)
+        {
+            return std::nullopt;
+        }
+        auto [next, error] = std::from_chars(begin, begin + 4, codePoint, 16);
+        if (error != std::errc{} || next != begin + 4)
+        {
+            return std::nullopt;
+        }
+        _position += 4;
+        return codePoint;
+    }
+
+    static void appendUtf8(std::string& string, std::uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            string += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            string += static_cast<char>(0xC0 | (codePoint >> 6));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            string += static_cast<char>(0xE0 | (codePoint >> 12));
+            string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            string += static_cast<char>(0xF0 | (codePoint >> 18));
+            string += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    std::optional<std::string> parseString()
+    {
+        if (_position == _text.size() || _text[_position] != '"')
+        {
+            return std::nullopt;
+        }
+        _position++;
+        std::string string;
+        while (_position < _text.size() && _text[_position] != '"')
+        {
+            char character = _text[_position++];
+            if (character != '\\')
+            {
+                string += character;
+                continue;
+            }
+            if (_position == _text.size())
+            {
+                return std::nullopt;
+            }
+            char escape = _text[_position++];
+            switch (escape)
+            {
+            case 'b':
+                string += '\b';
+                break;
+            case 'f':
+                string += '\f';
+                break;
+            case 'n':
+                string += '\n';
+                break;
+            case 'r':
+                string += '\r';
+                break;
+            case 't':
+                string += '\t';
+                break;
+            case 'u':
+            {
+                auto codePoint = parseHexDigits();
+                if (!codePoint)
+                {
+                    return std::nullopt;
+                }
+                // Characters outside the basic plane are escaped as surrogate pairs.
+                if (*codePoint >= 0xD800 && *codePoint < 0xDC00 && consumeWord("\\u"))
+                {
+                    auto low = parseHexDigits();
+                    if (!low || *low < 0xDC00 || *low >= 0xE000)
+                    {
+                        return std::nullopt;
+                    }
+                    *codePoint = 0x10000 + ((*codePoint - 0xD800) << 10) + (*low - 0xDC00);
+                }
+                appendUtf8(string, *codePoint);
+                break;
+            }
+            default:
+                string += escape;
+                break;
+            }
+        }
+        if (_position == _text.size())
+        {
+            return std::nullopt;
+        }
+        _position++;
+        return string;
+    }
+};
+
+}
+
+JsonValue::JsonValue() : _value(nullptr)
+{
+}
+
+JsonValue::JsonValue(bool value) : _value(value)
+{
+}
+
+JsonValue::JsonValue(double value) : _value(value)
+{
+}
+
+JsonValue::JsonValue(std::string value) : _value(std::move(value))
+{
+}
+
+JsonValue::JsonValue(Array value) : _value(std::move(value))
+{
+}
+
+JsonValue::JsonValue(Object value) : _value(std::move(value))
+{
+}
+
+bool JsonValue::isNull() const
+{
+    return std::holds_alternative<std::nullptr_t>(_value);
+}
+
+bool JsonValue::isNumber() const
+{
+    return std::holds_alternative<double>(_value);
+}
+
+bool JsonValue::isString() const
+{
+    return std::holds_alternative<std::string>(_value);
+}
+
+bool JsonValue::isArray() const
+{
+    return std::holds_alternative<Array>(_value);
+}
+
+bool JsonValue::isObject() const
+{
+    return std::holds_alternative<Object>(_value);
+}
+
+double JsonValue::number(double fallback) const
+{
+    const double* value = std::get_if<double>(&_value);
+    return value != nullptr ? *value : fallback;
+}
+
+std::size_t JsonValue::index(std::size_t fallback) const
+{
+    const double* value = std::get_if<double>(&_value);
+    return value != nullptr && *value >= 0.0 ? static_cast<std::size_t>(*value) : fallback;
+}
+
+std::string_view JsonValue::string(std::string_view fallback) const
+{
+    const std::string* value = std::get_if<std::string>(&_value);
+    return value != nullptr ? std::string_view(*value) : fallback;
+}
+
+std::size_t JsonValue::size() const
+{
+    if (const Array* array = std::get_if<Array>(&_value))
+    {
+        return array->size();
+    }
+    if (const Object* object = std::get_if<Object>(&_value))
+    {
+        return object->size();
+    }
+    return 0;
+}
+
+const JsonValue& JsonValue::operator[](std::string_view name) const
+{
+    if (const Object* object = std::get_if<Object>(&_value))
+    {
+        for (const auto& [memberName, value] : *object)
+        {
+            if (memberName == name)
+            {
+                return value;
+            }
+        }
+    }
+    return NullValue;
+}
+
+const JsonValue& JsonValue::operator[](std::size_t position) const
+{
+    const Array* array = std::get_if<Array>(&_value);
+    return array != nullptr && position < array->size() ? (*array)[position] : NullValue;
+}
+
+std::optional<JsonValue> parseJson(std::string_view text)
+{
+    return JsonParser(text).parseDocument();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Parsed JSON value. Only what reading glTF files needs: lookups return a null
+// value instead of failing, so missing properties can be handled with fallbacks.
+class JsonValue
+{
+  public:
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue();
+    explicit JsonValue(bool value);
+    explicit JsonValue(double value);
+    explicit JsonValue(std::string value);
+    explicit JsonValue(Array value);
+    explicit JsonValue(Object value);
+
+    bool isNull() const;
+    bool isNumber() const;
+    bool isString() const;
+    bool isArray() const;
+    bool isObject() const;
+
+    // The value if it has the requested type, the fallback otherwise.
+    double number(double fallback = 0.0) const;
+    std::size_t index(std::size_t fallback = 0) const;
+    std::string_view string(std::string_view fallback = {}) const;
+
+    // Member or element count, 0 for other types.
+    std::size_t size() const;
+    // Member with the given name, null if there is none.
+    const JsonValue& operator[](std::string_view name) const;
+    // Element at the given position, null if out of range.
+    const JsonValue& operator[](std::size_t position) const;
+
+  private:
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> _value;
+};
+
+// Parse a complete JSON document. Returns std::nullopt on syntax errors.
+std::optional<JsonValue> parseJson(std::string_view text);
@@ -0,0 +1,78 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include <logging/logs.h>
+#include <logging/logger.h>
+#include <logging/severity.h>
+#include <logging/sinks.h>
+
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "commands.h"
+
+void printUsage()
+{
+    std::cout << "Usage: AssetTool <command> [arguments]\n"
+                 "\n"
+                 "Commands:\n"
+                 "  compress-texture <input image> <output .ltex> [rgba8|bc1|bc3|bc7]\n"
+                 "      Encode an image and its full mip chain into a texture container.\n"
+                 "      Without a format, opaque images use BC1 and the rest BC3.\n"
+                 "  convert-mesh <input .obj/.gltf/.glb> <output .lmesh> [--no-optimize]\n"
+                 "               [--quantize[=half]] [--lods]\n"
+                 "      Import a triangle mesh and write it as a mesh container. Unless\n"
+                 "      disabled, triangles are reordered for the vertex cache and overdraw\n"
+                 "      and vertices for fetch locality. Small meshes get 16-bit indices.\n"
+                 "      Quantizing stores normalized 16-bit or half float positions,\n"
+                 "      16-bit texture coordinates and octahedral normals.\n"
+                 "      --lods adds levels of detail simplified by quadric error metrics.\n"
+                 "  bench-import [triangle count]\n"
+                 "      Measure OBJ and glTF import throughput on a generated grid mesh,\n"
+                 "      single threaded and on all threads.\n"
+                 "  bench-mips [image size]\n"
+                 "      Time the SSE2 mip chain against a scalar box filter on a generated\n"
+                 "      image and check that both give the same texels.\n";
+}
+
+int main(int argc, char* argv[])
+{
+    auto& logger = logging::Logger::Instance();
+    logging::ConsoleSink consoleSink{};
+#ifdef _DEBUG
+    logger.addSink(logging::Severity::Debug, &consoleSink);
+#else
+    logger.addSink(logging::Severity::Info, &consoleSink);
+#endif
+
+    if (argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::string_view command = argv[1];
+    std::vector<std::string_view> arguments(argv + 2, argv + argc);
+    if (command == "compress-texture")
+    {
+        return compressTexture(arguments);
+    }
+    if (command == "convert-mesh")
+    {
+        return convertMesh(arguments);
+    }
+    if (command == "bench-import")
+    {
+        return benchImport(arguments);
+    }
+    if (command == "bench-mips")
+    {
+        return benchMips(arguments);
+    }
+
+    logging::error(std::format("Unknown command: {}", command));
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <assets/mesh_container.h>
+
+#include "parallel.h"
+
+// Triangle mesh read from an interchange format, with one index per vertex
+// shared by all attributes.
+struct ImportedMesh
+{
+    // Three floats per vertex.
+    std::vector<float> positions;
+    // Two floats per vertex with the origin at the bottom left, empty if the source has none.
+    std::vector<float> texCoords;
+    // Three floats per vertex, empty if the source has none.
+    std::vector<float> normals;
+    std::vector<std::uint32_t> indices;
+    std::vector<assets::Submesh> submeshes;
+
+    std::size_t vertexCount() const
+    {
+        return positions.size() / 3;
+    }
+};
+
+// Wavefront OBJ. The file is memory mapped and parsed in chunks of whole lines
+// on all threads. Polygons are triangulated as fans, corners with the same
+// position, texture coordinate and normal indices are welded into one vertex,
+// and faces are grouped into one submesh per material.
+bool importObj(
+    const std::string& path, ImportedMesh& mesh, std::size_t threadCount = defaultThreadCount()
+);
+// glTF 2.0, either .gltf with external or embedded buffers or binary .glb.
+// Every triangle primitive of every mesh becomes a submesh, node transforms are
+// ignored. Primitives are read in parallel and vertices with identical
+// attributes are welded.
+bool importGltf(
+    const std::string& path, ImportedMesh& mesh, std::size_t threadCount = defaultThreadCount()
+);
+// Pick the importer from the file extension.
+bool importMesh(
+    const std::string& path, ImportedMesh& mesh, std::size_t threadCount = defaultThreadCount()
+);
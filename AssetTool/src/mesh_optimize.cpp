@@ -0,0 +1,417 @@
+#include "mesh_optimize.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+
+constexpr std::uint32_t NoVertex = std::numeric_limits<std::uint32_t>::max();
+
+// A cluster may end early once its miss ratio drops to this factor of the
+// Tipsify ratio, trading a little cache efficiency for finer overdraw sorting.
+constexpr double ClusterThreshold = 1.05;
+
+// Triangles using each vertex, as offsets into one shared list.
+struct Adjacency
+{
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> triangles;
+};
+
+Adjacency buildAdjacency(std::span<const std::uint32_t> indices, std::size_t vertexCount)
+{
+    Adjacency adjacency{std::vector<std::uint32_t>(vertexCount + 1, 0)};
+    for (std::uint32_t index : indices)
+    {
+        adjacency.offsets[index + 1]++;
+    }
+    std::partial_sum(
+        adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin()
+    );
+    adjacency.triangles.resize(indices.size());
+    std::vector<std::uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (std::size_t i = 0; i < indices.size(); i++)
+    {
+        adjacency.triangles[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+    }
+    return adjacency;
+}
+
+// Tipsify from Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex
+// Locality and Reduced Overdraw". Fans around a vertex, picking the next one
+// among the just emitted vertices that will still be in the cache. Returns the
+// triangle order and the positions where the fan had to jump, which start
+// clusters that no longer share cached vertices with the previous ones.
+void tipsify(
+    std::span<const std::uint32_t> indices,
+    std::size_t vertexCount,
+    std::size_t cacheSize,
+    std::vector<std::uint32_t>& order,
+    std::vector<std::uint32_t>& clusterStarts
+)
+{
+    std::size_t triangleCount = indices.size() / 3;
+    Adjacency adjacency = buildAdjacency(indices, vertexCount);
+    std::vector<std::uint32_t> liveTriangles(vertexCount);
+    for (std::size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        liveTriangles[vertex] = adjacency.offsets[vertex + 1] - adjacency.offsets[vertex];
+    }
+    std::vector<std::size_t> cacheTime(vertexCount, 0);
+    std::vector<char> emitted(triangleCount, false);
+    std::vector<std::uint32_t> deadEnds;
+    std::vector<std::uint32_t> candidates;
+
+    order.clear();
+    order.reserve(triangleCount);
+    clusterStarts.assign(1, 0);
+    std::size_t time = cacheSize + 1;
+    std::size_t scan = 0;
+    std::uint32_t fanning = vertexCount > 0 ? 0 : NoVertex;
+    while (fanning != NoVertex)
+    {
+        candidates.clear();
+        for (std::uint32_t k = adjacency.offsets[fanning]; k < adjacency.offsets[fanning + 1]; k++)
+        {
+            std::uint32_t triangle = adjacency.triangles[k];
+            if (emitted[triangle])
+            {
+                continue;
+            }
+            emitted[triangle] = true;
+            order.push_back(triangle);
+            for (std::size_t corner = 0; corner < 3; corner++)
+            {
+                std::uint32_t vertex = indices[triangle * 3 + corner];
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (time - cacheTime[vertex] > cacheSize)
+                {
+                    cacheTime[vertex] = time++;
+                }
+            }
+        }
+
+        // Prefer the candidate that entered the cache earliest and will not be
+        // evicted before its remaining triangles are fanned.
+        std::uint32_t next = NoVertex;
+        std::size_t bestPriority = 0;
+        for (std::uint32_t vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+            {
+                continue;
+            }
+            std::size_t priority = 0;
+            if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+            {
+                priority = time - cacheTime[vertex];
+            }
+            if (next == NoVertex || priority > bestPriority)
+            {
+                next = vertex;
+                bestPriority = priority;
+            }
+        }
+
+        if (next == NoVertex)
+        {
+            // Dead end: back up to a recently used vertex, or scan for any live one.
+            while (!deadEnds.empty() && next == NoVertex)
+            {
+                std::uint32_t vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangles[vertex] > 0)
+                {
+                    next = vertex;
+                }
+            }
+            while (next == NoVertex && scan < vertexCount)
+            {
+                if (liveTriangles[scan] > 0)
+                {
+                    next = static_cast<std::uint32_t>(scan);
+                }
+                scan++;
+            }
+            if (next != NoVertex && order.size() < triangleCount)
+            {
+                clusterStarts.push_back(static_cast<std::uint32_t>(order.size()));
+            }
+        }
+        fanning = next;
+    }
+}
+
+// Split the Tipsify clusters further wherever the cache misses of the part so
+// far are close to those of the whole cluster.
+std::vector<std::uint32_t> splitClusters(
+    std::span<const std::uint32_t> indices,
+    std::span<const std::uint32_t> order,
+    std::span<const std::uint32_t> clusterStarts,
+    std::size_t vertexCount,
+    std::size_t cacheSize
+)
+{
+    std::vector<std::size_t> cacheTime(vertexCount, 0);
+    std::size_t time = cacheSize + 1;
+    auto countMisses = [&](std::uint32_t triangle) {
+        std::size_t misses = 0;
+        for (std::size_t corner = 0; corner < 3; corner++)
+        {
+            std::uint32_t vertex = indices[triangle * 3 + corner];
+            if (time - cacheTime[vertex] > cacheSize)
+            {
+                cacheTime[vertex] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    };
+    auto flushCache = [&] {
+        time += cacheSize + 1;
+    };
+
+    std::vector<std::uint32_t> starts;
+    for (std::size_t cluster = 0; cluster < clusterStarts.size(); cluster++)
+    {
+        std::size_t begin = clusterStarts[cluster];
+        std::size_t end = cluster + 1 < clusterStarts.size() ? clusterStarts[cluster + 1]
+                                                             : order.size();
+        flushCache();
+        std::size_t clusterMisses = 0;
+        for (std::size_t i = begin; i < end; i++)
+        {
+            clusterMisses += countMisses(order[i]);
+        }
+        double threshold = ClusterThreshold * clusterMisses / (end - begin);
+
+        flushCache();
+        starts.push_back(static_cast<std::uint32_t>(begin));
+        std::size_t partMisses = 0;
+        std::size_t partTriangles = 0;
+        for (std::size_t i = begin; i < end; i++)
+        {
+            partMisses += countMisses(order[i]);
+            partTriangles++;
+            if (i + 1 < end && partMisses <= threshold * partTriangles)
+            {
+                starts.push_back(static_cast<std::uint32_t>(i + 1));
+                flushCache();
+                partMisses = 0;
+                partTriangles = 0;
+            }
+        }
+    }
+    return starts;
+}
+
+// Order clusters by how far they face away from the mesh centre, in the spirit
+// of the same paper: outward facing clusters tend to occlude the others.
+void sortClusters(
+    std::span<std::uint32_t> indices,
+    std::span<const std::uint32_t> order,
+    std::span<const std::uint32_t> clusterStarts,
+    std::span<const std::uint32_t> globalVertices,
+    std::span<const float> positions
+)
+{
+    using Vector = std::array<double, 3>;
+    auto position = [&](std::uint32_t triangle, std::size_t corner) {
+        const float* p = &positions[globalVertices[indices[triangle * 3 + corner]] * 3];
+        return Vector{p[0], p[1], p[2]};
+    };
+
+    struct Cluster
+    {
+        std::size_t begin;
+        std::size_t end;
+        Vector centroid;
+        Vector normal;
+        double area;
+        double sortKey;
+    };
+    std::vector<Cluster> clusters(clusterStarts.size());
+    Vector meshCentroid{};
+    double meshArea = 0.0;
+    for (std::size_t i = 0; i < clusters.size(); i++)
+    {
+        Cluster& cluster = clusters[i];
+        cluster.begin = clusterStarts[i];
+        cluster.end = i + 1 < clusterStarts.size() ? clusterStarts[i + 1] : order.size();
+        for (std::size_t k = cluster.begin; k < cluster.end; k++)
+        {
+            Vector a = position(order[k], 0);
+            Vector b = position(order[k], 1);
+            Vector c = position(order[k], 2);
+            Vector ab{b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            Vector ac{c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            // The cross product's length is twice the triangle area, which
+            // weights the sums by area.
+            Vector normal{
+                ab[1] * ac[2] - ab[2] * ac[1],
+                ab[2] * ac[0] - ab[0] * ac[2],
+                ab[0] * ac[1] - ab[1] * ac[0],
+            };
+            double area = std::sqrt(
+                normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]
+            );
+            for (int axis = 0; axis < 3; axis++)
+            {
+                cluster.centroid[axis] += (a[axis] + b[axis] + c[axis]) / 3.0 * area;
+                cluster.normal[axis] += normal[axis];
+            }
+            cluster.area += area;
+        }
+        for (int axis = 0; axis < 3; axis++)
+        {
+            meshCentroid[axis] += cluster.centroid[axis];
+            cluster.centroid[axis] /= std::max(cluster.area, 1e-30);
+        }
+        meshArea += cluster.area;
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+        meshCentroid[axis] /= std::max(meshArea, 1e-30);
+    }
+
+    for (Cluster& cluster : clusters)
+    {
+        double length = std::sqrt(
+            cluster.normal[0] * cluster.normal[0] + cluster.normal[1] * cluster.normal[1] +
+            cluster.normal[2] * cluster.normal[2]
+        );
+        cluster.sortKey = 0.0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            cluster.sortKey += (cluster.centroid[axis] - meshCentroid[axis]) *
+                               cluster.normal[axis] / std::max(length, 1e-30);
+        }
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    std::vector<std::uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (const Cluster& cluster : clusters)
+    {
+        for (std::size_t k = cluster.begin; k < cluster.end; k++)
+        {
+            sorted.insert(
+                sorted.end(), &indices[order[k] * 3], &indices[order[k] * 3] + 3
+            );
+        }
+    }
+    std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+}
+
+VertexCacheStatistics analyzeVertexCache(
+    std::span<const std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize
+)
+{
+    std::vector<std::size_t> cacheTime(vertexCount, 0);
+    std::vector<char> referenced(vertexCount, false);
+    std::size_t time = cacheSize + 1;
+    std::size_t misses = 0;
+    std::size_t referencedCount = 0;
+    for (std::uint32_t vertex : indices)
+    {
+        if (time - cacheTime[vertex] > cacheSize)
+        {
+            cacheTime[vertex] = time++;
+            misses++;
+        }
+        if (!referenced[vertex])
+        {
+            referenced[vertex] = true;
+            referencedCount++;
+        }
+    }
+    std::size_t triangleCount = indices.size() / 3;
+    return VertexCacheStatistics{
+        triangleCount > 0 ? static_cast<double>(misses) / triangleCount : 0.0,
+        referencedCount > 0 ? static_cast<double>(misses) / referencedCount : 0.0,
+    };
+}
+
+void optimizeMesh(ImportedMesh& mesh, std::size_t cacheSize)
+{
+    // Each submesh is optimized on its own, with its vertices numbered locally
+    // so the working arrays only cover what the submesh uses.
+    std::vector<std::uint32_t> localVertex(mesh.vertexCount(), NoVertex);
+    std::vector<std::uint32_t> globalVertices;
+    std::vector<std::uint32_t> indices;
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> clusterStarts;
+    for (const assets::Submesh& submesh : mesh.submeshes)
+    {
+        std::span<std::uint32_t> submeshIndices(
+            mesh.indices.data() + submesh.firstIndex, submesh.indexCount
+        );
+        globalVertices.clear();
+        indices.resize(submeshIndices.size());
+        for (std::size_t i = 0; i < submeshIndices.size(); i++)
+        {
+            std::uint32_t& local = localVertex[submeshIndices[i]];
+            if (local == NoVertex)
+            {
+                local = static_cast<std::uint32_t>(globalVertices.size());
+                globalVertices.push_back(submeshIndices[i]);
+            }
+            indices[i] = local;
+        }
+
+        tipsify(indices, globalVertices.size(), cacheSize, order, clusterStarts);
+        clusterStarts =
+            splitClusters(indices, order, clusterStarts, globalVertices.size(), cacheSize);
+        sortClusters(indices, order, clusterStarts, globalVertices, mesh.positions);
+
+        for (std::size_t i = 0; i < indices.size(); i++)
+        {
+            submeshIndices[i] = globalVertices[indices[i]];
+        }
+        for (std::uint32_t vertex : globalVertices)
+        {
+            localVertex[vertex] = NoVertex;
+        }
+    }
+
+    // Number vertices in order of first use and move their attributes along.
+    std::vector<std::uint32_t>& remap = localVertex;
+    std::uint32_t vertexCount = 0;
+    for (std::uint32_t& index : mesh.indices)
+    {
+        if (remap[index] == NoVertex)
+        {
+            remap[index] = vertexCount++;
+        }
+        index = remap[index];
+    }
+    auto reorder = [&](std::vector<float>& values, std::size_t width) {
+        if (values.empty())
+        {
+            return;
+        }
+        std::vector<float> reordered(vertexCount * width);
+        for (std::size_t vertex = 0; vertex < remap.size(); vertex++)
+        {
+            if (remap[vertex] != NoVertex)
+            {
+                std::copy_n(&values[vertex * width], width, &reordered[remap[vertex] * width]);
+            }
+        }
+        values = std::move(reordered);
+    };
+    reorder(mesh.positions, 3);
+    reorder(mesh.texCoords, 2);
+    reorder(mesh.normals, 3);
+}
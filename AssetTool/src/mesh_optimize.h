@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "mesh_import.h"
+
+// Entries of the simulated post-transform vertex cache, a common size across GPUs.
+constexpr std::size_t VertexCacheSize = 16;
+
+// Post-transform vertex cache behaviour of an index buffer, simulated as a FIFO cache.
+struct VertexCacheStatistics
+{
+    // Average cache misses per triangle, from 3 down to about 0.5 for a regular grid.
+    double acmr;
+    // Average transforms per referenced vertex, 1 when every vertex is transformed once.
+    double atvr;
+};
+
+VertexCacheStatistics analyzeVertexCache(
+    std::span<const std::uint32_t> indices,
+    std::size_t vertexCount,
+    std::size_t cacheSize = VertexCacheSize
+);
+
+// Reorder the triangles of every submesh for the vertex cache with Tipsify, then
+// order the resulting clusters so that outward facing ones draw first, which
+// cuts overdraw from any view. Finally vertices are renumbered in order of first
+// use so vertex fetch streams through memory, dropping unreferenced ones.
+void optimizeMesh(ImportedMesh& mesh, std::size_t cacheSize = VertexCacheSize);
@@ -0,0 +1,632 @@
+#include "mesh_simplify.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+#include "vertex_weld.h"
+
+namespace
+{
+
+constexpr std::uint32_t NoVertex = std::numeric_limits<std::uint32_t>::max();
+
+// Each level of detail aims for this fraction of the triangles of the one before.
+constexpr double LodReduction = 0.5;
+// Levels that keep more than this fraction of the triangles before them are not worth it.
+constexpr double MinLodReduction = 0.8;
+// Weight of the planes holding open borders in place, relative to the surface planes.
+constexpr double BorderWeight = 10.0;
+// Cost of attribute differences across a collapse, per squared unit of
+// difference, against squared distances in extents of the mesh.
+constexpr double TexCoordWeight = 0.1;
+constexpr double NormalWeight = 0.1;
+// A collapse may turn a triangle by at most about 75 degrees.
+constexpr double MinNormalCosine = 0.25;
+
+using Vector = std::array<double, 3>;
+
+Vector operator-(const Vector& a, const Vector& b)
+{
+    return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+double dot(const Vector& a, const Vector& b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Vector cross(const Vector& a, const Vector& b)
+{
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+// Sum of weighted squared distances to a set of planes, as x^T A x + 2 b^T x + c.
+struct Quadric
+{
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double weight;
+
+    // Plane through point with the given unit normal.
+    static Quadric plane(const Vector& normal, const Vector& point, double weight)
+    {
+        double d = -dot(normal, point);
+        return Quadric{
+            weight * normal[0] * normal[0],
+            weight * normal[0] * normal[1],
+            weight * normal[0] * normal[2],
+            weight * normal[1] * normal[1],
+            weight * normal[1] * normal[2],
+            weight * normal[2] * normal[2],
+            weight * d * normal[0],
+            weight * d * normal[1],
+            weight * d * normal[2],
+            weight * d * d,
+            weight,
+        };
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    // Mean squared distance of the point to the planes.
+    double error(const Vector& p) const
+    {
+        double value = a00 * p[0] * p[0] + a11 * p[1] * p[1] + a22 * p[2] * p[2] +
+                       2.0 * (a01 * p[0] * p[1] + a02 * p[0] * p[2] + a12 * p[1] * p[2]) +
+                       2.0 * (b0 * p[0] + b1 * p[1] + b2 * p[2]) + c;
+        return weight > 0.0 ? std::max(value, 0.0) / weight : 0.0;
+    }
+};
+
+// Collapse of the source vertex onto the target, valid while neither
+// position's stamp has changed since it was queued.
+struct Collapse
+{
+    double cost;
+    double error;
+    std::uint32_t source;
+    std::uint32_t target;
+    std::uint32_t sourceStamp;
+    std::uint32_t targetStamp;
+
+    bool operator>(const Collapse& other) const
+    {
+        return cost > other.cost;
+    }
+};
+
+// Edge collapse simplification of one index buffer. Vertices are numbered
+// locally, and vertices at the same position share a position id through
+// which topology is tracked, so texture seams do not look like open borders.
+class Simplifier
+{
+  public:
+    Simplifier(const ImportedMesh& mesh, std::span<const std::uint32_t> indices)
+        : _mesh(mesh),
+          _liveTriangleCount{}
+    {
+        std::vector<std::uint32_t> localVertex(mesh.vertexCount(), NoVertex);
+        _triangles.resize(indices.size());
+        for (std::size_t i = 0; i < indices.size(); i++)
+        {
+            std::uint32_t& local = localVertex[indices[i]];
+            if (local == NoVertex)
+            {
+                local = static_cast<std::uint32_t>(_vertices.size());
+                _vertices.push_back(indices[i]);
+            }
+            _triangles[i] = local;
+        }
+
+        // Work in the unit cube around the mesh so costs do not depend on its size.
+        Vector boundsMin{};
+        Vector boundsMax{};
+        boundsMin.fill(std::numeric_limits<double>::max());
+        boundsMax.fill(std::numeric_limits<double>::lowest());
+        for (std::uint32_t vertex : _vertices)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                boundsMin[axis] = std::min<double>(boundsMin[axis], position(vertex)[axis]);
+                boundsMax[axis] = std::max<double>(boundsMax[axis], position(vertex)[axis]);
+            }
+        }
+        double extent = 0.0;
+        for (int axis = 0; _vertices.size() > 0 && axis < 3; axis++)
+        {
+            extent = std::max(extent, boundsMax[axis] - boundsMin[axis]);
+        }
+        _scale = extent > 0.0 ? 1.0 / extent : 1.0;
+        _positions.resize(_vertices.size());
+        for (std::size_t vertex = 0; vertex < _vertices.size(); vertex++)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                _positions[vertex][axis] =
+                    (position(_vertices[vertex])[axis] - boundsMin[axis]) * _scale;
+            }
+        }
+
+        WeldResult positions = weldElements(
+            _vertices.size(),
+            [&](std::size_t vertex) {
+                std::uint64_t hash = 0;
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    std::uint32_t bits;
+                    std::memcpy(&bits, &position(_vertices[vertex])[axis], sizeof(bits));
+                    hash = mixHash(hash, bits);
+                }
+                return hash;
+            },
+            [&](std::size_t a, std::size_t b) {
+                return std::memcmp(
+                           position(_vertices[a]), position(_vertices[b]), 3 * sizeof(float)
+                       ) == 0;
+            },
+            defaultThreadCount()
+        );
+        _positionId = std::move(positions.remap);
+        std::size_t positionCount = positions.representatives.size();
+        std::vector<std::uint32_t> verticesAtPosition(positionCount, 0);
+        for (std::uint32_t id : _positionId)
+        {
+            verticesAtPosition[id]++;
+        }
+        _seam.resize(_vertices.size());
+        for (std::size_t vertex = 0; vertex < _vertices.size(); vertex++)
+        {
+            _seam[vertex] = verticesAtPosition[_positionId[vertex]] > 1;
+        }
+
+        std::size_t triangleCount = indices.size() / 3;
+        _alive.assign(triangleCount, false);
+        _positionTriangles.resize(positionCount);
+        _quadrics.assign(positionCount, Quadric{});
+        _stamps.assign(positionCount, 0);
+        _removed.assign(_vertices.size(), false);
+        _border.assign(positionCount, false);
+        std::unordered_map<std::uint64_t, std::uint32_t> edgeUses;
+        for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            std::array<std::uint32_t, 3> ids = positionIds(triangle);
+            if (ids[0] == ids[1] || ids[1] == ids[2] || ids[0] == ids[2])
+            {
+                continue;
+            }
+            _alive[triangle] = true;
+            _liveTriangleCount++;
+            for (std::size_t corner = 0; corner < 3; corner++)
+            {
+                _positionTriangles[ids[corner]].push_back(static_cast<std::uint32_t>(triangle));
+                edgeUses[edgeKey(ids[corner], ids[(corner + 1) % 3])]++;
+            }
+
+            // Plane of the triangle, weighted by its area.
+            Vector normal = triangleNormal(triangle);
+            double length = std::sqrt(dot(normal, normal));
+            if (length > 0.0)
+            {
+                Vector unit{normal[0] / length, normal[1] / length, normal[2] / length};
+                Quadric plane = Quadric::plane(unit, corner(triangle, 0), length / 2.0);
+                for (std::uint32_t id : ids)
+                {
+                    _quadrics[id] += plane;
+                }
+            }
+        }
+
+        // Open borders get planes through them, perpendicular to their triangle.
+        for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            if (!_alive[triangle])
+            {
+                continue;
+            }
+            std::array<std::uint32_t, 3> ids = positionIds(triangle);
+            Vector normal = triangleNormal(triangle);
+            for (std::size_t k = 0; k < 3; k++)
+            {
+                std::uint32_t a = ids[k];
+                std::uint32_t b = ids[(k + 1) % 3];
+                if (edgeUses[edgeKey(a, b)] != 1)
+                {
+                    continue;
+                }
+                _border[a] = true;
+                _border[b] = true;
+                Vector edge = corner(triangle, (k + 1) % 3) - corner(triangle, k);
+                Vector borderNormal = cross(edge, normal);
+                double length = std::sqrt(dot(borderNormal, borderNormal));
+                if (length > 0.0)
+                {
+                    Vector unit{
+                        borderNormal[0] / length,
+                        borderNormal[1] / length,
+                        borderNormal[2] / length,
+                    };
+                    Quadric plane = Quadric::plane(
+                        unit, corner(triangle, k), BorderWeight * dot(edge, edge)
+                    );
+                    _quadrics[a] += plane;
+                    _quadrics[b] += plane;
+                }
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> run(std::size_t targetTriangleCount, float& error)
+    {
+        for (std::uint32_t id = 0; id < _positionTriangles.size(); id++)
+        {
+            queueCollapses(id);
+        }
+
+        double maxError = 0.0;
+        while (_liveTriangleCount > targetTriangleCount && !_queue.empty())
+        {
+            Collapse collapse = _queue.top();
+            _queue.pop();
+            std::uint32_t sourceId = _positionId[collapse.source];
+            std::uint32_t targetId = _positionId[collapse.target];
+            if (_removed[collapse.source] || _removed[collapse.target] ||
+                _stamps[sourceId] != collapse.sourceStamp ||
+                _stamps[targetId] != collapse.targetStamp ||
+                !allowed(collapse.source, collapse.target) ||
+                !keepsManifold(sourceId, targetId) || flipsTriangle(collapse))
+            {
+                continue;
+            }
+            apply(collapse);
+            maxError = std::max(maxError, collapse.error);
+        }
+
+        // Quadric errors are mean squared plane distances in normalized units.
+        error = static_cast<float>(std::sqrt(maxError) / _scale);
+        std::vector<std::uint32_t> result;
+        for (std::size_t triangle = 0; triangle < _alive.size(); triangle++)
+        {
+            if (_alive[triangle])
+            {
+                for (std::size_t k = 0; k < 3; k++)
+                {
+                    result.push_back(_vertices[_triangles[triangle * 3 + k]]);
+                }
+            }
+        }
+        return result;
+    }
+
+  private:
+    const ImportedMesh& _mesh;
+    // Global vertex of each local vertex.
+    std::vector<std::uint32_t> _vertices;
+    std::vector<Vector> _positions;
+    double _scale;
+    std::vector<std::uint32_t> _positionId;
+    // Vertex shares its position with others, across a texture or normal seam.
+    std::vector<char> _seam;
+    // Local vertices of each triangle.
+    std::vector<std::uint32_t> _triangles;
+    std::vector<char> _alive;
+    std::size_t _liveTriangleCount;
+    std::vector<char> _removed;
+    // Per position id.
+    std::vector<std::vector<std::uint32_t>> _positionTriangles;
+    std::vector<Quadric> _quadrics;
+    std::vector<std::uint32_t> _stamps;
+    std::vector<char> _border;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> _queue;
+
+    const float* position(std::uint32_t globalVertex) const
+    {
+        return &_mesh.positions[globalVertex * 3];
+    }
+
+    static std::uint64_t edgeKey(std::uint32_t a, std::uint32_t b)
+    {
+        return (std::uint64_t{std::min(a, b)} << 32) | std::max(a, b);
+    }
+
+    std::array<std::uint32_t, 3> positionIds(std::size_t triangle) const
+    {
+        return {
+            _positionId[_triangles[triangle * 3]],
+            _positionId[_triangles[triangle * 3 + 1]],
+            _positionId[_triangles[triangle * 3 + 2]],
+        };
+    }
+
+    const Vector& corner(std::size_t triangle, std::size_t k) const
+    {
+        return _positions[_triangles[triangle * 3 + k]];
+    }
+
+    // Cross product of two edges, twice the area in length.
+    Vector triangleNormal(std::size_t triangle) const
+    {
+        return cross(
+            corner(triangle, 1) - corner(triangle, 0), corner(triangle, 2) - corner(triangle, 0)
+        );
+    }
+
+    // Seam vertices stay where they are, border vertices only move along the border.
+    bool allowed(std::uint32_t source, std::uint32_t target) const
+    {
+        std::uint32_t sourceId = _positionId[source];
+        std::uint32_t targetId = _positionId[target];
+        if (_seam[source])
+        {
+            return false;
+        }
+        if (!_border[sourceId])
+        {
+            return true;
+        }
+        return _border[targetId] && sharedTriangles(sourceId, targetId) == 1;
+    }
+
+    std::size_t sharedTriangles(std::uint32_t a, std::uint32_t b) const
+    {
+        std::size_t count = 0;
+        for (std::uint32_t triangle : _positionTriangles[a])
+        {
+            if (_alive[triangle])
+            {
+                std::array<std::uint32_t, 3> ids = positionIds(triangle);
+                count += std::find(ids.begin(), ids.end(), b) != ids.end();
+            }
+        }
+        return count;
+    }
+
+    std::vector<std::uint32_t> neighbours(std::uint32_t id) const
+    {
+        std::vector<std::uint32_t> result;
+        for (std::uint32_t triangle : _positionTriangles[id])
+        {
+            if (_alive[triangle])
+            {
+                for (std::uint32_t other : positionIds(triangle))
+                {
+                    if (other != id)
+                    {
+                        result.push_back(other);
+                    }
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    // Link condition: the two positions only share the neighbours opposite
+    // their common edge, otherwise the collapse would pinch the surface.
+    bool keepsManifold(std::uint32_t sourceId, std::uint32_t targetId) const
+    {
+        std::vector<std::uint32_t> sourceNeighbours = neighbours(sourceId);
+        std::vector<std::uint32_t> targetNeighbours = neighbours(targetId);
+        std::vector<std::uint32_t> common;
+        std::set_intersection(
+            sourceNeighbours.begin(),
+            sourceNeighbours.end(),
+            targetNeighbours.begin(),
+            targetNeighbours.end(),
+            std::back_inserter(common)
+        );
+        return common.size() == sharedTriangles(sourceId, targetId);
+    }
+
+    bool flipsTriangle(const Collapse& collapse) const
+    {
+        std::uint32_t targetId = _positionId[collapse.target];
+        for (std::uint32_t triangle : _positionTriangles[_positionId[collapse.source]])
+        {
+            std::array<std::uint32_t, 3> ids = positionIds(triangle);
+            if (!_alive[triangle] || std::find(ids.begin(), ids.end(), targetId) != ids.end())
+            {
+                continue;
+            }
+            std::array<Vector, 3> moved{
+                corner(triangle, 0), corner(triangle, 1), corner(triangle, 2)
+            };
+            for (std::size_t k = 0; k < 3; k++)
+            {
+                if (_triangles[triangle * 3 + k] == collapse.source)
+                {
+                    moved[k] = _positions[collapse.target];
+                }
+            }
+            Vector before = triangleNormal(triangle);
+            Vector after = cross(moved[1] - moved[0], moved[2] - moved[0]);
+            double lengths = std::sqrt(dot(before, before) * dot(after, after));
+            if (dot(before, after) < MinNormalCosine * lengths || lengths == 0.0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void queueCollapse(std::uint32_t source, std::uint32_t target)
+    {
+        if (!allowed(source, target))
+        {
+            return;
+        }
+        std::uint32_t sourceId = _positionId[source];
+        std::uint32_t targetId = _positionId[target];
+        Quadric quadric = _quadrics[sourceId];
+        quadric += _quadrics[targetId];
+        double error = quadric.error(_positions[target]);
+
+        double attributeCost = 0.0;
+        std::uint32_t a = _vertices[source];
+        std::uint32_t b = _vertices[target];
+        for (std::size_t k = 0; k < 2 && !_mesh.texCoords.empty(); k++)
+        {
+            double difference = _mesh.texCoords[a * 2 + k] - _mesh.texCoords[b * 2 + k];
+            attributeCost += TexCoordWeight * difference * difference;
+        }
+        for (std::size_t k = 0; k < 3 && !_mesh.normals.empty(); k++)
+        {
+            double difference = _mesh.normals[a * 3 + k] - _mesh.normals[b * 3 + k];
+            attributeCost += NormalWeight * difference * difference;
+        }
+        _queue.push(Collapse{
+            error + attributeCost, error, source, target, _stamps[sourceId], _stamps[targetId]
+        });
+    }
+
+    // Queue the collapses of every edge around a position, in both directions.
+    void queueCollapses(std::uint32_t id)
+    {
+        for (std::uint32_t triangle : _positionTriangles[id])
+        {
+            if (!_alive[triangle])
+            {
+                continue;
+            }
+            for (std::size_t k = 0; k < 3; k++)
+            {
+                std::uint32_t vertex = _triangles[triangle * 3 + k];
+                if (_positionId[vertex] != id)
+                {
+                    continue;
+                }
+                for (std::size_t other = 1; other < 3; other++)
+                {
+                    std::uint32_t neighbour = _triangles[triangle * 3 + (k + other) % 3];
+                    queueCollapse(vertex, neighbour);
+                    queueCollapse(neighbour, vertex);
+                }
+            }
+        }
+    }
+
+    void apply(const Collapse& collapse)
+    {
+        std::uint32_t sourceId = _positionId[collapse.source];
+        std::uint32_t targetId = _positionId[collapse.target];
+        for (std::uint32_t triangle : _positionTriangles[sourceId])
+        {
+            if (!_alive[triangle])
+            {
+                continue;
+            }
+            std::array<std::uint32_t, 3> ids = positionIds(triangle);
+            if (std::find(ids.begin(), ids.end(), targetId) != ids.end())
+            {
+                _alive[triangle] = false;
+                _liveTriangleCount--;
+                continue;
+            }
+            for (std::size_t k = 0; k < 3; k++)
+            {
+                if (_triangles[triangle * 3 + k] == collapse.source)
+                {
+                    _triangles[triangle * 3 + k] = collapse.target;
+                }
+            }
+            _positionTriangles[targetId].push_back(triangle);
+        }
+        _positionTriangles[sourceId].clear();
+        std::erase_if(_positionTriangles[targetId], [&](std::uint32_t triangle) {
+            return !_alive[triangle];
+        });
+        _quadrics[targetId] += _quadrics[sourceId];
+        _removed[collapse.source] = true;
+        _stamps[targetId]++;
+        queueCollapses(targetId);
+    }
+};
+
+}
+
+std::vector<std::uint32_t> simplifyTriangles(
+    const ImportedMesh& mesh,
+    std::span<const std::uint32_t> indices,
+    std::size_t targetTriangleCount,
+    float& error
+)
+{
+    Simplifier simplifier(mesh, indices);
+    return simplifier.run(targetTriangleCount, error);
+}
+
+std::vector<assets::MeshLod> generateLods(ImportedMesh& mesh)
+{
+    std::vector<assets::MeshLod> lods{
+        assets::MeshLod{0, static_cast<std::uint32_t>(mesh.submeshes.size()), 0.0f, 0}
+    };
+    std::size_t previousTriangleCount = mesh.indices.size() / 3;
+    while (lods.size() < MaxLodCount)
+    {
+        // Simplify the previous level further, its error carries over.
+        const assets::MeshLod& previous = lods.back();
+        std::vector<assets::Submesh> sources(
+            mesh.submeshes.begin() + previous.firstSubmesh,
+            mesh.submeshes.begin() + previous.firstSubmesh + previous.submeshCount
+        );
+        assets::MeshLod lod{
+            static_cast<std::uint32_t>(mesh.submeshes.size()), 0, previous.error, 0
+        };
+        std::vector<assets::Submesh> submeshes;
+        std::vector<std::uint32_t> indices;
+        for (const assets::Submesh& source : sources)
+        {
+            std::span<const std::uint32_t> sourceIndices(
+                mesh.indices.data() + source.firstIndex, source.indexCount
+            );
+            auto target = static_cast<std::size_t>(source.indexCount / 3 * LodReduction);
+            float error = 0.0f;
+            std::vector<std::uint32_t> simplified =
+                simplifyTriangles(mesh, sourceIndices, target, error);
+            lod.error = std::max(lod.error, previous.error + error);
+            if (simplified.empty())
+            {
+                continue;
+            }
+            submeshes.push_back(assets::Submesh{
+                static_cast<std::uint32_t>(mesh.indices.size() + indices.size()),
+                static_cast<std::uint32_t>(simplified.size()),
+                source.materialIndex,
+                0,
+            });
+            indices.insert(indices.end(), simplified.begin(), simplified.end());
+        }
+
+        std::size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || triangleCount > previousTriangleCount * MinLodReduction)
+        {
+            break;
+        }
+        lod.submeshCount = static_cast<std::uint32_t>(submeshes.size());
+        mesh.submeshes.insert(mesh.submeshes.end(), submeshes.begin(), submeshes.end());
+        mesh.indices.insert(mesh.indices.end(), indices.begin(), indices.end());
+        lods.push_back(lod);
+        previousTriangleCount = triangleCount;
+    }
+    return lods;
+}
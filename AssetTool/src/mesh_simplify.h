@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <assets/mesh_container.h>
+
+#include "mesh_import.h"
+
+// Most levels of detail generated per mesh, including the full detail one.
+constexpr std::size_t MaxLodCount = 8;
+
+// Simplify triangles of the mesh by collapsing edges in the order of their
+// quadric error (Garland and Heckbert), until at most targetTriangleCount are
+// left or no collapse is possible. Vertices only move onto other vertices, so
+// the result indexes the mesh's existing vertices. Texture seams and material
+// borders are kept in place, open borders only collapse along themselves, and
+// texture coordinate and normal differences add to the cost of a collapse.
+// error receives the root mean square distance, in mesh units, of the worst
+// merged vertex from the planes of the input triangles it replaced: the square
+// root of the largest quadric error of any collapse. It estimates how far the
+// result deviates from the input surface but does not bound it.
+std::vector<std::uint32_t> simplifyTriangles(
+    const ImportedMesh& mesh,
+    std::span<const std::uint32_t> indices,
+    std::size_t targetTriangleCount,
+    float& error
+);
+
+// Append levels of detail to the mesh, each with about half the triangles of
+// the one before, until simplification stalls or MaxLodCount is reached. Every
+// level gets its own copy of the submeshes. Returns all levels, the first one
+// being the mesh as it was.
+std::vector<assets::MeshLod> generateLods(ImportedMesh& mesh);
@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of threads used by the parallel import and processing steps.
+inline std::size_t defaultThreadCount()
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// Call function(index) for every index in [0, count) on up to threadCount threads.
+// Indices are handed out one at a time, so uneven work balances itself.
+// The calling thread takes part and the call returns once all indices are done.
+template <typename Function>
+void parallelFor(std::size_t count, std::size_t threadCount, Function function)
+{
+    threadCount = std::clamp<std::size_t>(threadCount, 1, std::max<std::size_t>(count, 1));
+    std::atomic<std::size_t> next{0};
+    auto work = [&] {
+        for (std::size_t index = next++; index < count; index = next++)
+        {
+            function(index);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (std::size_t i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// Split [0, count) into about threadCount ranges and call function(begin, end) for each.
+template <typename Function>
+void parallelRanges(std::size_t count, std::size_t threadCount, Function function)
+{
+    std::size_t rangeCount =
+        std::clamp<std::size_t>(threadCount, 1, std::max<std::size_t>(count, 1));
+    parallelFor(rangeCount, threadCount, [&](std::size_t range) {
+        function(count * range / rangeCount, count * (range + 1) / rangeCount);
+    });
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Conversions of vertex components to the compact types of the mesh container.
+
+// IEEE half float, rounding to nearest even. Values beyond the half range become infinity.
+inline std::uint16_t encodeHalf(float value)
+{
+    std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+    std::uint32_t magnitude = bits & 0x7FFFFFFF;
+    if (magnitude >= 0x7F800000)
+    {
+        // Infinity stays infinity, NaN stays a quiet NaN.
+        return sign | (magnitude > 0x7F800000 ? 0x7E00 : 0x7C00);
+    }
+    if (magnitude >= 0x477FF000)
+    {
+        return sign | 0x7C00;
+    }
+    if (magnitude < 0x38800000)
+    {
+        // Subnormal half: shift the mantissa with its implicit bit into place.
+        int shift = 126 - static_cast<int>(magnitude >> 23);
+        if (shift > 24)
+        {
+            return sign;
+        }
+        std::uint32_t mantissa = (magnitude & 0x007FFFFF) | 0x00800000;
+        std::uint32_t half = mantissa >> shift;
+        std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+        std::uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1)))
+        {
+            half++;
+        }
+        return sign | static_cast<std::uint16_t>(half);
+    }
+    // Rebias the exponent and round the mantissa, a carry correctly bumps the exponent.
+    std::uint32_t half = (magnitude - 0x38000000) >> 13;
+    std::uint32_t remainder = magnitude & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+    {
+        half++;
+    }
+    return sign | static_cast<std::uint16_t>(half);
+}
+
+// Signed normalized 16-bit integer of a value in [-1, 1].
+inline std::int16_t encodeSNorm16(float value)
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+// Unsigned normalized 16-bit integer of a value in [0, 1].
+inline std::uint16_t encodeUNorm16(float value)
+{
+    return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+// Map a unit vector onto the octahedron and unfold it into [-1, 1]^2. The
+// vertex shader reverses this with decodeOctahedral.
+inline std::array<float, 2> encodeOctahedral(const float* normal)
+{
+    float length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+    if (length == 0.0f)
+    {
+        return {0.0f, 0.0f};
+    }
+    float x = normal[0] / length;
+    float y = normal[1] / length;
+    if (normal[2] < 0.0f)
+    {
+        // Fold the lower hemisphere over the diagonals.
+        float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+    return {x, y};
+}
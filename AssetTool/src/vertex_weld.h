@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+
+// Combine a field into a hash of several fields.
+inline std::uint64_t mixHash(std::uint64_t hash, std::uint64_t value)
+{
+    return (hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2))) *
+           0xBF58476D1CE4E5B9ull;
+}
+
+// Result of welding: every element mapped to the id of its group of equal
+// elements, and one representative element per id.
+struct WeldResult
+{
+    std::vector<std::uint32_t> remap;
+    std::vector<std::uint32_t> representatives;
+};
+
+// Group equal elements among [0, count), given a hash and an equality test of
+// element indices. The elements are partitioned into a fixed number of shards by
+// hash in one pass, and each shard is welded with its own open-addressing table
+// on whichever thread picks it up, so no locking is needed. Ids are ordered by
+// shard, then by first occurrence, so the result depends on neither thread
+// timing nor the thread count.
+template <typename Hash, typename Equal>
+WeldResult weldElements(std::size_t count, Hash hash, Equal equal, std::size_t threadCount)
+{
+    constexpr std::uint32_t Empty = std::numeric_limits<std::uint32_t>::max();
+    // Enough shards to balance any common core count, few enough that each
+    // stays large.
+    constexpr std::size_t ShardCount = 64;
+
+    std::vector<std::uint64_t> hashes(count);
+    parallelRanges(count, threadCount, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            // Spread the caller's hash over all bits, shards and slots use different ones.
+            std::uint64_t value = hash(i);
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            hashes[i] = value ^ (value >> 31);
+        }
+    });
+
+    // The upper bits pick the shard, the lower bits the table slot.
+    auto shardOf = [&](std::uint64_t elementHash) {
+        return static_cast<std::size_t>((elementHash >> 32) % ShardCount);
+    };
+
+    // Counting sort of the elements by shard, keeping their order within each
+    // shard. Every range counts its own elements, then writes them after those
+    // of the earlier ranges.
+    std::size_t rangeCount =
+        std::clamp<std::size_t>(threadCount, 1, std::max<std::size_t>(count, 1));
+    std::vector<std::size_t> rangeOffsets(rangeCount * ShardCount);
+    auto rangeBounds = [&](std::size_t range) {
+        return std::pair(count * range / rangeCount, count * (range + 1) / rangeCount);
+    };
+    parallelFor(rangeCount, threadCount, [&](std::size_t range) {
+        auto [begin, end] = rangeBounds(range);
+        for (std::size_t i = begin; i < end; i++)
+        {
+            rangeOffsets[range * ShardCount + shardOf(hashes[i])]++;
+        }
+    });
+    std::vector<std::size_t> shardBegin(ShardCount + 1);
+    std::size_t offset = 0;
+    for (std::size_t shard = 0; shard < ShardCount; shard++)
+    {
+        shardBegin[shard] = offset;
+        for (std::size_t range = 0; range < rangeCount; range++)
+        {
+            offset += std::exchange(rangeOffsets[range * ShardCount + shard], offset);
+        }
+    }
+    shardBegin[ShardCount] = offset;
+    std::vector<std::uint32_t> order(count);
+    parallelFor(rangeCount, threadCount, [&](std::size_t range) {
+        auto [begin, end] = rangeBounds(range);
+        for (std::size_t i = begin; i < end; i++)
+        {
+            order[rangeOffsets[range * ShardCount + shardOf(hashes[i])]++] =
+                static_cast<std::uint32_t>(i);
+        }
+    });
+
+    WeldResult result{std::vector<std::uint32_t>(count)};
+    std::vector<std::vector<std::uint32_t>> shardRepresentatives(ShardCount);
+    parallelFor(ShardCount, threadCount, [&](std::size_t shard) {
+        std::vector<std::uint32_t>& representatives = shardRepresentatives[shard];
+        // At most half full even if every element is distinct.
+        std::size_t elementCount = shardBegin[shard + 1] - shardBegin[shard];
+        std::size_t tableSize = 16;
+        while (tableSize < elementCount * 2)
+        {
+            tableSize *= 2;
+        }
+        std::vector<std::uint32_t> table(tableSize, Empty);
+        std::size_t mask = table.size() - 1;
+        for (std::size_t position = shardBegin[shard]; position < shardBegin[shard + 1];
+             position++)
+        {
+            std::uint32_t i = order[position];
+            std::size_t slot = hashes[i] & mask;
+            while (table[slot] != Empty)
+            {
+                std::uint32_t id = table[slot];
+                std::uint32_t representative = representatives[id];
+                if (hashes[representative] == hashes[i] && equal(representative, i))
+                {
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+            if (table[slot] == Empty)
+            {
+                table[slot] = static_cast<std::uint32_t>(representatives.size());
+                representatives.push_back(i);
+            }
+            result.remap[i] = table[slot];
+        }
+    });
+
+    std::vector<std::uint32_t> shardBase(ShardCount);
+    for (std::size_t shard = 0; shard < ShardCount; shard++)
+    {
+        shardBase[shard] = static_cast<std::uint32_t>(result.representatives.size());
+        result.representatives.insert(
+            result.representatives.end(),
+            shardRepresentatives[shard].begin(),
+            shardRepresentatives[shard].end()
+        );
+    }
+    parallelRanges(count, threadCount, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            result.remap[i] += shardBase[shardOf(hashes[i])];
+        }
+    });
+    return result;
+}
@@ -0,0 +1,119 @@
+#include "bc_decoder.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace assets
+{
+
+namespace
+{
+
+std::array<int, 3> unpackRgb565(std::uint16_t packed)
+{
+    int red = (packed >> 11) & 0x1F;
+    int green = (packed >> 5) & 0x3F;
+    int blue = packed & 0x1F;
+    return {(red << 3) | (red >> 2), (green << 2) | (green >> 4), (blue << 3) | (blue >> 2)};
+}
+
+// The color half shared by BC1 and BC3. Alpha is only written for BC1, whose
+// three-color palette makes its last entry transparent black.
+void decodeColorBlock(const std::uint8_t* block, std::uint8_t* texels, bool writeAlpha)
+{
+    auto color0 = static_cast<std::uint16_t>(block[0] | (block[1] << 8));
+    auto color1 = static_cast<std::uint16_t>(block[2] | (block[3] << 8));
+    std::array<std::array<int, 3>, 4> palette{unpackRgb565(color0), unpackRgb565(color1)};
+    bool opaque = color0 > color1;
+    for (int channel = 0; channel < 3; channel++)
+    {
+        int start = palette[0][channel];
+        int end = palette[1][channel];
+        palette[2][channel] = opaque ? (2 * start + end) / 3 : (start + end) / 2;
+        palette[3][channel] = opaque ? (start + 2 * end) / 3 : 0;
+    }
+    for (int texel = 0; texel < 16; texel++)
+    {
+        int index = (block[4 + texel / 4] >> ((texel % 4) * 2)) & 3;
+        for (int channel = 0; channel < 3; channel++)
+        {
+            texels[texel * 4 + channel] = static_cast<std::uint8_t>(palette[index][channel]);
+        }
+        if (writeAlpha)
+        {
+            texels[texel * 4 + 3] = !opaque && index == 3 ? 0 : 255;
+        }
+    }
+}
+
+}
+
+void decodeBC1Block(const std::uint8_t* block, std::uint8_t* texels)
+{
+    decodeColorBlock(block, texels, true);
+}
+
+void decodeBC3Block(const std::uint8_t* block, std::uint8_t* texels)
+{
+    decodeColorBlock(block + 8, texels, false);
+    int alpha0 = block[0];
+    int alpha1 = block[1];
+    // Eight interpolated levels, or six with fully transparent and opaque added.
+    std::array<int, 8> palette{alpha0, alpha1};
+    for (int index = 2; index < 8; index++)
+    {
+        palette[index] = alpha0 > alpha1 ? ((8 - index) * alpha0 + (index - 1) * alpha1) / 7
+                         : index < 6     ? ((6 - index) * alpha0 + (index - 1) * alpha1) / 5
+                         : index == 6    ? 0
+                                         : 255;
+    }
+    std::uint64_t indices = 0;
+    for (int byte = 0; byte < 6; byte++)
+    {
+        indices |= std::uint64_t{block[2 + byte]} << (byte * 8);
+    }
+    for (int texel = 0; texel < 16; texel++)
+    {
+        texels[texel * 4 + 3] = static_cast<std::uint8_t>(palette[(indices >> (texel * 3)) & 7]);
+    }
+}
+
+void decodeImage(
+    std::span<const std::uint8_t> blocks,
+    TextureFormat format,
+    std::uint32_t width,
+    std::uint32_t height,
+    std::span<std::uint8_t> texels
+)
+{
+    std::uint32_t blockSize = formatUnitSize(format);
+    std::uint32_t blocksX = (width + 3) / 4;
+    std::uint32_t blocksY = (height + 3) / 4;
+    std::array<std::uint8_t, 64> decoded;
+    const std::uint8_t* block = blocks.data();
+    for (std::uint32_t blockY = 0; blockY < blocksY; blockY++)
+    {
+        for (std::uint32_t blockX = 0; blockX < blocksX; blockX++, block += blockSize)
+        {
+            if (format == TextureFormat::BC1)
+            {
+                decodeBC1Block(block, decoded.data());
+            }
+            else
+            {
+                decodeBC3Block(block, decoded.data());
+            }
+            std::uint32_t columns = std::min<std::uint32_t>(width - blockX * 4, 4);
+            std::uint32_t rows = std::min<std::uint32_t>(height - blockY * 4, 4);
+            for (std::uint32_t row = 0; row < rows; row++)
+            {
+                std::size_t y = std::size_t{blockY} * 4 + row;
+                std::memcpy(
+                    &texels[(y * width + blockX * 4) * 4], &decoded[row * 16], columns * 4
+                );
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+#include "texture_container.h"
+
+namespace assets
+{
+
+// Decoders for the S3TC formats, which OpenGL only supports through an
+// extension. Without it, BC1 and BC3 textures are decoded to RGBA8 on load.
+//
+// Blocks decode to 4x4 RGBA8 texels (64 bytes, row-major). BC1 reads 8 bytes
+// and decodes both its opaque and its transparent palette; BC3 reads 16.
+void decodeBC1Block(const std::uint8_t* block, std::uint8_t* texels);
+void decodeBC3Block(const std::uint8_t* block, std::uint8_t* texels);
+
+// Decode a BC1 or BC3 level of width x height texels into tightly packed RGBA8,
+// dropping the texels edge blocks are padded with. The destination holds
+// width * height * 4 bytes.
+void decodeImage(
+    std::span<const std::uint8_t> blocks,
+    TextureFormat format,
+    std::uint32_t width,
+    std::uint32_t height,
+    std::span<std::uint8_t> texels
+);
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace assets
+{
+
+constexpr std::uint64_t HashOffsetBasis = 0xcbf29ce484222325;
+
+// 64-bit FNV-1a hash of the bytes. Pass a previous result as the seed to hash
+// several ranges as one.
+inline std::uint64_t hashBytes(
+    std::span<const std::byte> bytes, std::uint64_t seed = HashOffsetBasis
+)
+{
+    constexpr std::uint64_t Prime = 0x100000001b3;
+    std::uint64_t hash = seed;
+    for (std::byte byte : bytes)
+    {
+        hash = (hash ^ static_cast<std::uint64_t>(byte)) * Prime;
+    }
+    return hash;
+}
+
+}
@@ -0,0 +1,78 @@
+#include "image.h"
+#include <algorithm>
+#include <utility>
+
+#include <emmintrin.h>
+
+namespace assets
+{
+
+Image downsample(const Image& image)
+{
+    Image result{
+        std::max<std::uint32_t>(image.width / 2, 1), std::max<std::uint32_t>(image.height / 2, 1)
+    };
+    result.pixels.resize(std::size_t{result.width} * result.height * 4);
+
+    for (std::uint32_t y = 0; y < result.height; y++)
+    {
+        std::size_t y0 = std::min(y * 2, image.height - 1);
+        std::size_t y1 = std::min(y * 2 + 1, image.height - 1);
+        const std::uint8_t* row0 = &image.pixels[y0 * image.width * 4];
+        const std::uint8_t* row1 = &image.pixels[y1 * image.width * 4];
+        std::uint8_t* out = &result.pixels[std::size_t{y} * result.width * 4];
+
+        // Two output texels at a time from four source texels of both rows.
+        // Channels are widened to 16 bits, so the sums cannot overflow.
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rounding = _mm_set1_epi16(2);
+        std::uint32_t x = 0;
+        for (; x + 1 < result.width && x * 2 + 3 < image.width; x += 2)
+        {
+            __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+            __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+            __m128i low = _mm_add_epi16(
+                _mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero)
+            );
+            __m128i high = _mm_add_epi16(
+                _mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero)
+            );
+            // Add each texel to its horizontal neighbour in the upper half of the register.
+            low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+            high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+            __m128i sum = _mm_unpacklo_epi64(low, high);
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+            _mm_storel_epi64(
+                reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, zero)
+            );
+        }
+
+        for (; x < result.width; x++)
+        {
+            std::uint32_t x0 = std::min(x * 2, image.width - 1);
+            std::uint32_t x1 = std::min(x * 2 + 1, image.width - 1);
+            for (int channel = 0; channel < 4; channel++)
+            {
+                out[x * 4 + channel] = static_cast<std::uint8_t>(
+                    (row0[x0 * 4 + channel] + row0[x1 * 4 + channel] + row1[x0 * 4 + channel] +
+                     row1[x1 * 4 + channel] + 2) /
+                    4
+                );
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<Image> generateMipChain(Image base)
+{
+    std::vector<Image> levels;
+    levels.push_back(std::move(base));
+    while (levels.back().width > 1 || levels.back().height > 1)
+    {
+        levels.push_back(downsample(levels.back()));
+    }
+    return levels;
+}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace assets
+{
+
+// Tightly packed RGBA8 image, rows stored bottom to top as OpenGL expects.
+struct Image
+{
+    std::uint32_t width;
+    std::uint32_t height;
+    std::vector<std::uint8_t> pixels;
+};
+
+// Halve both dimensions with a 2x2 box filter. Odd edges are clamped.
+Image downsample(const Image& image);
+
+// The image followed by every level of its mip chain down to 1x1.
+std::vector<Image> generateMipChain(Image base);
+
+}
@@ -0,0 +1,123 @@
+#include "mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace assets
+{
+
+MappedFile::MappedFile() : _data{}, _size{}
+{
+}
+
+MappedFile::MappedFile(const std::string& path) : _data{}, _size{}
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        // The view keeps the file mapping alive, so both handles can be closed.
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view != nullptr)
+            {
+                _data = static_cast<const std::byte*>(view);
+                _size = static_cast<std::size_t>(size.QuadPart);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file == -1)
+    {
+        return;
+    }
+    struct stat status{};
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        auto size = static_cast<std::size_t>(status.st_size);
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view != MAP_FAILED)
+        {
+            _data = static_cast<const std::byte*>(view);
+            _size = size;
+        }
+    }
+    ::close(file);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::isOpen() const
+{
+    return _data != nullptr;
+}
+
+std::span<const std::byte> MappedFile::bytes() const
+{
+    return {_data, _size};
+}
+
+void MappedFile::close()
+{
+    if (_data == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+#else
+    munmap(const_cast<std::byte*>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace assets
+{
+
+// Read-only memory mapping of a whole file. The mapping is released with the object.
+class MappedFile
+{
+  public:
+    MappedFile();
+    // Map the file, check isOpen() for failure. Empty files cannot be mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool isOpen() const;
+    std::span<const std::byte> bytes() const;
+
+  private:
+    const std::byte* _data;
+    std::size_t _size;
+
+    void close();
+};
+
+}
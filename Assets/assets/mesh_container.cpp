@@ -0,0 +1,202 @@
+#include "mesh_container.h"
+#include <algorithm>
+#include <bit>
+#include <fstream>
+
+namespace assets
+{
+
+namespace
+{
+
+std::uint64_t alignOffset(std::uint64_t offset)
+{
+    return (offset + MeshDataAlignment - 1) & ~std::uint64_t{MeshDataAlignment - 1};
+}
+
+float decodeHalf(std::uint16_t half)
+{
+    std::uint32_t sign = std::uint32_t{half & 0x8000u} << 16;
+    std::uint32_t exponent = (half >> 10) & 0x1F;
+    std::uint32_t mantissa = half & 0x3FF;
+    if (exponent == 0)
+    {
+        // Zero or subnormal, both exact as scaled floats.
+        float value = static_cast<float>(mantissa) / (1 << 24);
+        return sign ? -value : value;
+    }
+    if (exponent == 0x1F)
+    {
+        return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+float decodeComponent(VertexComponentType type, const std::byte* data)
+{
+    switch (type)
+    {
+    case VertexComponentType::Float16:
+    {
+        std::uint16_t half;
+        std::memcpy(&half, data, sizeof(half));
+        return decodeHalf(half);
+    }
+    case VertexComponentType::SNorm16:
+    {
+        std::int16_t snorm;
+        std::memcpy(&snorm, data, sizeof(snorm));
+        return std::max(snorm / 32767.0f, -1.0f);
+    }
+    case VertexComponentType::UNorm16:
+    {
+        std::uint16_t unorm;
+        std::memcpy(&unorm, data, sizeof(unorm));
+        return unorm / 65535.0f;
+    }
+    default:
+    {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    }
+}
+
+void writePadding(std::ofstream& output, std::uint64_t offset)
+{
+    auto position = static_cast<std::uint64_t>(output.tellp());
+    std::vector<char> padding(offset - position);
+    output.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+}
+
+}
+
+bool writeMeshContainer(const std::string& path, const MeshData& mesh)
+{
+    MeshHeader header{
+        MeshIdentifier,
+        MeshVersion,
+        static_cast<std::uint32_t>(mesh.attributes.size()),
+        static_cast<std::uint32_t>(mesh.submeshes.size()),
+        mesh.vertexStride,
+        static_cast<std::uint32_t>(mesh.vertices.size() / mesh.vertexStride),
+        mesh.indexFormat,
+        static_cast<std::uint32_t>(mesh.indices.size() / indexSize(mesh.indexFormat)),
+        static_cast<std::uint32_t>(mesh.lods.size()),
+    };
+    std::uint64_t tablesEnd = sizeof(MeshHeader) +
+                              mesh.attributes.size() * sizeof(VertexAttribute) +
+                              mesh.submeshes.size() * sizeof(Submesh) +
+                              mesh.lods.size() * sizeof(MeshLod);
+    header.vertexOffset = alignOffset(tablesEnd);
+    header.vertexSize = mesh.vertices.size();
+    header.indexOffset = alignOffset(header.vertexOffset + header.vertexSize);
+    header.indexSize = mesh.indices.size();
+    header.boundsMin = mesh.boundsMin;
+    header.boundsMax = mesh.boundsMax;
+    header.positionScale = mesh.positionScale;
+    header.positionBias = mesh.positionBias;
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(
+        reinterpret_cast<const char*>(mesh.attributes.data()),
+        static_cast<std::streamsize>(mesh.attributes.size() * sizeof(VertexAttribute))
+    );
+    output.write(
+        reinterpret_cast<const char*>(mesh.submeshes.data()),
+        static_cast<std::streamsize>(mesh.submeshes.size() * sizeof(Submesh))
+    );
+    output.write(
+        reinterpret_cast<const char*>(mesh.lods.data()),
+        static_cast<std::streamsize>(mesh.lods.size() * sizeof(MeshLod))
+    );
+    writePadding(output, header.vertexOffset);
+    output.write(
+        reinterpret_cast<const char*>(mesh.vertices.data()),
+        static_cast<std::streamsize>(mesh.vertices.size())
+    );
+    writePadding(output, header.indexOffset);
+    output.write(
+        reinterpret_cast<const char*>(mesh.indices.data()),
+        static_cast<std::streamsize>(mesh.indices.size())
+    );
+    return static_cast<bool>(output);
+}
+
+void readPositions(const MeshHeader& header, const MeshView& mesh, std::vector<float>& positions)
+{
+    positions.assign(std::size_t{header.vertexCount} * 3, 0.0f);
+    auto attribute = std::find_if(
+        mesh.attributes.begin(), mesh.attributes.end(), [](const VertexAttribute& attribute) {
+            return attribute.semantic == VertexSemantic::Position;
+        }
+    );
+    if (attribute == mesh.attributes.end())
+    {
+        return;
+    }
+    std::size_t size = componentSize(attribute->componentType);
+    std::uint32_t componentCount = std::min(attribute->componentCount, 3u);
+    for (std::size_t vertex = 0; vertex < header.vertexCount; vertex++)
+    {
+        const std::byte* data = &mesh.vertices[vertex * header.vertexStride + attribute->offset];
+        for (std::uint32_t axis = 0; axis < componentCount; axis++)
+        {
+            positions[vertex * 3 + axis] =
+                decodeComponent(attribute->componentType, data + axis * size) *
+                    header.positionScale[axis] +
+                header.positionBias[axis];
+        }
+    }
+}
+
+bool readLodIndices(
+    const MeshHeader& header,
+    const MeshView& mesh,
+    std::size_t lod,
+    std::vector<std::uint32_t>& indices
+)
+{
+    indices.clear();
+    if (lod >= mesh.lods.size())
+    {
+        return false;
+    }
+    const MeshLod& level = mesh.lods[lod];
+    for (std::uint32_t i = 0; i < level.submeshCount; i++)
+    {
+        const Submesh& submesh = mesh.submeshes[level.firstSubmesh + i];
+        for (std::uint32_t k = 0; k < submesh.indexCount; k++)
+        {
+            std::size_t index = submesh.firstIndex + k;
+            if (header.indexFormat == IndexFormat::UInt16)
+            {
+                std::uint16_t value;
+                std::memcpy(&value, &mesh.indices[index * sizeof(value)], sizeof(value));
+                indices.push_back(value);
+            }
+            else
+            {
+                std::uint32_t value;
+                std::memcpy(&value, &mesh.indices[index * sizeof(value)], sizeof(value));
+                indices.push_back(value);
+            }
+        }
+    }
+    if (std::any_of(indices.begin(), indices.end(), [&](std::uint32_t index) {
+            return index >= header.vertexCount;
+        }))
+    {
+        indices.clear();
+        return false;
+    }
+    return true;
+}
+
+}
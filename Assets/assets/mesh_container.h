@@ -0,0 +1,257 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace assets
+{
+
+// Mesh container layout, all values little-endian:
+//
+// +------------+---------------------------------+-----------------------+
+// | MeshHeader | VertexAttribute[attributeCount] | Submesh[submeshCount] |
+// +------------+-------------------+-------------+-----------------------+
+// | MeshLod[lodCount]              | Vertex data, 16 byte aligned          |
+// +--------------------------------+---------------------------------------+
+// | Index data, 16 byte aligned                                            |
+// +------------------------------------------------------------------------+
+//
+// Vertices are interleaved with the stride given in the header. The vertex and
+// index data can be handed to OpenGL straight from a memory mapping of the file.
+//
+// Quantized meshes store 16-bit components. Normalized integer components are
+// read as [-1, 1] or [0, 1] by the vertex fetch, positions are then scaled and
+// offset by the header's dequantization. A normal with two components is
+// octahedral encoded.
+//
+// Levels of detail share the vertex data. Each has its own submeshes, stored
+// one level after the other from the full detail mesh on.
+
+// What an attribute holds. The value is the shader input location it is bound to.
+enum class VertexSemantic : std::uint32_t
+{
+    Position = 0,
+    TexCoord = 1,
+    Normal = 2,
+};
+
+enum class VertexComponentType : std::uint32_t
+{
+    Float32 = 0,
+    Float16 = 1,
+    // Normalized integers, read as floats in [-1, 1] and [0, 1].
+    SNorm16 = 2,
+    UNorm16 = 3,
+};
+
+enum class IndexFormat : std::uint32_t
+{
+    UInt16 = 0,
+    UInt32 = 1,
+};
+
+constexpr std::array<std::uint8_t, 8> MeshIdentifier = {
+    0xAB, 'L', 'M', 'S', 'H', 0xBB, '\r', '\n',
+};
+constexpr std::uint32_t MeshVersion = 3;
+constexpr std::size_t MeshDataAlignment = 16;
+
+struct MeshHeader
+{
+    std::array<std::uint8_t, 8> identifier;
+    std::uint32_t version;
+    std::uint32_t attributeCount;
+    std::uint32_t submeshCount;
+    std::uint32_t vertexStride;
+    std::uint32_t vertexCount;
+    IndexFormat indexFormat;
+    std::uint32_t indexCount;
+    std::uint32_t lodCount;
+    // Offsets from the start of the file and sizes of the data blocks in bytes.
+    std::uint64_t vertexOffset;
+    std::uint64_t vertexSize;
+    std::uint64_t indexOffset;
+    std::uint64_t indexSize;
+    // Bounding box of all positions.
+    std::array<float, 3> boundsMin;
+    std::array<float, 3> boundsMax;
+    // Positions are stored value * positionScale + positionBias.
+    std::array<float, 3> positionScale;
+    std::array<float, 3> positionBias;
+};
+
+struct VertexAttribute
+{
+    VertexSemantic semantic;
+    VertexComponentType componentType;
+    std::uint32_t componentCount;
+    // Offset of the attribute within a vertex in bytes.
+    std::uint32_t offset;
+};
+
+// Range of indices drawn with one material.
+struct Submesh
+{
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+    std::uint32_t materialIndex;
+    std::uint32_t reserved;
+};
+
+// Level of detail, drawn as its range of submeshes.
+struct MeshLod
+{
+    std::uint32_t firstSubmesh;
+    std::uint32_t submeshCount;
+    // Estimated deviation from the full detail surface in mesh units: the root
+    // mean square plane distance reported by each simplification step, summed
+    // over the levels leading here. Not a bound on the distance between surfaces.
+    float error;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(MeshHeader) == 120);
+static_assert(sizeof(VertexAttribute) == 16);
+static_assert(sizeof(Submesh) == 16);
+static_assert(sizeof(MeshLod) == 16);
+
+constexpr std::uint32_t componentSize(VertexComponentType type)
+{
+    switch (type)
+    {
+    case VertexComponentType::Float16:
+    case VertexComponentType::SNorm16:
+    case VertexComponentType::UNorm16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+constexpr std::uint32_t indexSize(IndexFormat format)
+{
+    return format == IndexFormat::UInt16 ? 2 : 4;
+}
+
+// Parts of a mesh container, viewing the memory it was read from.
+struct MeshView
+{
+    std::span<const VertexAttribute> attributes;
+    std::span<const Submesh> submeshes;
+    std::span<const MeshLod> lods;
+    std::span<const std::byte> vertices;
+    std::span<const std::byte> indices;
+};
+
+// Check a container held in memory and find its parts.
+// Returns false if the container is invalid.
+inline bool readMeshContainer(
+    std::span<const std::byte> file, MeshHeader& header, MeshView& mesh
+)
+{
+    if (file.size() < sizeof(MeshHeader))
+    {
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(MeshHeader));
+    if (header.identifier != MeshIdentifier || header.version != MeshVersion ||
+        header.attributeCount == 0 || header.vertexStride == 0 || header.lodCount == 0 ||
+        header.indexFormat > IndexFormat::UInt32)
+    {
+        return false;
+    }
+    std::size_t lodsOffset = sizeof(MeshHeader) + header.attributeCount * sizeof(VertexAttribute) +
+                             header.submeshCount * sizeof(Submesh);
+    std::size_t tablesEnd = lodsOffset + header.lodCount * sizeof(MeshLod);
+    // Sizes are compared with the bytes left after their offset, as adding the
+    // two could wrap around.
+    if (file.size() < tablesEnd ||
+        header.vertexSize != std::uint64_t{header.vertexCount} * header.vertexStride ||
+        header.indexSize != std::uint64_t{header.indexCount} * indexSize(header.indexFormat) ||
+        header.vertexOffset < tablesEnd || header.vertexOffset > file.size() ||
+        header.vertexSize > file.size() - header.vertexOffset || header.indexOffset < tablesEnd ||
+        header.indexOffset > file.size() || header.indexSize > file.size() - header.indexOffset)
+    {
+        return false;
+    }
+
+    mesh.attributes = std::span(
+        reinterpret_cast<const VertexAttribute*>(file.data() + sizeof(MeshHeader)),
+        header.attributeCount
+    );
+    mesh.submeshes = std::span(
+        reinterpret_cast<const Submesh*>(
+            file.data() + sizeof(MeshHeader) + header.attributeCount * sizeof(VertexAttribute)
+        ),
+        header.submeshCount
+    );
+    mesh.lods = std::span(
+        reinterpret_cast<const MeshLod*>(file.data() + lodsOffset), header.lodCount
+    );
+    for (const VertexAttribute& attribute : mesh.attributes)
+    {
+        if (attribute.componentType > VertexComponentType::UNorm16 ||
+            attribute.componentCount == 0 || attribute.componentCount > 4 ||
+            attribute.offset + attribute.componentCount * componentSize(attribute.componentType) >
+                header.vertexStride)
+        {
+            return false;
+        }
+    }
+    for (const Submesh& submesh : mesh.submeshes)
+    {
+        if (std::uint64_t{submesh.firstIndex} + submesh.indexCount > header.indexCount)
+        {
+            return false;
+        }
+    }
+    for (const MeshLod& lod : mesh.lods)
+    {
+        if (std::uint64_t{lod.firstSubmesh} + lod.submeshCount > header.submeshCount)
+        {
+            return false;
+        }
+    }
+    mesh.vertices = file.subspan(header.vertexOffset, header.vertexSize);
+    mesh.indices = file.subspan(header.indexOffset, header.indexSize);
+    return true;
+}
+
+// Mesh data to be written to a container.
+struct MeshData
+{
+    std::vector<VertexAttribute> attributes;
+    std::vector<Submesh> submeshes;
+    // At least one level, the first one drawing the full detail mesh.
+    std::vector<MeshLod> lods;
+    std::uint32_t vertexStride;
+    std::vector<std::uint8_t> vertices;
+    IndexFormat indexFormat;
+    std::vector<std::uint8_t> indices;
+    std::array<float, 3> boundsMin;
+    std::array<float, 3> boundsMax;
+    std::array<float, 3> positionScale;
+    std::array<float, 3> positionBias;
+};
+
+// Decode the positions of a read container into three floats per vertex, dequantized.
+void readPositions(const MeshHeader& header, const MeshView& mesh, std::vector<float>& positions);
+
+// Indices of every submesh of a level of detail, widened to 32 bits. Returns
+// false, leaving indices empty, if the level does not exist or an index lies
+// outside the vertices.
+bool readLodIndices(
+    const MeshHeader& header,
+    const MeshView& mesh,
+    std::size_t lod,
+    std::vector<std::uint32_t>& indices
+);
+
+// Write the mesh to a container. Returns false if the file could not be written.
+bool writeMeshContainer(const std::string& path, const MeshData& mesh);
+
+}
@@ -0,0 +1,130 @@
+#include "png.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <fstream>
+
+namespace assets
+{
+
+namespace
+{
+
+// Deflate stored blocks hold at most this many bytes.
+constexpr std::size_t StoredBlockSize = 65535;
+
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size, std::uint32_t crc = 0)
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> entries{};
+        for (std::uint32_t i = 0; i < 256; i++)
+        {
+            std::uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                value = value & 1 ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void appendBigEndian(std::vector<std::uint8_t>& output, std::uint32_t value)
+{
+    output.push_back(static_cast<std::uint8_t>(value >> 24));
+    output.push_back(static_cast<std::uint8_t>(value >> 16));
+    output.push_back(static_cast<std::uint8_t>(value >> 8));
+    output.push_back(static_cast<std::uint8_t>(value));
+}
+
+void appendChunk(
+    std::vector<std::uint8_t>& output, const char* type, const std::vector<std::uint8_t>& data
+)
+{
+    appendBigEndian(output, static_cast<std::uint32_t>(data.size()));
+    std::size_t typeOffset = output.size();
+    output.insert(output.end(), type, type + 4);
+    output.insert(output.end(), data.begin(), data.end());
+    appendBigEndian(output, crc32(&output[typeOffset], output.size() - typeOffset));
+}
+
+}
+
+std::vector<std::uint8_t> encodePng(const Image& image)
+{
+    // Every row starts with its filter type, 0 for none. PNG rows go top to bottom.
+    std::size_t rowSize = std::size_t{image.width} * 4;
+    std::vector<std::uint8_t> scanlines;
+    scanlines.reserve((rowSize + 1) * image.height);
+    for (std::uint32_t row = image.height; row-- > 0;)
+    {
+        scanlines.push_back(0);
+        auto begin = image.pixels.begin() + static_cast<std::ptrdiff_t>(row * rowSize);
+        scanlines.insert(scanlines.end(), begin, begin + static_cast<std::ptrdiff_t>(rowSize));
+    }
+
+    // Zlib stream of stored deflate blocks.
+    std::vector<std::uint8_t> compressed{0x78, 0x01};
+    compressed.reserve(scanlines.size() + (scanlines.size() / StoredBlockSize + 1) * 5 + 6);
+    std::size_t offset = 0;
+    do
+    {
+        std::size_t size = std::min(StoredBlockSize, scanlines.size() - offset);
+        bool last = offset + size == scanlines.size();
+        compressed.push_back(last ? 1 : 0);
+        compressed.push_back(static_cast<std::uint8_t>(size));
+        compressed.push_back(static_cast<std::uint8_t>(size >> 8));
+        compressed.push_back(static_cast<std::uint8_t>(~size));
+        compressed.push_back(static_cast<std::uint8_t>(~size >> 8));
+        compressed.insert(
+            compressed.end(),
+            scanlines.begin() + static_cast<std::ptrdiff_t>(offset),
+            scanlines.begin() + static_cast<std::ptrdiff_t>(offset + size)
+        );
+        offset += size;
+    } while (offset < scanlines.size());
+    std::uint32_t adlerLow = 1;
+    std::uint32_t adlerHigh = 0;
+    for (std::uint8_t byte : scanlines)
+    {
+        adlerLow = (adlerLow + byte) % 65521;
+        adlerHigh = (adlerHigh + adlerLow) % 65521;
+    }
+    appendBigEndian(compressed, (adlerHigh << 16) | adlerLow);
+
+    std::vector<std::uint8_t> header;
+    appendBigEndian(header, image.width);
+    appendBigEndian(header, image.height);
+    // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlacing.
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+
+    std::vector<std::uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    png.reserve(png.size() + compressed.size() + 64);
+    appendChunk(png, "IHDR", header);
+    appendChunk(png, "IDAT", compressed);
+    appendChunk(png, "IEND", {});
+    return png;
+}
+
+bool writePng(const std::string& path, const Image& image)
+{
+    std::vector<std::uint8_t> png = encodePng(image);
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        return false;
+    }
+    output.write(
+        reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size())
+    );
+    return static_cast<bool>(output);
+}
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "image.h"
+
+namespace assets
+{
+
+// Encode the image as a PNG file. The pixel data is stored without compression,
+// which keeps encoding cheap enough for captures at the cost of file size.
+std::vector<std::uint8_t> encodePng(const Image& image);
+
+// Encode the image and write it to path. Returns false if the file could not be written.
+bool writePng(const std::string& path, const Image& image);
+
+}
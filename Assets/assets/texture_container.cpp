@@ -0,0 +1,56 @@
+#include "texture_container.h"
+#include <fstream>
+
+namespace assets
+{
+
+bool writeTextureContainer(
+    const std::string& path,
+    TextureFormat format,
+    std::uint32_t width,
+    std::uint32_t height,
+    std::span<const std::vector<std::uint8_t>> levelData
+)
+{
+    TextureHeader header{
+        TextureIdentifier,
+        TextureVersion,
+        format,
+        width,
+        height,
+        static_cast<std::uint32_t>(levelData.size()),
+        0,
+    };
+    std::vector<TextureLevel> levels(levelData.size());
+    std::uint64_t offset = sizeof(header) + levels.size() * sizeof(TextureLevel);
+    for (std::size_t level = 0; level < levelData.size(); level++)
+    {
+        offset = (offset + TextureDataAlignment - 1) & ~(TextureDataAlignment - 1);
+        levels[level] = TextureLevel{offset, levelData[level].size()};
+        offset += levelData[level].size();
+    }
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(
+        reinterpret_cast<const char*>(levels.data()),
+        static_cast<std::streamsize>(levels.size() * sizeof(TextureLevel))
+    );
+    for (std::size_t level = 0; level < levels.size(); level++)
+    {
+        auto position = static_cast<std::uint64_t>(output.tellp());
+        std::vector<char> padding(levels[level].offset - position);
+        output.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        output.write(
+            reinterpret_cast<const char*>(levelData[level].data()),
+            static_cast<std::streamsize>(levelData[level].size())
+        );
+    }
+    return static_cast<bool>(output);
+}
+
+}
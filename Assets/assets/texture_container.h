@@ -0,0 +1,160 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace assets
+{
+
+// Texture container layout, all values little-endian:
+//
+// +----------------+---------------------------------+----------------------------+
+// | TextureHeader  | TextureLevel[header.levelCount] | Level data, 16 byte aligned |
+// +----------------+---------------------------------+----------------------------+
+//
+// Levels are stored from the base level down to 1x1 and hold either tightly
+// packed RGBA8 texels or 4x4 blocks in row-major block order.
+
+enum class TextureFormat : std::uint32_t
+{
+    RGBA8 = 0,
+    BC1 = 1,
+    BC3 = 2,
+    BC7 = 3,
+};
+
+constexpr std::array<std::uint8_t, 8> TextureIdentifier = {
+    0xAB, 'L', 'T', 'E', 'X', 0xBB, '\r', '\n',
+};
+constexpr std::uint32_t TextureVersion = 1;
+constexpr std::size_t TextureDataAlignment = 16;
+
+struct TextureHeader
+{
+    std::array<std::uint8_t, 8> identifier;
+    std::uint32_t version;
+    TextureFormat format;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t levelCount;
+    std::uint32_t reserved;
+};
+
+struct TextureLevel
+{
+    // Offset from the start of the file and size of the level's data in bytes.
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+static_assert(sizeof(TextureHeader) == 32);
+static_assert(sizeof(TextureLevel) == 16);
+
+constexpr bool isBlockCompressed(TextureFormat format)
+{
+    return format != TextureFormat::RGBA8;
+}
+
+// Bytes per 4x4 block for block-compressed formats, bytes per texel otherwise.
+constexpr std::uint32_t formatUnitSize(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+        return 8;
+    case TextureFormat::BC3:
+    case TextureFormat::BC7:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+constexpr std::uint32_t levelDimension(std::uint32_t baseDimension, std::uint32_t level)
+{
+    return std::max<std::uint32_t>(baseDimension >> level, 1);
+}
+
+constexpr std::uint64_t levelSize(TextureFormat format, std::uint32_t width, std::uint32_t height)
+{
+    if (isBlockCompressed(format))
+    {
+        return std::uint64_t{(width + 3) / 4} * ((height + 3) / 4) * formatUnitSize(format);
+    }
+    return std::uint64_t{width} * height * formatUnitSize(format);
+}
+
+// Number of levels in a full mip chain down to 1x1.
+constexpr std::uint32_t fullLevelCount(std::uint32_t width, std::uint32_t height)
+{
+    std::uint32_t levelCount = 1;
+    while ((width | height) > 1)
+    {
+        width = std::max<std::uint32_t>(width >> 1, 1);
+        height = std::max<std::uint32_t>(height >> 1, 1);
+        levelCount++;
+    }
+    return levelCount;
+}
+
+// Check the header and level table of a container held in memory.
+// Returns the level table on success and an empty span otherwise.
+inline std::span<const TextureLevel> readTextureLevels(
+    std::span<const std::byte> file, TextureHeader& header
+)
+{
+    if (file.size() < sizeof(TextureHeader))
+    {
+        return {};
+    }
+    std::memcpy(&header, file.data(), sizeof(TextureHeader));
+    if (header.identifier != TextureIdentifier || header.version != TextureVersion ||
+        header.levelCount == 0 || header.levelCount > fullLevelCount(header.width, header.height) ||
+        header.format > TextureFormat::BC7)
+    {
+        return {};
+    }
+    std::size_t tableEnd = sizeof(TextureHeader) + header.levelCount * sizeof(TextureLevel);
+    if (file.size() < tableEnd)
+    {
+        return {};
+    }
+    std::span<const TextureLevel> levels(
+        reinterpret_cast<const TextureLevel*>(file.data() + sizeof(TextureHeader)),
+        header.levelCount
+    );
+    for (std::uint32_t level = 0; level < header.levelCount; level++)
+    {
+        std::uint64_t expectedSize = levelSize(
+            header.format,
+            levelDimension(header.width, level),
+            levelDimension(header.height, level)
+        );
+        // Compared without adding offset and size, which could wrap around.
+        if (levels[level].size != expectedSize || levels[level].offset < tableEnd ||
+            levels[level].offset > file.size() ||
+            levels[level].size > file.size() - levels[level].offset)
+        {
+            return {};
+        }
+    }
+    return levels;
+}
+
+// Write a container holding the given levels, each already encoded in the format
+// and together forming a mip chain from width x height down. Returns false if
+// the file could not be written.
+bool writeTextureContainer(
+    const std::string& path,
+    TextureFormat format,
+    std::uint32_t width,
+    std::uint32_t height,
+    std::span<const std::vector<std::uint8_t>> levelData
+);
+
+}
@@ -0,0 +1,14 @@
+#version 430
+
+out vec4 FragColor;
+
+in vec2 texCoord;
+// Layer within the bound texture array pool.
+flat in uint textureIndex;
+
+uniform sampler2DArray textures;
+
+void main()
+{
+	FragColor = texture(textures, vec3(texCoord, float(textureIndex)));
+}
@@ -0,0 +1,18 @@
+#version 430
+#extension GL_ARB_bindless_texture : require
+
+out vec4 FragColor;
+
+in vec2 texCoord;
+// Slot of the resident texture handle.
+flat in uint textureIndex;
+
+layout (std430, binding = 1) readonly buffer TextureHandles
+{
+	uvec2 handles[];
+};
+
+void main()
+{
+	FragColor = texture(sampler2D(handles[textureIndex]), texCoord);
+}
@@ -0,0 +1,32 @@
+#version 430
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+
+// Laid out like PackedInstance on the CPU.
+struct Instance
+{
+	mat4 modelViewProjection;
+	// Inverse transpose of the model's upper 3x3.
+	mat3 normalMatrix;
+	uint textureIndex;
+};
+
+// Instances of all draws of the mesh, each draw starting at firstInstance.
+layout (std430, binding = 0) readonly buffer InstanceData
+{
+	Instance instances[];
+};
+
+out vec2 texCoord;
+flat out uint textureIndex;
+
+uniform int firstInstance;
+
+void main()
+{
+	Instance instance = instances[firstInstance + gl_InstanceID];
+	gl_Position = instance.modelViewProjection * vec4(aPos, 1.0);
+	texCoord = aTexCoord;
+	textureIndex = instance.textureIndex;
+}
@@ -0,0 +1,51 @@
+#version 430
+
+// Positions relative to the mesh bounds, normalized or half float.
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+// Octahedral encoded unit normal.
+layout (location = 2) in vec2 aNormal;
+
+// Laid out like PackedInstance on the CPU.
+struct Instance
+{
+	mat4 modelViewProjection;
+	// Inverse transpose of the model's upper 3x3.
+	mat3 normalMatrix;
+	uint textureIndex;
+};
+
+// Instances of all draws of the mesh, each draw starting at firstInstance.
+layout (std430, binding = 0) readonly buffer InstanceData
+{
+	Instance instances[];
+};
+
+out vec2 texCoord;
+out vec3 normal;
+flat out uint textureIndex;
+
+uniform int firstInstance;
+// Dequantization of the stored positions.
+uniform vec3 positionScale;
+uniform vec3 positionBias;
+
+// Unfold the octahedron back onto the unit sphere.
+vec3 decodeOctahedral(vec2 encoded)
+{
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -fold : fold;
+	n.y += n.y >= 0.0 ? -fold : fold;
+	return normalize(n);
+}
+
+void main()
+{
+	Instance instance = instances[firstInstance + gl_InstanceID];
+	vec3 position = aPos * positionScale + positionBias;
+	gl_Position = instance.modelViewProjection * vec4(position, 1.0);
+	texCoord = aTexCoord;
+	normal = instance.normalMatrix * decodeOctahedral(aNormal);
+	textureIndex = instance.textureIndex;
+}
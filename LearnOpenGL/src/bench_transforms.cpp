@@ -0,0 +1,189 @@
+#include "bench_transforms.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <logging/logs.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <random>
+#include <vector>
+
+#include "transform_batch.h"
+
+namespace
+{
+
+constexpr std::size_t DefaultObjectCounts[] = {10'000, 1'000'000};
+constexpr int RunCount = 5;
+// Largest difference from glm accepted for any component.
+constexpr float Tolerance = 1e-3f;
+
+// Best time of several runs in nanoseconds per object.
+template <typename Function>
+double measure(std::size_t objectCount, Function&& function)
+{
+    double best = 0.0;
+    for (int run = 0; run < RunCount; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        double elapsed =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+                .count();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best / static_cast<double>(objectCount);
+}
+
+float largestDifference(const float* a, const float* b, std::size_t count)
+{
+    float difference = 0.0f;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    }
+    return difference;
+}
+
+bool benchObjectCount(std::size_t objectCount)
+{
+    // Rotated, non-uniformly scaled objects scattered in front of the camera.
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<glm::mat4> models(objectCount);
+    for (glm::mat4& model : models)
+    {
+        glm::vec3 position = glm::vec3(unit(random), unit(random), -5.0f) * 20.0f;
+        model = glm::translate(glm::mat4(1.0f), position);
+        model = glm::rotate(
+            model,
+            unit(random) * 3.14159f,
+            glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + 2.0f)
+        );
+        model = glm::scale(
+            model, glm::vec3(unit(random), unit(random), unit(random)) * 0.4f + 1.0f
+        );
+    }
+    glm::mat4 viewProjection =
+        glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f) *
+        glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::vec3 boundsMin(-0.5f);
+    glm::vec3 boundsMax(0.5f);
+
+    // Reference: one glm expression per object, as the renderer used to.
+    std::vector<glm::mat4> referenceMatrices(objectCount);
+    std::vector<glm::mat3> referenceNormals(objectCount);
+    std::vector<glm::vec3> referenceMins(objectCount);
+    std::vector<glm::vec3> referenceMaxs(objectCount);
+    double glmInstances = measure(objectCount, [&] {
+        for (std::size_t i = 0; i < objectCount; i++)
+        {
+            referenceMatrices[i] = viewProjection * models[i];
+            referenceNormals[i] = glm::transpose(glm::inverse(glm::mat3(models[i])));
+        }
+    });
+    double glmBounds = measure(objectCount, [&] {
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+        for (std::size_t i = 0; i < objectCount; i++)
+        {
+            glm::vec3 worldCenter = glm::vec3(models[i] * glm::vec4(center, 1.0f));
+            glm::vec3 worldExtent = glm::abs(glm::vec3(models[i][0])) * extent.x +
+                                    glm::abs(glm::vec3(models[i][1])) * extent.y +
+                                    glm::abs(glm::vec3(models[i][2])) * extent.z;
+            referenceMins[i] = worldCenter - worldExtent;
+            referenceMaxs[i] = worldCenter + worldExtent;
+        }
+    });
+
+    std::vector<PackedInstance> instances(objectCount);
+    std::vector<glm::vec3> worldMins(objectCount);
+    std::vector<glm::vec3> worldMaxs(objectCount);
+    double batchInstances = measure(objectCount, [&] {
+        packInstances(viewProjection, models, 0, instances);
+    });
+    double batchBounds = measure(objectCount, [&] {
+        transformBounds(boundsMin, boundsMax, models, worldMins, worldMaxs);
+    });
+
+    float difference = 0.0f;
+    for (std::size_t i = 0; i < objectCount; i++)
+    {
+        difference = std::max(
+            difference,
+            largestDifference(
+                &instances[i].modelViewProjection[0][0], &referenceMatrices[i][0][0], 16
+            )
+        );
+        for (int column = 0; column < 3; column++)
+        {
+            difference = std::max(
+                difference,
+                largestDifference(
+                    &instances[i].normalMatrix[column][0], &referenceNormals[i][column][0], 3
+                )
+            );
+        }
+        difference = std::max(
+            {difference,
+             largestDifference(&worldMins[i][0], &referenceMins[i][0], 3),
+             largestDifference(&worldMaxs[i][0], &referenceMaxs[i][0], 3)}
+        );
+    }
+
+    logging::info(std::format("{} objects:", objectCount));
+    logging::info(std::format(
+        "  instances  glm {:.2f} ns, batch {:.2f} ns, speedup {:.2f}x",
+        glmInstances,
+        batchInstances,
+        glmInstances / batchInstances
+    ));
+    logging::info(std::format(
+        "  bounds     glm {:.2f} ns, batch {:.2f} ns, speedup {:.2f}x",
+        glmBounds,
+        batchBounds,
+        glmBounds / batchBounds
+    ));
+    if (difference > Tolerance)
+    {
+        logging::error(std::format("Batch results differ from glm by {}", difference));
+        return false;
+    }
+    return true;
+}
+
+}
+
+int benchTransforms(std::span<const std::string_view> arguments)
+{
+    std::vector<std::size_t> objectCounts;
+    for (std::string_view argument : arguments)
+    {
+        std::size_t count = 0;
+        const char* last = argument.data() + argument.size();
+        auto [end, error] = std::from_chars(argument.data(), last, count);
+        if (error != std::errc{} || end != last || count == 0)
+        {
+            logging::error("--bench-transforms expects object counts");
+            return 1;
+        }
+        objectCounts.push_back(count);
+    }
+    if (objectCounts.empty())
+    {
+        objectCounts.assign(std::begin(DefaultObjectCounts), std::end(DefaultObjectCounts));
+    }
+
+    logging::info(std::format(
+        "Transform kernels: {}, best of {} runs, per object",
+        transformBatchInstructionSet(),
+        RunCount
+    ));
+    bool matches = true;
+    for (std::size_t objectCount : objectCounts)
+    {
+        matches = benchObjectCount(objectCount) && matches;
+    }
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <span>
+#include <string_view>
+
+// Compare the batch transform kernels with per-object glm calls and check that
+// they agree. Arguments are object counts, 10k and 1M by default.
+// Returns the process exit code.
+int benchTransforms(std::span<const std::string_view> arguments);
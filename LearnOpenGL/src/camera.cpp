@@ -1,35 +1,47 @@
 #include "camera.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <logging/logs.h>
+#include <algorithm>
 #include <cmath>
 #include <format>
 
+#include "cpu_profiler.h"
+
 Camera::Camera()
-    : _position(DefaultPosition),
-      _front(),
-      _up(),
-      _right(),
-      _worldUp(DefaultWorldUp),
-      _yaw(DefaultYaw),
-      _pitch(DefaultPitch),
-      _fieldOfView(DefaultFieldOfView)
+    : Camera(DefaultPosition, DefaultWorldUp, DefaultYaw, DefaultPitch, DefaultFieldOfView)
 {
-    updateDirections();
 }
 
+// Versions start ahead of the caches, so everything is derived on first use.
 Camera::Camera(
     const glm::vec3& position, const glm::vec3& worldUp, float yaw, float pitch, float fieldOfView
 )
     : _position(position),
-      _front(),
-      _up(),
-      _right(),
       _worldUp(worldUp),
       _yaw(yaw),
       _pitch(pitch),
-      _fieldOfView(fieldOfView)
+      _fieldOfView(fieldOfView),
+      _aspectRatio(DefaultAspectRatio),
+      _nearPlane(DefaultNearPlane),
+      _farPlane(DefaultFarPlane),
+      _orientationVersion(1),
+      _viewVersion(1),
+      _projectionVersion(1),
+      _front(),
+      _up(),
+      _right(),
+      _directionsVersion{},
+      _view(),
+      _inverseView(),
+      _cachedViewVersion{},
+      _projection(),
+      _inverseProjection(),
+      _cachedProjectionVersion{},
+      _viewProjection(),
+      _inverseViewProjection(),
+      _frustum(),
+      _cachedVersion{}
 {
-    updateDirections();
 }
 
 glm::vec3 Camera::position() const
@@ -39,16 +51,19 @@ glm::vec3 Camera::position() const
 
 glm::vec3 Camera::front() const
 {
+    updateDirections();
     return _front;
 }
 
 glm::vec3 Camera::up() const
 {
+    updateDirections();
     return _up;
 }
 
 glm::vec3 Camera::right() const
 {
+    updateDirections();
     return _right;
 }
 
@@ -62,6 +77,21 @@ float Camera::fieldOfView() const
     return _fieldOfView;
 }
 
+float Camera::aspectRatio() const
+{
+    return _aspectRatio;
+}
+
+float Camera::nearPlane() const
+{
+    return _nearPlane;
+}
+
+float Camera::farPlane() const
+{
+    return _farPlane;
+}
+
 constexpr float Camera::speed() const
 {
     return Speed;
@@ -74,21 +104,53 @@ constexpr float Camera::sensitivity() const
 
 void Camera::fieldOfView(float fieldOfView)
 {
+    fieldOfView = std::clamp(fieldOfView, 10.0f, 45.0f);
+    if (fieldOfView == _fieldOfView)
+    {
+        return;
+    }
     _fieldOfView = fieldOfView;
-    if (_fieldOfView < 10.0f)
+    _projectionVersion++;
+    logging::debug(std::format("Camera field of view: {}", _fieldOfView));
+}
+
+void Camera::aspectRatio(float aspectRatio)
+{
+    if (aspectRatio > 0.0f && aspectRatio != _aspectRatio)
     {
-        _fieldOfView = 10.0f;
+        _aspectRatio = aspectRatio;
+        _projectionVersion++;
     }
-    else if (_fieldOfView > 45.0f)
+}
+
+void Camera::clipPlanes(float nearPlane, float farPlane)
+{
+    if (nearPlane != _nearPlane || farPlane != _farPlane)
     {
-        _fieldOfView = 45.0f;
+        _nearPlane = nearPlane;
+        _farPlane = farPlane;
+        _projectionVersion++;
+    }
+}
+
+void Camera::position(const glm::vec3& position)
+{
+    if (position != _position)
+    {
+        _position = position;
+        _viewVersion++;
     }
-    logging::debug(std::format("Camera field of view: {}", _fieldOfView));
 }
 
 void Camera::translate(const glm::vec3& translation)
 {
-    _position += translation;
+    glm::vec3 position = _position + translation;
+    if (position == _position)
+    {
+        return;
+    }
+    _position = position;
+    _viewVersion++;
     logging::debug(
         std::format("Camera position: ({}, {}, {})", _position.x, _position.y, _position.z)
     );
@@ -96,33 +158,133 @@ void Camera::translate(const glm::vec3& translation)
 
 void Camera::rotate(float yaw, float pitch)
 {
-    _yaw += yaw;
-    _pitch += pitch;
-    if (_pitch > 89.0f)
-    {
-        _pitch = 89.0f;
-    }
-    else if (_pitch < -89.0f)
+    yaw += _yaw;
+    pitch = std::clamp(_pitch + pitch, -89.0f, 89.0f);
+    // Looking further up or down than the clamp allows changes nothing.
+    if (yaw == _yaw && pitch == _pitch)
     {
-        _pitch = -89.0f;
+        return;
     }
-    updateDirections();
+    _yaw = yaw;
+    _pitch = pitch;
+    // Directions follow on first use, once per frame however many events arrive.
+    _orientationVersion++;
+    _viewVersion++;
 }
 
-glm::mat4 Camera::getViewMatrix() const
+std::uint64_t Camera::viewVersion() const
 {
-    return glm::lookAt(_position, _position + _front, _up);
+    return _viewVersion;
 }
 
-void Camera::updateDirections()
+std::uint64_t Camera::projectionVersion() const
 {
-    _front = glm::vec3(
-        std::cosf(glm::radians(_yaw)) * std::cosf(glm::radians(_pitch)),
-        std::sinf(glm::radians(_pitch)),
-        std::sinf(glm::radians(_yaw)) * std::cosf(glm::radians(_pitch))
-    );
+    return _projectionVersion;
+}
+
+std::uint64_t Camera::version() const
+{
+    // Both only grow, so the sum changes whenever either does.
+    return _viewVersion + _projectionVersion;
+}
+
+const glm::mat4& Camera::getViewMatrix() const
+{
+    updateView();
+    return _view;
+}
+
+const glm::mat4& Camera::getInverseViewMatrix() const
+{
+    updateView();
+    return _inverseView;
+}
+
+const glm::mat4& Camera::getProjectionMatrix() const
+{
+    updateProjection();
+    return _projection;
+}
+
+const glm::mat4& Camera::getInverseProjectionMatrix() const
+{
+    updateProjection();
+    return _inverseProjection;
+}
+
+const glm::mat4& Camera::getViewProjectionMatrix() const
+{
+    updateViewProjection();
+    return _viewProjection;
+}
+
+const glm::mat4& Camera::getInverseViewProjectionMatrix() const
+{
+    updateViewProjection();
+    return _inverseViewProjection;
+}
+
+const Frustum& Camera::frustum() const
+{
+    updateViewProjection();
+    return _frustum;
+}
+
+void Camera::updateDirections() const
+{
+    if (_directionsVersion == _orientationVersion)
+    {
+        return;
+    }
+    float yaw = glm::radians(_yaw);
+    float pitch = glm::radians(_pitch);
+    float cosPitch = std::cos(pitch);
+    _front = glm::vec3(std::cos(yaw) * cosPitch, std::sin(pitch), std::sin(yaw) * cosPitch);
     _front = glm::normalize(_front);
     _right = glm::normalize(glm::cross(_front, _worldUp));
     _up = glm::normalize(glm::cross(_right, _front));
+    _directionsVersion = _orientationVersion;
     logging::debug(std::format("Camera front: ({}, {}, {})", _front.x, _front.y, _front.z));
 }
+
+void Camera::updateView() const
+{
+    if (_cachedViewVersion == _viewVersion)
+    {
+        return;
+    }
+    ZONE("Camera::updateView");
+    updateDirections();
+    _view = glm::lookAt(_position, _position + _front, _up);
+    // The view is a rigid transform, inverted by transposing its rotation.
+    glm::mat3 rotation = glm::transpose(glm::mat3(_view));
+    _inverseView = glm::mat4(rotation);
+    _inverseView[3] = glm::vec4(_position, 1.0f);
+    _cachedViewVersion = _viewVersion;
+}
+
+void Camera::updateProjection() const
+{
+    if (_cachedProjectionVersion == _projectionVersion)
+    {
+        return;
+    }
+    _projection =
+        glm::perspective(glm::radians(_fieldOfView), _aspectRatio, _nearPlane, _farPlane);
+    _inverseProjection = glm::inverse(_projection);
+    _cachedProjectionVersion = _projectionVersion;
+}
+
+void Camera::updateViewProjection() const
+{
+    if (_cachedVersion == version())
+    {
+        return;
+    }
+    updateView();
+    updateProjection();
+    _viewProjection = _projection * _view;
+    _inverseViewProjection = _inverseView * _inverseProjection;
+    _frustum = extractFrustum(_viewProjection);
+    _cachedVersion = version();
+}
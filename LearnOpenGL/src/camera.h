@@ -1,8 +1,15 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
+
+#include "frustum.h"
 
 // An abstract camera representation, encapsulating functionality
-// related to view matrices and field of view.
+// related to view and projection matrices.
+//
+// Directions, matrices and the frustum are derived on first use after a change
+// and cached until the next one. Version counters tell users of the camera
+// when what they derived from it is out of date.
 class Camera
 {
   public:
@@ -13,6 +20,9 @@ class Camera
     static constexpr float DefaultYaw = -90.0f;
     static constexpr float DefaultPitch = 0.0f;
     static constexpr float DefaultFieldOfView = 45.0f;
+    static constexpr float DefaultAspectRatio = 4.0f / 3.0f;
+    static constexpr float DefaultNearPlane = 0.1f;
+    static constexpr float DefaultFarPlane = 100.0f;
 
     Camera();
     Camera(
@@ -27,26 +37,70 @@ class Camera
     glm::vec3 right() const;
     glm::vec3 worldUp() const;
     float fieldOfView() const;
+    float aspectRatio() const;
+    float nearPlane() const;
+    float farPlane() const;
     constexpr float speed() const;
     constexpr float sensitivity() const;
 
+    void position(const glm::vec3& position);
     void translate(const glm::vec3& translation);
     void rotate(float yaw, float pitch);
     void fieldOfView(float fieldOfView);
+    // Width over height of the viewport, ignored unless positive.
+    void aspectRatio(float aspectRatio);
+    void clipPlanes(float nearPlane, float farPlane);
+
+    // Incremented by every change of the position or orientation. Calls that
+    // leave them as they were, such as pitching past the clamp, do not count.
+    std::uint64_t viewVersion() const;
+    // Incremented by every change of the field of view, aspect ratio or clip planes.
+    std::uint64_t projectionVersion() const;
+    // Incremented by every change of the camera; the version of the view
+    // projection matrices and the frustum.
+    std::uint64_t version() const;
 
-    // Calculate the view matrix based on the camera's position and directions.
-    glm::mat4 getViewMatrix() const;
+    const glm::mat4& getViewMatrix() const;
+    const glm::mat4& getInverseViewMatrix() const;
+    const glm::mat4& getProjectionMatrix() const;
+    const glm::mat4& getInverseProjectionMatrix() const;
+    const glm::mat4& getViewProjectionMatrix() const;
+    const glm::mat4& getInverseViewProjectionMatrix() const;
+    const Frustum& frustum() const;
 
   private:
     glm::vec3 _position;
-    glm::vec3 _front;
-    glm::vec3 _up;
-    glm::vec3 _right;
     glm::vec3 _worldUp;
     float _yaw;
     float _pitch;
     float _fieldOfView;
+    float _aspectRatio;
+    float _nearPlane;
+    float _farPlane;
+    // Orientation counts yaw and pitch changes only, the view also counts moves.
+    std::uint64_t _orientationVersion;
+    std::uint64_t _viewVersion;
+    std::uint64_t _projectionVersion;
+
+    // Caches, each with the version it was derived at.
+    mutable glm::vec3 _front;
+    mutable glm::vec3 _up;
+    mutable glm::vec3 _right;
+    mutable std::uint64_t _directionsVersion;
+    mutable glm::mat4 _view;
+    mutable glm::mat4 _inverseView;
+    mutable std::uint64_t _cachedViewVersion;
+    mutable glm::mat4 _projection;
+    mutable glm::mat4 _inverseProjection;
+    mutable std::uint64_t _cachedProjectionVersion;
+    mutable glm::mat4 _viewProjection;
+    mutable glm::mat4 _inverseViewProjection;
+    mutable Frustum _frustum;
+    mutable std::uint64_t _cachedVersion;
 
     // Update camera's front, up and right vectors after changing yaw and/or pitch.
-    void updateDirections();
+    void updateDirections() const;
+    void updateView() const;
+    void updateProjection() const;
+    void updateViewProjection() const;
 };
@@ -0,0 +1,162 @@
+#include "cpu_profiler.h"
+#include <logging/logs.h>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace profiling
+{
+
+namespace
+{
+
+struct Registry
+{
+    std::mutex mutex;
+    // Never freed, so events of finished threads can still be exported.
+    std::vector<std::unique_ptr<ThreadEvents>> threads;
+    // Pairs time stamp counter values with clock time to convert them later.
+    std::uint64_t startTicks = timestamp();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+};
+
+Registry& registry()
+{
+    static Registry instance{};
+    return instance;
+}
+
+std::string escapeJson(std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char character : text)
+    {
+        if (character == '"' || character == '\\')
+        {
+            escaped += '\\';
+        }
+        if (static_cast<unsigned char>(character) < 0x20)
+        {
+            escaped += std::format("\\u{:04x}", static_cast<unsigned char>(character));
+            continue;
+        }
+        escaped += character;
+    }
+    return escaped;
+}
+
+}
+
+ThreadEvents& registerThread()
+{
+    Registry& instance = registry();
+    std::lock_guard lock(instance.mutex);
+    auto events = std::make_unique<ThreadEvents>();
+    events->threadId = static_cast<std::uint32_t>(instance.threads.size() + 1);
+    events->threadName = std::format("Thread {}", events->threadId);
+    addChunk(*events, 0);
+    instance.threads.push_back(std::move(events));
+    return *instance.threads.back();
+}
+
+Event* addChunk(ThreadEvents& events, std::size_t chunkIndex)
+{
+    // Touch every page now rather than fault them in one zone at a time.
+    Event* chunk = new Event[ThreadEvents::ChunkSize]();
+    events.chunks[chunkIndex].store(chunk, std::memory_order_release);
+    return chunk;
+}
+
+void startRecording()
+{
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void setThreadName(const char* name)
+{
+    ThreadEvents& events = threadEvents();
+    std::lock_guard lock(registry().mutex);
+    events.threadName = name;
+}
+
+bool writeChromeTrace(const std::string& path)
+{
+#ifndef PROFILER_ENABLED
+    logging::error(std::format("Cannot write {}: built without PROFILER_ENABLED", path));
+    return false;
+#else
+    Registry& instance = registry();
+    std::lock_guard lock(instance.mutex);
+
+    std::uint64_t ticks = timestamp() - instance.startTicks;
+    auto elapsed = std::chrono::steady_clock::now() - instance.startTime;
+    double microseconds = std::chrono::duration<double, std::micro>(elapsed).count();
+    double microsecondsPerTick = ticks > 0 ? microseconds / static_cast<double>(ticks) : 0.0;
+    auto toMicroseconds = [&](std::uint64_t tick) {
+        // Zones may have begun before the first thread registered.
+        auto sinceStart = static_cast<std::int64_t>(tick - instance.startTicks);
+        return static_cast<double>(sinceStart) * microsecondsPerTick;
+    };
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        logging::error(std::format("Failed to create {}", path));
+        return false;
+    }
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    std::size_t eventCount = 0;
+    std::uint64_t dropped = 0;
+    for (const auto& events : instance.threads)
+    {
+        file << std::format(
+            "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+            "\"args\":{{\"name\":\"{}\"}}}}",
+            first ? "" : ",\n",
+            events->threadId,
+            escapeJson(events->threadName)
+        );
+        first = false;
+
+        std::size_t count = events->count.load(std::memory_order_acquire);
+        for (std::size_t index = 0; index < count; index++)
+        {
+            const Event* chunk =
+                events->chunks[index / ThreadEvents::ChunkSize].load(std::memory_order_acquire);
+            const Event& event = chunk[index % ThreadEvents::ChunkSize];
+            // Complete events; viewers nest them by their intervals.
+            file << std::format(
+                ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+                "\"dur\":{:.3f}}}",
+                escapeJson(event.name),
+                events->threadId,
+                toMicroseconds(event.begin),
+                static_cast<double>(event.end - event.begin) * microsecondsPerTick
+            );
+        }
+        eventCount += count;
+        dropped += events->dropped.load(std::memory_order_relaxed);
+    }
+    file << "\n]}\n";
+    if (!file)
+    {
+        logging::error(std::format("Failed to write {}", path));
+        return false;
+    }
+
+    logging::info(std::format("Wrote {} zones to {}", eventCount, path));
+    if (dropped > 0)
+    {
+        logging::warning(std::format("{} zones were dropped after filling the buffers", dropped));
+    }
+    return true;
+#endif
+}
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#include <chrono>
+#endif
+
+// CPU instrumentation zones, exported as a Chrome trace that chrome://tracing
+// and Perfetto open. ZONE("name") measures the rest of the enclosing block.
+// Without PROFILER_ENABLED defined zones compile to nothing, and until
+// startRecording() is called they record nothing. Release defines it too, so
+// traces measure optimized code; an idle zone costs one relaxed load.
+#ifdef PROFILER_ENABLED
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+#define ZONE(name) ::profiling::Zone PROFILER_CONCAT(profilerZone, __COUNTER__)(name)
+#define PROFILER_THREAD_NAME(name) ::profiling::setThreadName(name)
+#else
+#define ZONE(name)
+#define PROFILER_THREAD_NAME(name)
+#endif
+
+namespace profiling
+{
+
+#ifdef PROFILER_ENABLED
+inline constexpr bool Enabled = true;
+#else
+inline constexpr bool Enabled = false;
+#endif
+
+// A finished zone. Names must outlive the export, string literals do.
+struct Event
+{
+    const char* name;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+// Events recorded by one thread. Only that thread writes; exporting reads the
+// events published so far, so recording takes no lock.
+struct ThreadEvents
+{
+    static constexpr std::size_t ChunkSize = 16384;
+    // Further events are dropped once a thread filled every chunk.
+    static constexpr std::size_t MaxChunks = 256;
+
+    std::atomic<Event*> chunks[MaxChunks];
+    std::atomic<std::size_t> count;
+    std::atomic<std::uint64_t> dropped;
+    std::uint32_t threadId;
+    std::string threadName;
+};
+
+// Set by startRecording(), only ever read relaxed: zones opened just before
+// it may be missed, which a trace does not mind.
+inline std::atomic<bool> recording{false};
+
+// Processor time stamp counter where there is one, else steady clock ticks.
+// Either is converted to time when exporting.
+inline std::uint64_t timestamp()
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Add an event buffer for the calling thread.
+ThreadEvents& registerThread();
+
+inline thread_local ThreadEvents* currentThreadEvents = nullptr;
+
+inline ThreadEvents& threadEvents()
+{
+    if (currentThreadEvents == nullptr)
+    {
+        currentThreadEvents = &registerThread();
+    }
+    return *currentThreadEvents;
+}
+
+// Allocate and publish a chunk of the calling thread's events.
+Event* addChunk(ThreadEvents& events, std::size_t chunkIndex);
+
+inline void record(const char* name, std::uint64_t begin, std::uint64_t end)
+{
+    ThreadEvents* events = &threadEvents();
+    std::size_t index = events->count.load(std::memory_order_relaxed);
+    std::size_t chunkIndex = index / ThreadEvents::ChunkSize;
+    if (chunkIndex == ThreadEvents::MaxChunks)
+    {
+        events->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Event* chunk = events->chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (chunk == nullptr)
+    {
+        chunk = addChunk(*events, chunkIndex);
+    }
+    chunk[index % ThreadEvents::ChunkSize] = Event{name, begin, end};
+    // Publish the event to exports running on other threads.
+    events->count.store(index + 1, std::memory_order_release);
+}
+
+class Zone
+{
+  public:
+    explicit Zone(const char* name)
+        : _name(recording.load(std::memory_order_relaxed) ? name : nullptr),
+          _begin(_name != nullptr ? timestamp() : 0)
+    {
+    }
+    ~Zone()
+    {
+        if (_name != nullptr)
+        {
+            record(_name, _begin, timestamp());
+        }
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+  private:
+    const char* _name;
+    std::uint64_t _begin;
+};
+
+// Record zones from now on, for a trace written later.
+void startRecording();
+
+// Name the calling thread in exported traces.
+void setThreadName(const char* name);
+
+// Write every event recorded so far as Chrome trace event JSON. Threads may
+// keep recording meanwhile. Returns false if the file could not be written or
+// the profiler is compiled out.
+bool writeChromeTrace(const std::string& path);
+
+}
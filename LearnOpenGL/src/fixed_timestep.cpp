@@ -0,0 +1,54 @@
+#include "fixed_timestep.h"
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(double tickRate, std::uint32_t maxTicksPerFrame)
+    : _tickDuration(std::max<Duration::rep>(
+          std::chrono::duration_cast<Duration>(std::chrono::duration<double>(1.0 / tickRate))
+              .count(),
+          1
+      )),
+      _maxTicksPerFrame(std::max<std::uint32_t>(maxTicksPerFrame, 1)),
+      _accumulator{},
+      _tickCount{},
+      _droppedTicks{}
+{
+}
+
+std::uint32_t FixedTimestep::advance(Duration frameTime)
+{
+    _accumulator += std::max(frameTime, Duration::zero());
+    auto ticks = static_cast<std::uint64_t>(_accumulator / _tickDuration);
+    _accumulator %= _tickDuration;
+    if (ticks > _maxTicksPerFrame)
+    {
+        _droppedTicks += ticks - _maxTicksPerFrame;
+        ticks = _maxTicksPerFrame;
+    }
+    _tickCount += ticks;
+    return static_cast<std::uint32_t>(ticks);
+}
+
+FixedTimestep::Duration FixedTimestep::tickDuration() const
+{
+    return _tickDuration;
+}
+
+double FixedTimestep::tickSeconds() const
+{
+    return std::chrono::duration<double>(_tickDuration).count();
+}
+
+std::uint64_t FixedTimestep::tickCount() const
+{
+    return _tickCount;
+}
+
+std::uint64_t FixedTimestep::droppedTicks() const
+{
+    return _droppedTicks;
+}
+
+double FixedTimestep::alpha() const
+{
+    return static_cast<double>(_accumulator.count()) / static_cast<double>(_tickDuration.count());
+}
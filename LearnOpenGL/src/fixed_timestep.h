@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Schedules simulation ticks of a fixed duration independently of the frame
+// rate. Real time accumulates every frame and is spent in whole ticks; what is
+// left over tells how far rendering is between the last two simulated states.
+// Time is kept in integer nanoseconds so that the same frame times always give
+// the same ticks.
+class FixedTimestep
+{
+  public:
+    using Duration = std::chrono::nanoseconds;
+
+    static constexpr double DefaultTickRate = 60.0;
+    // Ticks run in one frame at most. A longer backlog is dropped, so a slow
+    // frame slows the simulation down instead of making later frames slower.
+    static constexpr std::uint32_t DefaultMaxTicksPerFrame = 5;
+
+    explicit FixedTimestep(
+        double tickRate = DefaultTickRate, std::uint32_t maxTicksPerFrame = DefaultMaxTicksPerFrame
+    );
+
+    // Add the real time of a frame and get the number of ticks to simulate now.
+    std::uint32_t advance(Duration frameTime);
+
+    Duration tickDuration() const;
+    // Tick duration in seconds, the step to simulate with.
+    double tickSeconds() const;
+    // Ticks scheduled since construction.
+    std::uint64_t tickCount() const;
+    // Ticks dropped because frames took too long.
+    std::uint64_t droppedTicks() const;
+    // Position of the current frame between the second to last and the last
+    // tick, from 0 to 1; rendering interpolates the two states by it.
+    double alpha() const;
+
+  private:
+    Duration _tickDuration;
+    std::uint32_t _maxTicksPerFrame;
+    Duration _accumulator;
+    std::uint64_t _tickCount;
+    std::uint64_t _droppedTicks;
+};
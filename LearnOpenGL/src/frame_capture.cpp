@@ -0,0 +1,224 @@
+#include "frame_capture.h"
+#include <logging/logs.h>
+#include <assets/image.h>
+#include <assets/png.h>
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <utility>
+
+FrameCapture::FrameCapture(
+    ThreadPool& threadPool, std::string path, CaptureFormat format, std::size_t ringSize
+)
+    : _threadPool(threadPool),
+      _path(std::move(path)),
+      _format(format),
+      // Value initialized slots, each creating its buffer.
+      _slots(std::max<std::size_t>(ringSize, 1)),
+      _oldest{},
+      _inFlight{},
+      _stream(),
+      _mutex(),
+      _written(),
+      _pendingFrames{},
+      _nextSequence{},
+      _writtenSequence{},
+      _failed{false}
+{
+    if (_format == CaptureFormat::RawVideo)
+    {
+        _stream.open(_path, std::ios::binary | std::ios::trunc);
+        if (!_stream)
+        {
+            logging::error(std::format("Failed to create {}", _path));
+            _failed = true;
+        }
+    }
+}
+
+FrameCapture::~FrameCapture()
+{
+    finish();
+}
+
+void FrameCapture::capture(GLuint framebuffer, int width, int height, std::uint64_t frameIndex)
+{
+    // Pass on every frame the GPU is done with, then free the slot about to be
+    // reused. That only waits when the GPU is a whole ring of frames behind.
+    while (_inFlight > 0 && collectOldest(false))
+    {
+    }
+    if (_inFlight == _slots.size())
+    {
+        collectOldest(true);
+    }
+
+    Slot& slot = _slots[(_oldest + _inFlight) % _slots.size()];
+    auto size = static_cast<GLsizeiptr>(width) * height * 4;
+    if (size != slot.size)
+    {
+        slot.buffer.data(size, nullptr, GL_STREAM_READ);
+        slot.size = size;
+    }
+
+    // The read state changed here belongs to the caller, so it is put back.
+    GLint readFramebuffer = 0;
+    GLint packBuffer = 0;
+    GLint packAlignment = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    GLint readBuffer = 0;
+    glGetIntegerv(GL_READ_BUFFER, &readBuffer);
+
+    slot.buffer.bind(GL_PIXEL_PACK_BUFFER);
+    glReadBuffer(framebuffer == 0 ? GL_BACK : GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    // With a pack buffer bound the copy is queued on the GPU and returns at once.
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    glReadBuffer(static_cast<GLenum>(readBuffer));
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(packBuffer));
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(readFramebuffer));
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.width = width;
+    slot.height = height;
+    slot.frameIndex = frameIndex;
+    _inFlight++;
+}
+
+bool FrameCapture::finish()
+{
+    while (_inFlight > 0)
+    {
+        collectOldest(true);
+    }
+    std::unique_lock lock(_mutex);
+    _written.wait(lock, [this] { return _pendingFrames == 0; });
+    if (_stream.is_open())
+    {
+        _stream.flush();
+    }
+    return !_failed;
+}
+
+bool FrameCapture::collectOldest(bool wait)
+{
+    Slot& slot = _slots[_oldest];
+    // The first check flushes, so the fence is sure to reach the GPU.
+    GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (wait && status == GL_TIMEOUT_EXPIRED)
+    {
+        status = glClientWaitSync(slot.fence, 0, 1'000'000);
+    }
+    if (status == GL_TIMEOUT_EXPIRED)
+    {
+        return false;
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    // Without a signaled fence the copy may not have finished, and without a
+    // mapping there is nothing to read, so the frame is dropped rather than
+    // written with whatever the buffer holds.
+    if (status == GL_WAIT_FAILED)
+    {
+        logging::error(std::format("Failed to wait for frame {}", slot.frameIndex));
+        _failed = true;
+    }
+    else if (const void* data = slot.buffer.map(0, slot.size, GL_MAP_READ_BIT); data != nullptr)
+    {
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(slot.size));
+        std::memcpy(pixels.data(), data, pixels.size());
+        slot.buffer.unmap();
+        encode(std::move(pixels), slot.width, slot.height, slot.frameIndex);
+    }
+    else
+    {
+        logging::error(std::format("Failed to map frame {}", slot.frameIndex));
+        _failed = true;
+    }
+
+    _oldest = (_oldest + 1) % _slots.size();
+    _inFlight--;
+    return true;
+}
+
+void FrameCapture::encode(
+    std::vector<std::uint8_t> pixels, int width, int height, std::uint64_t frameIndex
+)
+{
+    std::uint64_t sequence{};
+    {
+        // Let the workers catch up rather than queueing frames without bound.
+        std::unique_lock lock(_mutex);
+        _written.wait(lock, [this] { return _pendingFrames < MaxPendingFrames; });
+        _pendingFrames++;
+        sequence = _nextSequence++;
+    }
+    _threadPool.submit(
+        [this, pixels = std::move(pixels), width, height, frameIndex, sequence]() mutable {
+            write(std::move(pixels), width, height, frameIndex, sequence);
+        }
+    );
+}
+
+void FrameCapture::write(
+    std::vector<std::uint8_t> pixels,
+    int width,
+    int height,
+    std::uint64_t frameIndex,
+    std::uint64_t sequence
+)
+{
+    if (_format == CaptureFormat::Png)
+    {
+        std::string path = _path;
+        if (std::size_t field = path.find("{}"); field != std::string::npos)
+        {
+            path.replace(field, 2, std::format("{:06}", frameIndex));
+        }
+        assets::Image image{
+            static_cast<std::uint32_t>(width),
+            static_cast<std::uint32_t>(height),
+            std::move(pixels),
+        };
+        if (!assets::writePng(path, image))
+        {
+            logging::error(std::format("Failed to write {}", path));
+            _failed = true;
+        }
+        std::lock_guard lock(_mutex);
+        _pendingFrames--;
+        _written.notify_all();
+        return;
+    }
+
+    // Flip to rows from the top before taking the stream in capture order.
+    std::size_t rowSize = std::size_t(width) * 4;
+    std::vector<std::uint8_t> rows(pixels.size());
+    for (int row = 0; row < height; row++)
+    {
+        std::memcpy(
+            &rows[std::size_t(height - 1 - row) * rowSize], &pixels[row * rowSize], rowSize
+        );
+    }
+    std::unique_lock lock(_mutex);
+    _written.wait(lock, [this, sequence] { return _writtenSequence == sequence; });
+    if (_stream)
+    {
+        _stream.write(
+            reinterpret_cast<const char*>(rows.data()), static_cast<std::streamsize>(rows.size())
+        );
+        if (!_stream)
+        {
+            logging::error(std::format("Failed to write {}", _path));
+            _failed = true;
+        }
+    }
+    _writtenSequence++;
+    _pendingFrames--;
+    _written.notify_all();
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <glad/glad.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gl_objects.h"
+#include "thread_pool.h"
+
+enum class CaptureFormat
+{
+    // One PNG file per frame.
+    Png,
+    // Every frame appended to one file as raw RGBA rows from the top, the
+    // input of "ffmpeg -f rawvideo -pixel_format rgba -video_size WxH".
+    RawVideo,
+};
+
+// Continuous capture of rendered frames without stalling the GPU. Each frame
+// is copied into the next pixel buffer object of a ring by glReadPixels and
+// fenced; buffers are only mapped frames later, once their fence has
+// signaled. Encoding and writing happen on the thread pool.
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+class FrameCapture
+{
+  public:
+    static constexpr std::size_t DefaultRingSize = 3;
+    // Frames waiting for a worker before capture() blocks to let them catch up.
+    static constexpr std::size_t MaxPendingFrames = 8;
+
+    // For Png the path must contain "{}", replaced by the frame index.
+    FrameCapture(
+        ThreadPool& threadPool,
+        std::string path,
+        CaptureFormat format,
+        std::size_t ringSize = DefaultRingSize
+    );
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Queue a copy of the color buffer of a framebuffer, 0 being the default
+    // one's back buffer. Call after drawing the frame and before swapping.
+    // The read framebuffer, read buffer and pack state are left as they were.
+    void capture(GLuint framebuffer, int width, int height, std::uint64_t frameIndex);
+    // Wait for every queued frame to be written. Returns false if any frame
+    // could not be read back or written.
+    bool finish();
+
+  private:
+    struct Slot
+    {
+        Buffer buffer;
+        GLsizeiptr size;
+        GLsync fence;
+        int width;
+        int height;
+        std::uint64_t frameIndex;
+    };
+
+    ThreadPool& _threadPool;
+    std::string _path;
+    CaptureFormat _format;
+    std::vector<Slot> _slots;
+    // Oldest slot holding a frame and the number of slots holding one.
+    std::size_t _oldest;
+    std::size_t _inFlight;
+    std::ofstream _stream;
+
+    std::mutex _mutex;
+    std::condition_variable _written;
+    std::size_t _pendingFrames;
+    // Raw video frames are written in the order they were captured.
+    std::uint64_t _nextSequence;
+    std::uint64_t _writtenSequence;
+    std::atomic<bool> _failed;
+
+    // Hand the oldest frame to a worker, waiting for its fence if wait is set.
+    // A frame whose fence cannot be waited on or whose buffer cannot be mapped
+    // is dropped and marks the capture failed. Returns false if the frame is not
+    // ready yet.
+    bool collectOldest(bool wait);
+    void encode(std::vector<std::uint8_t> pixels, int width, int height, std::uint64_t frameIndex);
+    void write(
+        std::vector<std::uint8_t> pixels,
+        int width,
+        int height,
+        std::uint64_t frameIndex,
+        std::uint64_t sequence
+    );
+};
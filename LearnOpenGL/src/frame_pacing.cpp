@@ -0,0 +1,208 @@
+#include "frame_pacing.h"
+#include <GLFW/glfw3.h>
+#include <logging/logs.h>
+#include <charconv>
+#include <thread>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <time.h>
+#endif
+
+#include "cpu_profiler.h"
+
+namespace
+{
+
+template <typename T>
+bool parseNumber(std::string_view text, T& value)
+{
+    const char* last = text.data() + text.size();
+    auto [end, error] = std::from_chars(text.data(), last, value);
+    return error == std::errc{} && end == last;
+}
+
+}
+
+bool parseFramePacingOption(
+    std::string_view name, std::string_view value, FramePacingOptions& options
+)
+{
+    if (name == "--vsync")
+    {
+        if (value == "off")
+        {
+            options.vsync = VsyncMode::Off;
+        }
+        else if (value == "on")
+        {
+            options.vsync = VsyncMode::On;
+        }
+        else if (value == "adaptive")
+        {
+            options.vsync = VsyncMode::Adaptive;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+    if (name == "--fps")
+    {
+        return parseNumber(value, options.targetFrameRate) && options.targetFrameRate >= 0.0;
+    }
+    if (name == "--frames-in-flight")
+    {
+        return parseNumber(value, options.maxFramesInFlight);
+    }
+    if (name == "--low-latency")
+    {
+        options.lowLatency = true;
+        return value.empty();
+    }
+    if (name == "--on-demand")
+    {
+        options.onDemand = true;
+        return value.empty();
+    }
+    return false;
+}
+
+void applyVsync(VsyncMode mode)
+{
+    int interval = mode == VsyncMode::Off ? 0 : 1;
+    if (mode == VsyncMode::Adaptive)
+    {
+        // Negative intervals need the swap control tear extensions.
+        if (glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+            glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+        {
+            interval = -1;
+        }
+        else
+        {
+            logging::warning("Adaptive vsync is not supported, using vsync");
+        }
+    }
+    glfwSwapInterval(interval);
+}
+
+FrameLimiter::FrameLimiter(double targetFrameRate)
+    : _period(
+          targetFrameRate > 0.0 ? std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(1.0 / targetFrameRate)
+                                  )
+                                : Clock::duration::zero()
+      ),
+      _deadline(),
+      _timer(nullptr)
+{
+#ifdef _WIN32
+    _timer = CreateWaitableTimerExW(
+        nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS
+    );
+#endif
+}
+
+FrameLimiter::~FrameLimiter()
+{
+#ifdef _WIN32
+    if (_timer != nullptr)
+    {
+        CloseHandle(_timer);
+    }
+#endif
+}
+
+void FrameLimiter::wait()
+{
+    if (_period == Clock::duration::zero())
+    {
+        return;
+    }
+    ZONE("FrameLimiter::wait");
+    Clock::time_point now = Clock::now();
+    if (now < _deadline)
+    {
+        if (_deadline - now > SpinThreshold)
+        {
+            sleepUntil(_deadline - SpinThreshold);
+        }
+        while (Clock::now() < _deadline)
+        {
+        }
+    }
+    // Schedule from the deadline to keep an even cadence, unless the frame ran
+    // a whole period late: catching up would deliver a burst of frames.
+    _deadline = now - _deadline > _period ? now + _period : _deadline + _period;
+}
+
+void FrameLimiter::sleepUntil(Clock::time_point time)
+{
+#ifdef _WIN32
+    if (_timer != nullptr)
+    {
+        // Relative due times are negative, in 100 ns units.
+        using Ticks = std::chrono::duration<LONGLONG, std::ratio<1, 10'000'000>>;
+        LARGE_INTEGER dueTime{};
+        dueTime.QuadPart = -std::chrono::duration_cast<Ticks>(time - Clock::now()).count();
+        if (dueTime.QuadPart < 0 && SetWaitableTimer(_timer, &dueTime, 0, nullptr, nullptr, FALSE))
+        {
+            WaitForSingleObject(_timer, INFINITE);
+        }
+        return;
+    }
+    std::this_thread::sleep_until(time);
+#else
+    // The steady clock is CLOCK_MONOTONIC, so its time points are absolute deadlines.
+    auto sinceEpoch = time.time_since_epoch();
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+    timespec deadline{};
+    deadline.tv_sec = static_cast<time_t>(seconds.count());
+    deadline.tv_nsec = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch - seconds).count()
+    );
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+    {
+    }
+#endif
+}
+
+FrameFences::FrameFences(std::uint32_t maxFramesInFlight)
+    : _maxFramesInFlight(maxFramesInFlight),
+      _fences()
+{
+}
+
+FrameFences::~FrameFences()
+{
+    for (GLsync fence : _fences)
+    {
+        glDeleteSync(fence);
+    }
+}
+
+void FrameFences::endFrame()
+{
+    if (_maxFramesInFlight == 0)
+    {
+        return;
+    }
+    ZONE("FrameFences::endFrame");
+    _fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    while (_fences.size() >= _maxFramesInFlight)
+    {
+        // The first check flushes, so the fence is sure to reach the GPU.
+        GLenum status = glClientWaitSync(_fences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (status == GL_TIMEOUT_EXPIRED)
+        {
+            status = glClientWaitSync(_fences.front(), 0, 1'000'000);
+        }
+        glDeleteSync(_fences.front());
+        _fences.pop_front();
+    }
+}
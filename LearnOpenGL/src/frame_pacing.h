@@ -0,0 +1,93 @@
+#pragma once
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+enum class VsyncMode
+{
+    Off,
+    On,
+    // Synchronized unless a frame is late, which then tears rather than
+    // waiting for the next refresh. Falls back to On where unsupported.
+    Adaptive,
+};
+
+struct FramePacingOptions
+{
+    static constexpr std::uint32_t DefaultMaxFramesInFlight = 2;
+
+    VsyncMode vsync = VsyncMode::On;
+    // Frames per second held by the frame limiter, zero for no limit.
+    double targetFrameRate = 0.0;
+    // Frames the GPU may lag behind the CPU, zero for no limit.
+    std::uint32_t maxFramesInFlight = DefaultMaxFramesInFlight;
+    // Trade throughput for input latency: every frame is finished by the GPU
+    // before the next one samples input, so input is never a frame old.
+    bool lowLatency = false;
+    // Only render when something changed, waiting for events in between.
+    bool onDemand = false;
+};
+
+// Parse one frame pacing option:
+//   --vsync=off|on|adaptive  --fps=<rate>  --frames-in-flight=<count>  --low-latency
+//   --on-demand
+// Returns false if the name is not one of them or the value is invalid.
+bool parseFramePacingOption(
+    std::string_view name, std::string_view value, FramePacingOptions& options
+);
+
+// Set the swap interval of the current context.
+void applyVsync(VsyncMode mode);
+
+// Holds a target frame rate by waiting out the rest of every frame. Most of a
+// wait sleeps on a high resolution timer and only the last SpinThreshold
+// spins, as sleeps may overshoot by about a scheduler tick.
+class FrameLimiter
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::microseconds SpinThreshold{1000};
+
+    // A target of zero frames per second disables the limiter.
+    explicit FrameLimiter(double targetFrameRate);
+    ~FrameLimiter();
+
+    FrameLimiter(const FrameLimiter&) = delete;
+    FrameLimiter& operator=(const FrameLimiter&) = delete;
+
+    // Wait until the current frame's deadline, once per frame.
+    void wait();
+
+  private:
+    Clock::duration _period;
+    Clock::time_point _deadline;
+    // High resolution waitable timer on Windows, unused elsewhere.
+    void* _timer;
+
+    void sleepUntil(Clock::time_point time);
+};
+
+// Bounds the frames the GPU may lag behind the CPU by fencing every frame and
+// waiting for the oldest fence once too many are pending.
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+class FrameFences
+{
+  public:
+    // Zero frames in flight disables the limit.
+    explicit FrameFences(std::uint32_t maxFramesInFlight);
+    ~FrameFences();
+
+    FrameFences(const FrameFences&) = delete;
+    FrameFences& operator=(const FrameFences&) = delete;
+
+    // Fence the commands of the frame just submitted, then wait until fewer
+    // than the maximum frames are pending.
+    void endFrame();
+
+  private:
+    std::uint32_t _maxFramesInFlight;
+    std::deque<GLsync> _fences;
+};
@@ -0,0 +1,79 @@
+#include "frame_pipeline.h"
+
+FrameSnapshot* FramePipeline::beginFrame()
+{
+    // Slot (N % 2) is free once frame N - 2 has been released.
+    std::uint64_t released = _released.load(std::memory_order_acquire);
+    while (released != Closed && released + 1 < _writeIndex)
+    {
+        _released.wait(released, std::memory_order_acquire);
+        released = _released.load(std::memory_order_acquire);
+    }
+    if (released == Closed)
+    {
+        return nullptr;
+    }
+    FrameSnapshot* snapshot = &_snapshots[_writeIndex % _snapshots.size()];
+    snapshot->index = _writeIndex;
+    return snapshot;
+}
+
+void FramePipeline::submitFrame()
+{
+    _writeIndex++;
+    std::uint64_t expected = _writeIndex - 1;
+    // Never overwrite the closed marker set by the other side.
+    if (_submitted.compare_exchange_strong(expected, _writeIndex, std::memory_order_release))
+    {
+        _submitted.notify_one();
+    }
+}
+
+bool FramePipeline::waitForIdle()
+{
+    std::uint64_t released = _released.load(std::memory_order_acquire);
+    while (released != Closed && released < _writeIndex)
+    {
+        _released.wait(released, std::memory_order_acquire);
+        released = _released.load(std::memory_order_acquire);
+    }
+    return released != Closed;
+}
+
+const FrameSnapshot* FramePipeline::acquireFrame()
+{
+    std::uint64_t submitted = _submitted.load(std::memory_order_acquire);
+    while (submitted != Closed && submitted <= _readIndex)
+    {
+        _submitted.wait(submitted, std::memory_order_acquire);
+        submitted = _submitted.load(std::memory_order_acquire);
+    }
+    if (submitted == Closed)
+    {
+        return nullptr;
+    }
+    return &_snapshots[_readIndex % _snapshots.size()];
+}
+
+void FramePipeline::releaseFrame()
+{
+    _readIndex++;
+    std::uint64_t expected = _readIndex - 1;
+    if (_released.compare_exchange_strong(expected, _readIndex, std::memory_order_release))
+    {
+        _released.notify_one();
+    }
+}
+
+void FramePipeline::close()
+{
+    _submitted.store(Closed, std::memory_order_release);
+    _submitted.notify_all();
+    _released.store(Closed, std::memory_order_release);
+    _released.notify_all();
+}
+
+bool FramePipeline::closed() const
+{
+    return _released.load(std::memory_order_acquire) == Closed;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "frame_snapshot.h"
+
+// Double-buffered, lock-free hand-off of frame snapshots from the simulation
+// thread (producer) to the render thread (consumer).
+//
+// The producer fills frame N+1 while the consumer renders frame N, and blocks
+// before starting frame N+2 until frame N has been released, so at most one
+// frame is ever in flight between the two threads.
+class FramePipeline
+{
+  public:
+    FramePipeline() = default;
+    ~FramePipeline() = default;
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Wait until a snapshot slot is free and return it for writing.
+    // Returns nullptr once the pipeline has been closed.
+    FrameSnapshot* beginFrame();
+    // Publish the snapshot returned by the last call to beginFrame().
+    void submitFrame();
+    // Wait until the consumer released every submitted snapshot. Returns
+    // false once the pipeline has been closed.
+    bool waitForIdle();
+
+    // Wait for the next submitted snapshot. Returns nullptr once the pipeline has been closed.
+    const FrameSnapshot* acquireFrame();
+    // Hand the snapshot returned by the last call to acquireFrame() back to the producer.
+    void releaseFrame();
+
+    // Wake up both sides; every subsequent wait returns nullptr.
+    void close();
+    bool closed() const;
+
+  private:
+    static constexpr std::uint64_t Closed = UINT64_MAX;
+
+    std::array<FrameSnapshot, 2> _snapshots{};
+    // Frames submitted by the producer and released by the consumer so far.
+    // Kept on separate cache lines, each is written by one thread only.
+    alignas(64) std::atomic<std::uint64_t> _submitted{0};
+    alignas(64) std::atomic<std::uint64_t> _released{0};
+    // Frame index owned by the producer and the consumer respectively.
+    alignas(64) std::uint64_t _writeIndex{0};
+    alignas(64) std::uint64_t _readIndex{0};
+};
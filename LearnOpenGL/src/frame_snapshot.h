@@ -0,0 +1,34 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frustum.h"
+
+// Everything the render thread needs to draw one frame. Written by the
+// simulation thread, then treated as immutable once it has been submitted.
+struct FrameSnapshot
+{
+    std::uint64_t index;
+    int framebufferWidth;
+    int framebufferHeight;
+    glm::vec4 clearColor;
+    // World matrix of every instance of the mesh. The slots are reused, so after
+    // the first frames filling it does not allocate.
+    std::vector<glm::mat4> instances;
+    // The first occluderCount instances are also rasterized as occluders to
+    // cull the others. Large objects close to the camera hide the most.
+    std::size_t occluderCount;
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    Frustum frustum;
+    glm::vec3 cameraPosition;
+    // Vertical field of view of the projection in degrees.
+    float fieldOfView;
+    // When the oldest input event the frame responds to arrived, the epoch if
+    // the frame responds to none.
+    std::chrono::steady_clock::time_point inputTime;
+};
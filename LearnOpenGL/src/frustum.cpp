@@ -0,0 +1,51 @@
+#include "frustum.h"
+
+bool Frustum::intersects(
+    const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::mat4& model
+) const
+{
+    // Bound the placed box by a world space box around its transformed center.
+    glm::vec3 center = glm::vec3(model * glm::vec4((boxMin + boxMax) * 0.5f, 1.0f));
+    glm::vec3 extent = (boxMax - boxMin) * 0.5f;
+    glm::mat3 absolute = glm::mat3(model);
+    for (int column = 0; column < 3; column++)
+    {
+        absolute[column] = glm::abs(absolute[column]);
+    }
+    extent = absolute * extent;
+    return intersects(center - extent, center + extent);
+}
+
+bool Frustum::intersects(const glm::vec3& worldMin, const glm::vec3& worldMax) const
+{
+    glm::vec3 center = (worldMin + worldMax) * 0.5f;
+    glm::vec3 extent = (worldMax - worldMin) * 0.5f;
+    for (const glm::vec4& plane : planes)
+    {
+        glm::vec3 normal(plane);
+        if (glm::dot(normal, center) + plane.w < -glm::dot(glm::abs(normal), extent))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Frustum extractFrustum(const glm::mat4& viewProjection)
+{
+    // Each plane is a sum or difference of the matrix rows (Gribb and Hartmann).
+    // Clip space depth is -w to w, so the near plane is the fourth row plus the third.
+    glm::mat4 rows = glm::transpose(viewProjection);
+    Frustum frustum{};
+    frustum.planes[Frustum::Left] = rows[3] + rows[0];
+    frustum.planes[Frustum::Right] = rows[3] - rows[0];
+    frustum.planes[Frustum::Bottom] = rows[3] + rows[1];
+    frustum.planes[Frustum::Top] = rows[3] - rows[1];
+    frustum.planes[Frustum::Near] = rows[3] + rows[2];
+    frustum.planes[Frustum::Far] = rows[3] - rows[2];
+    for (glm::vec4& plane : frustum.planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
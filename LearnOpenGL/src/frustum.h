@@ -0,0 +1,33 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+
+// The volume a camera sees, bounded by six planes. Each plane is stored as its
+// inward normal and distance, normalized so that plane equations give world
+// space distances.
+struct Frustum
+{
+    enum Plane
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount,
+    };
+
+    std::array<glm::vec4, PlaneCount> planes;
+
+    // Whether an object space box placed by the model matrix may be visible.
+    // Conservative: boxes near a frustum corner can pass without being inside.
+    bool intersects(
+        const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::mat4& model
+    ) const;
+    // The same test for a box already in world space, such as transformBounds gives.
+    bool intersects(const glm::vec3& worldMin, const glm::vec3& worldMax) const;
+};
+
+// Planes of the frustum seen through an OpenGL view projection matrix.
+Frustum extractFrustum(const glm::mat4& viewProjection);
@@ -0,0 +1,470 @@
+#include "gl_objects.h"
+#include <cstring>
+#include <utility>
+
+bool directStateAccess()
+{
+    return GLAD_GL_VERSION_4_5;
+}
+
+bool hasExtension(const char* name)
+{
+    GLint extensionCount{};
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; i++)
+    {
+        auto extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (std::strcmp(extension, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Buffer::Buffer() : _id{}
+{
+    if (directStateAccess())
+    {
+        glCreateBuffers(1, &_id);
+    }
+    else
+    {
+        glGenBuffers(1, &_id);
+    }
+}
+
+Buffer::~Buffer()
+{
+    glDeleteBuffers(1, &_id);
+}
+
+Buffer::Buffer(Buffer&& other) noexcept : _id{std::exchange(other._id, 0)}
+{
+}
+
+// Swapping hands the previous object to the moved-from wrapper, which deletes it.
+Buffer& Buffer::operator=(Buffer&& other) noexcept
+{
+    std::swap(_id, other._id);
+    return *this;
+}
+
+GLuint Buffer::id() const
+{
+    return _id;
+}
+
+void Buffer::storage(GLsizeiptr size, const void* data, GLbitfield flags)
+{
+    if (directStateAccess())
+    {
+        glNamedBufferStorage(_id, size, data, flags);
+        return;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+    if (GLAD_GL_VERSION_4_4)
+    {
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, data, flags);
+    }
+    else
+    {
+        GLenum usage = (flags & GL_DYNAMIC_STORAGE_BIT) != 0 ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+        glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage);
+    }
+}
+
+void Buffer::data(GLsizeiptr size, const void* data, GLenum usage)
+{
+    if (directStateAccess())
+    {
+        glNamedBufferData(_id, size, data, usage);
+        return;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+    glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage);
+}
+
+void Buffer::subData(GLintptr offset, GLsizeiptr size, const void* data)
+{
+    if (directStateAccess())
+    {
+        glNamedBufferSubData(_id, offset, size, data);
+        return;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+}
+
+void* Buffer::map(GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    if (directStateAccess())
+    {
+        return glMapNamedBufferRange(_id, offset, length, access);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+    return glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, length, access);
+}
+
+void Buffer::unmap()
+{
+    if (directStateAccess())
+    {
+        glUnmapNamedBuffer(_id);
+        return;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+}
+
+void Buffer::bind(GLenum target) const
+{
+    glBindBuffer(target, _id);
+}
+
+void Buffer::bindBase(GLenum target, GLuint index) const
+{
+    glBindBufferBase(target, index, _id);
+}
+
+VertexArray::VertexArray() : _id{}
+{
+    if (directStateAccess())
+    {
+        glCreateVertexArrays(1, &_id);
+    }
+    else
+    {
+        glGenVertexArrays(1, &_id);
+    }
+}
+
+VertexArray::~VertexArray()
+{
+    glDeleteVertexArrays(1, &_id);
+}
+
+VertexArray::VertexArray(VertexArray&& other) noexcept : _id{std::exchange(other._id, 0)}
+{
+}
+
+VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
+{
+    std::swap(_id, other._id);
+    return *this;
+}
+
+GLuint VertexArray::id() const
+{
+    return _id;
+}
+
+void VertexArray::vertexBuffer(
+    GLuint bindingIndex, const Buffer& buffer, GLintptr offset, GLsizei stride
+)
+{
+    if (directStateAccess())
+    {
+        glVertexArrayVertexBuffer(_id, bindingIndex, buffer.id(), offset, stride);
+        return;
+    }
+    glBindVertexArray(_id);
+    glBindVertexBuffer(bindingIndex, buffer.id(), offset, stride);
+}
+
+void VertexArray::elementBuffer(const Buffer& buffer)
+{
+    if (directStateAccess())
+    {
+        glVertexArrayElementBuffer(_id, buffer.id());
+        return;
+    }
+    glBindVertexArray(_id);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.id());
+}
+
+void VertexArray::attribute(
+    GLuint location,
+    GLuint bindingIndex,
+    GLint componentCount,
+    GLenum type,
+    GLboolean normalized,
+    GLuint relativeOffset
+)
+{
+    if (directStateAccess())
+    {
+        glVertexArrayAttribFormat(_id, location, componentCount, type, normalized, relativeOffset);
+        glVertexArrayAttribBinding(_id, location, bindingIndex);
+        glEnableVertexArrayAttrib(_id, location);
+        return;
+    }
+    glBindVertexArray(_id);
+    glVertexAttribFormat(location, componentCount, type, normalized, relativeOffset);
+    glVertexAttribBinding(location, bindingIndex);
+    glEnableVertexAttribArray(location);
+}
+
+void VertexArray::bind() const
+{
+    glBindVertexArray(_id);
+}
+
+Texture2D::Texture2D() : _id{}
+{
+    if (directStateAccess())
+    {
+        glCreateTextures(GL_TEXTURE_2D, 1, &_id);
+    }
+    else
+    {
+        glGenTextures(1, &_id);
+    }
+}
+
+Texture2D::~Texture2D()
+{
+    glDeleteTextures(1, &_id);
+}
+
+Texture2D::Texture2D(Texture2D&& other) noexcept : _id{std::exchange(other._id, 0)}
+{
+}
+
+Texture2D& Texture2D::operator=(Texture2D&& other) noexcept
+{
+    std::swap(_id, other._id);
+    return *this;
+}
+
+GLuint Texture2D::id() const
+{
+    return _id;
+}
+
+void Texture2D::storage(GLsizei levelCount, GLenum internalFormat, GLsizei width, GLsizei height)
+{
+    if (directStateAccess())
+    {
+        glTextureStorage2D(_id, levelCount, internalFormat, width, height);
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, _id);
+    glTexStorage2D(GL_TEXTURE_2D, levelCount, internalFormat, width, height);
+}
+
+void Texture2D::subImage(
+    GLint level,
+    GLint x,
+    GLint y,
+    GLsizei width,
+    GLsizei height,
+    GLenum format,
+    GLenum type,
+    const void* pixels
+)
+{
+    if (directStateAccess())
+    {
+        glTextureSubImage2D(_id, level, x, y, width, height, format, type, pixels);
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, _id);
+    glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, format, type, pixels);
+}
+
+void Texture2D::compressedSubImage(
+    GLint level,
+    GLint x,
+    GLint y,
+    GLsizei width,
+    GLsizei height,
+    GLenum format,
+    GLsizei size,
+    const void* data
+)
+{
+    if (directStateAccess())
+    {
+        glCompressedTextureSubImage2D(_id, level, x, y, width, height, format, size, data);
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, _id);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, format, size, data);
+}
+
+void Texture2D::parameter(GLenum name, GLint value)
+{
+    if (directStateAccess())
+    {
+        glTextureParameteri(_id, name, value);
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, _id);
+    glTexParameteri(GL_TEXTURE_2D, name, value);
+}
+
+void Texture2D::bind(GLuint unit) const
+{
+    if (directStateAccess())
+    {
+        glBindTextureUnit(unit, _id);
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, _id);
+}
+
+Sampler::Sampler() : _id{}
+{
+    if (directStateAccess())
+    {
+        glCreateSamplers(1, &_id);
+    }
+    else
+    {
+        glGenSamplers(1, &_id);
+    }
+}
+
+Sampler::~Sampler()
+{
+    glDeleteSamplers(1, &_id);
+}
+
+Sampler::Sampler(Sampler&& other) noexcept : _id{std::exchange(other._id, 0)}
+{
+}
+
+Sampler& Sampler::operator=(Sampler&& other) noexcept
+{
+    std::swap(_id, other._id);
+    return *this;
+}
+
+GLuint Sampler::id() const
+{
+    return _id;
+}
+
+void Sampler::parameter(GLenum name, GLint value)
+{
+    glSamplerParameteri(_id, name, value);
+}
+
+void Sampler::bind(GLuint unit) const
+{
+    glBindSampler(unit, _id);
+}
+
+Renderbuffer::Renderbuffer() : _id{}
+{
+    if (directStateAccess())
+    {
+        glCreateRenderbuffers(1, &_id);
+    }
+    else
+    {
+        glGenRenderbuffers(1, &_id);
+    }
+}
+
+Renderbuffer::~Renderbuffer()
+{
+    glDeleteRenderbuffers(1, &_id);
+}
+
+Renderbuffer::Renderbuffer(Renderbuffer&& other) noexcept : _id{std::exchange(other._id, 0)}
+{
+}
+
+Renderbuffer& Renderbuffer::operator=(Renderbuffer&& other) noexcept
+{
+    std::swap(_id, other._id);
+    return *this;
+}
+
+GLuint Renderbuffer::id() const
+{
+    return _id;
+}
+
+void Renderbuffer::storage(GLenum internalFormat, GLsizei width, GLsizei height)
+{
+    if (directStateAccess())
+    {
+        glNamedRenderbufferStorage(_id, internalFormat, width, height);
+        return;
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, _id);
+    glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+}
+
+Framebuffer::Framebuffer() : _id{}
+{
+    if (directStateAccess())
+    {
+        glCreateFramebuffers(1, &_id);
+    }
+    else
+    {
+        glGenFramebuffers(1, &_id);
+    }
+}
+
+Framebuffer::~Framebuffer()
+{
+    glDeleteFramebuffers(1, &_id);
+}
+
+Framebuffer::Framebuffer(Framebuffer&& other) noexcept : _id{std::exchange(other._id, 0)}
+{
+}
+
+Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept
+{
+    std::swap(_id, other._id);
+    return *this;
+}
+
+GLuint Framebuffer::id() const
+{
+    return _id;
+}
+
+void Framebuffer::attach(GLenum attachment, const Renderbuffer& renderbuffer)
+{
+    if (directStateAccess())
+    {
+        glNamedFramebufferRenderbuffer(_id, attachment, GL_RENDERBUFFER, renderbuffer.id());
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _id);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, renderbuffer.id());
+}
+
+void Framebuffer::attach(GLenum attachment, const Texture2D& texture, GLint level)
+{
+    if (directStateAccess())
+    {
+        glNamedFramebufferTexture(_id, attachment, texture.id(), level);
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _id);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture.id(), level);
+}
+
+GLenum Framebuffer::status() const
+{
+    if (directStateAccess())
+    {
+        return glCheckNamedFramebufferStatus(_id, GL_DRAW_FRAMEBUFFER);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _id);
+    return glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+}
+
+void Framebuffer::bind(GLenum target) const
+{
+    glBindFramebuffer(target, _id);
+}
@@ -0,0 +1,195 @@
+#pragma once
+#include <glad/glad.h>
+
+// Owning wrappers of OpenGL objects, movable like Shader.
+//
+// With OpenGL 4.5 objects are created and edited through direct state access,
+// which leaves every binding alone. On OpenGL 4.3 they fall back to binding the
+// object first: buffers to GL_COPY_WRITE_BUFFER, which nothing draws from, and
+// everything else to its own target, where it stays bound afterwards.
+//
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+
+// Whether the context supports direct state access. Valid once OpenGL is loaded.
+bool directStateAccess();
+// Whether the context advertises the extension, such as "GL_ARB_bindless_texture".
+bool hasExtension(const char* name);
+
+class Buffer
+{
+  public:
+    Buffer();
+    ~Buffer();
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    Buffer(Buffer&& other) noexcept;
+    Buffer& operator=(Buffer&& other) noexcept;
+
+    GLuint id() const;
+
+    // Immutable storage where available (OpenGL 4.4), so the driver knows how
+    // the data will change. Mutable storage of the matching usage otherwise.
+    void storage(GLsizeiptr size, const void* data, GLbitfield flags);
+    // Mutable storage, replaced by every call.
+    void data(GLsizeiptr size, const void* data, GLenum usage);
+    void subData(GLintptr offset, GLsizeiptr size, const void* data);
+    void* map(GLintptr offset, GLsizeiptr length, GLbitfield access);
+    void unmap();
+
+    void bind(GLenum target) const;
+    // Bind to an indexed target such as GL_SHADER_STORAGE_BUFFER.
+    void bindBase(GLenum target, GLuint index) const;
+
+  private:
+    GLuint _id;
+};
+
+// Vertex arrays are set up with separate attribute formats and buffer binding
+// points, so one vertex buffer can feed several attributes.
+class VertexArray
+{
+  public:
+    VertexArray();
+    ~VertexArray();
+
+    VertexArray(const VertexArray&) = delete;
+    VertexArray& operator=(const VertexArray&) = delete;
+
+    VertexArray(VertexArray&& other) noexcept;
+    VertexArray& operator=(VertexArray&& other) noexcept;
+
+    GLuint id() const;
+
+    void vertexBuffer(GLuint bindingIndex, const Buffer& buffer, GLintptr offset, GLsizei stride);
+    void elementBuffer(const Buffer& buffer);
+    // Enable the attribute, read from the given binding point as floats.
+    void attribute(
+        GLuint location,
+        GLuint bindingIndex,
+        GLint componentCount,
+        GLenum type,
+        GLboolean normalized,
+        GLuint relativeOffset
+    );
+
+    void bind() const;
+
+  private:
+    GLuint _id;
+};
+
+class Texture2D
+{
+  public:
+    Texture2D();
+    ~Texture2D();
+
+    Texture2D(const Texture2D&) = delete;
+    Texture2D& operator=(const Texture2D&) = delete;
+
+    Texture2D(Texture2D&& other) noexcept;
+    Texture2D& operator=(Texture2D&& other) noexcept;
+
+    GLuint id() const;
+
+    // Allocate immutable storage for the given number of mip levels.
+    void storage(GLsizei levelCount, GLenum internalFormat, GLsizei width, GLsizei height);
+    // Upload texels of a level, read from the bound pixel unpack buffer if there is one.
+    void subImage(
+        GLint level,
+        GLint x,
+        GLint y,
+        GLsizei width,
+        GLsizei height,
+        GLenum format,
+        GLenum type,
+        const void* pixels
+    );
+    void compressedSubImage(
+        GLint level,
+        GLint x,
+        GLint y,
+        GLsizei width,
+        GLsizei height,
+        GLenum format,
+        GLsizei size,
+        const void* data
+    );
+    void parameter(GLenum name, GLint value);
+
+    void bind(GLuint unit) const;
+
+  private:
+    GLuint _id;
+};
+
+// Sampling state kept apart from textures. Samplers never needed binding to
+// be edited, only their creation differs.
+class Sampler
+{
+  public:
+    Sampler();
+    ~Sampler();
+
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    Sampler(Sampler&& other) noexcept;
+    Sampler& operator=(Sampler&& other) noexcept;
+
+    GLuint id() const;
+
+    void parameter(GLenum name, GLint value);
+
+    void bind(GLuint unit) const;
+
+  private:
+    GLuint _id;
+};
+
+class Renderbuffer
+{
+  public:
+    Renderbuffer();
+    ~Renderbuffer();
+
+    Renderbuffer(const Renderbuffer&) = delete;
+    Renderbuffer& operator=(const Renderbuffer&) = delete;
+
+    Renderbuffer(Renderbuffer&& other) noexcept;
+    Renderbuffer& operator=(Renderbuffer&& other) noexcept;
+
+    GLuint id() const;
+
+    void storage(GLenum internalFormat, GLsizei width, GLsizei height);
+
+  private:
+    GLuint _id;
+};
+
+class Framebuffer
+{
+  public:
+    Framebuffer();
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    Framebuffer(Framebuffer&& other) noexcept;
+    Framebuffer& operator=(Framebuffer&& other) noexcept;
+
+    GLuint id() const;
+
+    void attach(GLenum attachment, const Renderbuffer& renderbuffer);
+    void attach(GLenum attachment, const Texture2D& texture, GLint level = 0);
+    // Completeness status for drawing, GL_FRAMEBUFFER_COMPLETE if it can be drawn to.
+    GLenum status() const;
+
+    void bind(GLenum target = GL_FRAMEBUFFER) const;
+
+  private:
+    GLuint _id;
+};
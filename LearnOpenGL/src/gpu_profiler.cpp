@@ -0,0 +1,155 @@
+#include "gpu_profiler.h"
+#include <algorithm>
+
+GpuProfiler::Scope::Scope(GpuProfiler& profiler, const char* name) : _profiler(profiler)
+{
+    _profiler.push(name);
+}
+
+GpuProfiler::Scope::~Scope()
+{
+    _profiler.pop();
+}
+
+GpuProfiler::GpuProfiler()
+    : _frames(),
+      _frameIndex{},
+      _droppedFrames{},
+      _openRecords(),
+      _openScopes(),
+      _scopeIds(),
+      _statistics(),
+      _samples()
+{
+    for (Frame& frame : _frames)
+    {
+        glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        frame.records.reserve(MaxScopesPerFrame);
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    for (Frame& frame : _frames)
+    {
+        glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+    }
+}
+
+void GpuProfiler::beginFrame()
+{
+    collect(_frames[_frameIndex % FrameLatency]);
+}
+
+void GpuProfiler::endFrame()
+{
+    while (!_openRecords.empty())
+    {
+        pop();
+    }
+    _frameIndex++;
+}
+
+const std::vector<GpuScopeStatistics>& GpuProfiler::statistics() const
+{
+    return _statistics;
+}
+
+std::uint64_t GpuProfiler::droppedFrames() const
+{
+    return _droppedFrames;
+}
+
+void GpuProfiler::push(const char* name)
+{
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+    std::size_t scope = scopeId(name);
+    _openScopes.push_back(scope);
+
+    Frame& frame = _frames[_frameIndex % FrameLatency];
+    std::size_t record = frame.records.size();
+    if (record == MaxScopesPerFrame)
+    {
+        _openRecords.push_back(NoScope);
+        return;
+    }
+    frame.records.push_back(
+        Record{scope, frame.queries[record * 2], frame.queries[record * 2 + 1]}
+    );
+    glQueryCounter(frame.records.back().beginQuery, GL_TIMESTAMP);
+    frame.lastQuery = frame.records.back().beginQuery;
+    _openRecords.push_back(record);
+}
+
+void GpuProfiler::pop()
+{
+    if (_openRecords.empty())
+    {
+        return;
+    }
+    std::size_t record = _openRecords.back();
+    _openRecords.pop_back();
+    _openScopes.pop_back();
+    if (record != NoScope)
+    {
+        Frame& frame = _frames[_frameIndex % FrameLatency];
+        glQueryCounter(frame.records[record].endQuery, GL_TIMESTAMP);
+        frame.lastQuery = frame.records[record].endQuery;
+    }
+    glPopDebugGroup();
+}
+
+std::size_t GpuProfiler::scopeId(const char* name)
+{
+    std::size_t parent = _openScopes.empty() ? NoScope : _openScopes.back();
+    std::string path = parent == NoScope ? name : _statistics[parent].path + '/' + name;
+    auto [entry, inserted] = _scopeIds.try_emplace(path, _statistics.size());
+    if (inserted)
+    {
+        _statistics.push_back(GpuScopeStatistics{path, _openScopes.size(), 0.0, 0.0});
+        _samples.push_back(Samples{});
+    }
+    return entry->second;
+}
+
+void GpuProfiler::collect(Frame& frame)
+{
+    if (frame.records.empty())
+    {
+        return;
+    }
+    // Queries complete in order, so the last one issued tells about all of them.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+        _droppedFrames++;
+        frame.records.clear();
+        return;
+    }
+
+    for (const Record& record : frame.records)
+    {
+        GLuint64 begin{};
+        GLuint64 end{};
+        glGetQueryObjectui64v(record.beginQuery, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(record.endQuery, GL_QUERY_RESULT, &end);
+        double milliseconds = static_cast<double>(end - begin) * 1e-6;
+
+        Samples& samples = _samples[record.scope];
+        std::size_t slot = samples.count % AverageFrameCount;
+        if (samples.count >= AverageFrameCount)
+        {
+            samples.sum -= samples.values[slot];
+        }
+        samples.values[slot] = milliseconds;
+        samples.sum += milliseconds;
+        samples.count++;
+
+        GpuScopeStatistics& statistics = _statistics[record.scope];
+        statistics.lastMilliseconds = milliseconds;
+        statistics.averageMilliseconds =
+            samples.sum / static_cast<double>(std::min(samples.count, AverageFrameCount));
+    }
+    frame.records.clear();
+}
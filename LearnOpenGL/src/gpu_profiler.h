@@ -0,0 +1,105 @@
+#pragma once
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Time spent by the GPU on a named scope and its children.
+struct GpuScopeStatistics
+{
+    // Names of the enclosing scopes and the scope's own, separated by '/'.
+    std::string path;
+    std::size_t depth;
+    double lastMilliseconds;
+    // Mean over the latest GpuProfiler::AverageFrameCount frames that had the scope.
+    double averageMilliseconds;
+};
+
+// Measures GPU time of nested scopes with timestamp queries, which unlike
+// GL_TIME_ELAPSED queries may nest. Every frame gets its own set of queries
+// from a ring and is read back FrameLatency frames later; if its results are
+// still not available then, the frame is dropped rather than waited for.
+// Scopes also open debug groups, so captures in graphics debuggers show them.
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+class GpuProfiler
+{
+  public:
+    static constexpr std::size_t FrameLatency = 4;
+    static constexpr std::size_t MaxScopesPerFrame = 64;
+    static constexpr std::size_t AverageFrameCount = 64;
+
+    // Measures the GPU commands issued during its lifetime.
+    class Scope
+    {
+      public:
+        Scope(GpuProfiler& profiler, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        GpuProfiler& _profiler;
+    };
+
+    GpuProfiler();
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // Collect the results of the frame FrameLatency frames ago and start a new one.
+    void beginFrame();
+    void endFrame();
+
+    // Every scope seen so far, parents before their children.
+    const std::vector<GpuScopeStatistics>& statistics() const;
+    // Frames whose results were not available in time and were skipped.
+    std::uint64_t droppedFrames() const;
+
+  private:
+    static constexpr std::size_t NoScope = SIZE_MAX;
+
+    struct Record
+    {
+        std::size_t scope;
+        GLuint beginQuery;
+        GLuint endQuery;
+    };
+
+    struct Frame
+    {
+        // Two timestamp queries per scope.
+        std::array<GLuint, MaxScopesPerFrame * 2> queries;
+        std::vector<Record> records;
+        // Query issued last. Scopes end in reverse order of their records, so
+        // it is usually not the last record's end query.
+        GLuint lastQuery;
+    };
+
+    struct Samples
+    {
+        std::array<double, AverageFrameCount> values;
+        std::size_t count;
+        double sum;
+    };
+
+    std::array<Frame, FrameLatency> _frames;
+    std::uint64_t _frameIndex;
+    std::uint64_t _droppedFrames;
+    // Open scopes, as indices into the current frame's records or NoScope once
+    // the frame ran out of queries.
+    std::vector<std::size_t> _openRecords;
+    std::vector<std::size_t> _openScopes;
+    std::unordered_map<std::string, std::size_t> _scopeIds;
+    std::vector<GpuScopeStatistics> _statistics;
+    std::vector<Samples> _samples;
+
+    void push(const char* name);
+    void pop();
+    std::size_t scopeId(const char* name);
+    void collect(Frame& frame);
+};
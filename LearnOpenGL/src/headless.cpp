@@ -0,0 +1,326 @@
+#include "headless.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <logging/logs.h>
+#include <assets/image.h>
+#include <assets/png.h>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+#include "cpu_profiler.h"
+#include "frame_capture.h"
+#include "frame_pacing.h"
+#include "gl_objects.h"
+#include "renderer.h"
+#include "timer.h"
+
+namespace
+{
+
+// Simulated time between two frames in seconds.
+constexpr double SimulationStep = 1.0 / 60.0;
+
+template <typename T>
+bool parseNumber(std::string_view text, T& value)
+{
+    const char* last = text.data() + text.size();
+    auto [end, error] = std::from_chars(text.data(), last, value);
+    return error == std::errc{} && end == last;
+}
+
+bool writeTimings(const std::string& path, const std::vector<double>& frameTimes)
+{
+    std::ofstream output(path, std::ios::trunc);
+    if (!output)
+    {
+        return false;
+    }
+    output << "frame,milliseconds\n";
+    for (std::size_t frame = 0; frame < frameTimes.size(); frame++)
+    {
+        output << std::format("{},{:.4f}\n", frame, frameTimes[frame]);
+    }
+    return static_cast<bool>(output);
+}
+
+bool writeImage(const std::string& path, int width, int height)
+{
+    assets::Image image{
+        static_cast<std::uint32_t>(width),
+        static_cast<std::uint32_t>(height),
+        std::vector<std::uint8_t>(std::size_t(width) * height * 4),
+    };
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
+    return assets::writePng(path, image);
+}
+
+// Render the frames into an offscreen framebuffer on the current context.
+int renderFrames(
+    const HeadlessOptions& options, ThreadPool& threadPool, const FrameSimulation& simulate
+)
+{
+    logging::info(std::format(
+        "Headless OpenGL {} on {}",
+        reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+        reinterpret_cast<const char*>(glGetString(GL_RENDERER))
+    ));
+
+    Renderbuffer colorBuffer{};
+    colorBuffer.storage(GL_RGBA8, options.width, options.height);
+    Renderbuffer depthBuffer{};
+    depthBuffer.storage(GL_DEPTH24_STENCIL8, options.width, options.height);
+    Framebuffer framebuffer{};
+    framebuffer.attach(GL_COLOR_ATTACHMENT0, colorBuffer);
+    framebuffer.attach(GL_DEPTH_STENCIL_ATTACHMENT, depthBuffer);
+    framebuffer.bind();
+
+    int result = 0;
+    if (framebuffer.status() != GL_FRAMEBUFFER_COMPLETE)
+    {
+        logging::error("Offscreen framebuffer is incomplete");
+        result = 1;
+    }
+    else
+    {
+        Renderer renderer(threadPool, (GLADloadproc)glfwGetProcAddress);
+        FrameSnapshot frame{};
+        std::vector<double> frameTimes;
+        std::optional<FrameCapture> capture;
+        if (!options.capturePath.empty())
+        {
+            bool sequence = options.capturePath.find("{}") != std::string::npos;
+            capture.emplace(
+                threadPool,
+                options.capturePath,
+                sequence ? CaptureFormat::Png : CaptureFormat::RawVideo
+            );
+        }
+        FrameLimiter limiter(options.pacing.targetFrameRate);
+        FrameFences fences(options.pacing.maxFramesInFlight);
+        // Frame times are the intervals between finished frames.
+        Timer frameTimer{};
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [&] {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+        for (std::uint64_t index = 0;
+             (options.frameCount == 0 || index < options.frameCount) &&
+             (options.duration <= 0.0 || elapsed() < options.duration);
+             index++)
+        {
+            frame.index = index;
+            frame.framebufferWidth = options.width;
+            frame.framebufferHeight = options.height;
+            simulate(frame, static_cast<double>(index) * SimulationStep);
+            renderer.render(frame);
+            if (capture)
+            {
+                capture->capture(framebuffer.id(), options.width, options.height, index);
+            }
+            // Without a swap nothing paces the frames, so the limiter and the
+            // fences do. With one frame in flight every frame is waited for.
+            limiter.wait();
+            fences.endFrame();
+            frameTimer.update();
+            frameTimes.push_back(
+                std::chrono::duration<double, std::milli>(frameTimer.delta()).count()
+            );
+        }
+
+        if (!frameTimes.empty())
+        {
+            logging::info(std::format(
+                "{}x{} in {:.2f} s, {}",
+                options.width,
+                options.height,
+                elapsed(),
+                formatFrameTimes(frameTimeStatistics(frameTimes))
+            ));
+            for (const GpuScopeStatistics& scope : renderer.gpuProfiler().statistics())
+            {
+                logging::info(
+                    std::format("GPU {}: mean {:.3f} ms", scope.path, scope.averageMilliseconds)
+                );
+            }
+            renderer.logCulling();
+            renderer.logResourceMemory();
+        }
+        if (capture && !capture->finish())
+        {
+            result = 1;
+        }
+        if (!options.timingsPath.empty() && !writeTimings(options.timingsPath, frameTimes))
+        {
+            logging::error(std::format("Failed to write {}", options.timingsPath));
+            result = 1;
+        }
+        if (!options.imagePath.empty() &&
+            !writeImage(options.imagePath, options.width, options.height))
+        {
+            logging::error(std::format("Failed to write {}", options.imagePath));
+            result = 1;
+        }
+        if (!options.tracePath.empty() && !profiling::writeChromeTrace(options.tracePath))
+        {
+            result = 1;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return result;
+}
+
+}
+
+bool parseHeadlessOptions(std::span<const std::string_view> arguments, HeadlessOptions& options)
+{
+    for (std::string_view argument : arguments)
+    {
+        std::size_t separator = argument.find('=');
+        std::string_view name = argument.substr(0, separator);
+        std::string_view value;
+        if (separator != std::string_view::npos)
+        {
+            value = argument.substr(separator + 1);
+        }
+        bool valid = !value.empty();
+        if (name == "--context")
+        {
+            if (value == "egl")
+            {
+                options.context = HeadlessContext::Egl;
+            }
+            else if (value == "osmesa")
+            {
+                options.context = HeadlessContext::OSMesa;
+            }
+            else if (value == "hidden")
+            {
+                options.context = HeadlessContext::HiddenWindow;
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+        else if (name == "--size")
+        {
+            std::size_t cross = value.find('x');
+            valid = cross != std::string_view::npos &&
+                    parseNumber(value.substr(0, cross), options.width) &&
+                    parseNumber(value.substr(cross + 1), options.height) && options.width > 0 &&
+                    options.height > 0;
+        }
+        else if (name == "--frames")
+        {
+            valid = parseNumber(value, options.frameCount);
+        }
+        else if (name == "--duration")
+        {
+            valid = parseNumber(value, options.duration);
+        }
+        else if (name == "--timings")
+        {
+            options.timingsPath = value;
+        }
+        else if (name == "--image")
+        {
+            options.imagePath = value;
+        }
+        else if (name == "--capture")
+        {
+            options.capturePath = value;
+        }
+        else if (name == "--trace")
+        {
+            options.tracePath = value;
+            if (!profiling::Enabled)
+            {
+                logging::error("Cannot trace, built without PROFILER_ENABLED");
+                valid = false;
+            }
+        }
+        else
+        {
+            valid = parseFramePacingOption(name, value, options.pacing);
+        }
+        if (!valid)
+        {
+            logging::error(std::format("Invalid headless option {}", argument));
+            return false;
+        }
+    }
+    if (options.frameCount == 0 && options.duration <= 0.0)
+    {
+        options.frameCount = HeadlessOptions::DefaultFrameCount;
+    }
+    return true;
+}
+
+int runHeadless(
+    const HeadlessOptions& options, ThreadPool& threadPool, const FrameSimulation& simulate
+)
+{
+    if (!options.tracePath.empty())
+    {
+        profiling::startRecording();
+    }
+    bool nullPlatform = options.context != HeadlessContext::HiddenWindow;
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+    // The null platform needs no display; its contexts come from EGL or OSMesa.
+    if (nullPlatform)
+    {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+#else
+    if (nullPlatform)
+    {
+        logging::error("EGL and OSMesa contexts need GLFW 3.4, use --context=hidden");
+        return 1;
+    }
+#endif
+    if (!glfwInit())
+    {
+        logging::error("Failed to initialize GLFW");
+        return 1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (nullPlatform)
+    {
+        glfwWindowHint(
+            GLFW_CONTEXT_CREATION_API,
+            options.context == HeadlessContext::Egl ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API
+        );
+    }
+    GLFWwindow* window =
+        glfwCreateWindow(options.width, options.height, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        logging::error("Failed to create a headless OpenGL 4.3 context");
+        glfwTerminate();
+        return 1;
+    }
+
+    glfwMakeContextCurrent(window);
+    int result = 1;
+    if (gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        result = renderFrames(options, threadPool, simulate);
+    }
+    else
+    {
+        logging::error("Error: Failed to initialize GLAD");
+    }
+    glfwMakeContextCurrent(nullptr);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return result;
+}
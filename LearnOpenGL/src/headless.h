@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "frame_pacing.h"
+#include "frame_snapshot.h"
+#include "thread_pool.h"
+
+enum class HeadlessContext
+{
+    // Surfaceless EGL, through GLFW's null platform.
+    Egl,
+    // Mesa's software rasterizer, through GLFW's null platform.
+    OSMesa,
+    // An invisible window of the native platform, for machines that have a display.
+    HiddenWindow,
+};
+
+struct HeadlessOptions
+{
+    static constexpr std::uint64_t DefaultFrameCount = 300;
+
+    HeadlessContext context = HeadlessContext::Egl;
+    int width = 800;
+    int height = 600;
+    // Stop after this many frames or once this many seconds have passed,
+    // whichever comes first. Zero disables a limit.
+    std::uint64_t frameCount = 0;
+    double duration = 0.0;
+    // CSV file receiving the time of every frame, written if not empty.
+    std::string timingsPath;
+    // PNG file receiving the last frame, written if not empty.
+    std::string imagePath;
+    // Capture every frame, as numbered PNG files if the path contains "{}" and
+    // as a raw video stream otherwise.
+    std::string capturePath;
+    // Chrome trace of the instrumented CPU zones, written if not empty.
+    std::string tracePath;
+    // Vsync and low latency do not apply without a window.
+    FramePacingOptions pacing;
+};
+
+// Parse the options following --headless:
+//   --context=egl|osmesa|hidden  --size=<width>x<height>  --frames=<count>
+//   --duration=<seconds>  --timings=<file.csv>  --image=<file.png>
+//   --capture=<frame_{}.png|file.rgba>  --trace=<file.json>  --fps=<rate>
+//   --frames-in-flight=<count>
+// Without a frame count or duration, DefaultFrameCount frames are rendered.
+// --trace is invalid in builds without PROFILER_ENABLED. Returns false after
+// logging the first invalid option.
+bool parseHeadlessOptions(std::span<const std::string_view> arguments, HeadlessOptions& options);
+
+// Fills a frame snapshot for the given simulation time in seconds. The
+// framebuffer size of the snapshot is already set.
+using FrameSimulation = std::function<void(FrameSnapshot& frame, double time)>;
+
+// Render without a visible window: create an OpenGL 4.3 core context that
+// needs no display, draw every frame into an offscreen framebuffer of the
+// requested size and report the frame times. Frames advance the simulation by
+// a fixed step so that captured images do not depend on the machine's speed.
+// Returns the process exit code.
+int runHeadless(
+    const HeadlessOptions& options, ThreadPool& threadPool, const FrameSimulation& simulate
+);
@@ -0,0 +1,63 @@
+#include "lod_selector.h"
+#include <algorithm>
+#include <cmath>
+
+LodSelector::LodSelector(float pixelThreshold, float hysteresis)
+    : _pixelThreshold{pixelThreshold},
+      _hysteresis{hysteresis},
+      _lod{}
+{
+}
+
+std::size_t LodSelector::select(
+    const Mesh& mesh,
+    const glm::mat4& model,
+    const glm::vec3& cameraPosition,
+    float fieldOfView,
+    int viewportHeight
+)
+{
+    const auto& lods = mesh.lods();
+    if (lods.empty())
+    {
+        _lod = 0;
+        return _lod;
+    }
+
+    // Bounding sphere of the mesh in world space, scaled by the largest axis of the model.
+    float scale = std::max({
+        glm::length(glm::vec3(model[0])),
+        glm::length(glm::vec3(model[1])),
+        glm::length(glm::vec3(model[2])),
+    });
+    glm::vec3 localCenter = (mesh.boundsMin() + mesh.boundsMax()) * 0.5f;
+    glm::vec3 center = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+    float radius = glm::length(mesh.boundsMax() - mesh.boundsMin()) * 0.5f * scale;
+    // Inside the sphere the nearest surface may touch the camera; clamp to keep the error finite.
+    float distance = std::max(glm::length(center - cameraPosition) - radius, 1e-3f);
+
+    // Pixels covered by one world unit at that distance.
+    float pixelsPerUnit =
+        static_cast<float>(viewportHeight) /
+        (2.0f * distance * std::tan(glm::radians(fieldOfView) * 0.5f));
+    auto screenError = [&](std::size_t lod) {
+        return lods[lod].error * scale * pixelsPerUnit;
+    };
+
+    _lod = std::min(_lod, lods.size() - 1);
+    while (_lod > 0 && screenError(_lod) > _pixelThreshold * (1.0f + _hysteresis))
+    {
+        _lod--;
+    }
+    while (_lod + 1 < lods.size() &&
+           screenError(_lod + 1) < _pixelThreshold * (1.0f - _hysteresis))
+    {
+        _lod++;
+    }
+    return _lod;
+}
+
+std::size_t LodSelector::lod() const
+{
+    return _lod;
+}
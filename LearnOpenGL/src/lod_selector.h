@@ -0,0 +1,38 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#include "mesh.h"
+
+// Picks the level of detail of one object from the screen-space size of each
+// level's simplification error, an estimate of its deviation from the full
+// detail surface (see assets::MeshLod::error). A level is good enough while its error covers
+// at most the pixel threshold. To avoid popping back and forth near a switching
+// distance, the error has to pass the threshold by the hysteresis fraction
+// before the level changes.
+class LodSelector
+{
+  public:
+    static constexpr float DefaultPixelThreshold = 1.0f;
+    static constexpr float DefaultHysteresis = 0.25f;
+
+    explicit LodSelector(
+        float pixelThreshold = DefaultPixelThreshold, float hysteresis = DefaultHysteresis
+    );
+
+    // Update and return the level for the mesh drawn with the given model matrix,
+    // seen from a camera with a vertical field of view in degrees.
+    std::size_t select(
+        const Mesh& mesh,
+        const glm::mat4& model,
+        const glm::vec3& cameraPosition,
+        float fieldOfView,
+        int viewportHeight
+    );
+    std::size_t lod() const;
+
+  private:
+    float _pixelThreshold;
+    float _hysteresis;
+    std::size_t _lod;
+};
@@ -10,49 +10,184 @@
 #include <logging/severity.h>
 #include <logging/sinks.h>
 
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <format>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "bench_transforms.h"
 #include "timer.h"
 #include "camera.h"
-#include "shader.h"
+#include "cpu_profiler.h"
+#include "fixed_timestep.h"
+#include "frame_pacing.h"
+#include "frame_pipeline.h"
+#include "headless.h"
+#include "render_thread.h"
+#include "scene_graph.h"
+#include "thread_pool.h"
 
 constexpr unsigned int DEFAULT_WIDTH = 800;
 constexpr unsigned int DEFAULT_HEIGHT = 600;
+// Longest wait for events when rendering on demand, so the loop still checks in
+// with the timers now and then.
+constexpr double IDLE_TIMEOUT = 0.5;
 
+int framebufferWidth = DEFAULT_WIDTH;
+int framebufferHeight = DEFAULT_HEIGHT;
 bool mousePressed = false;
+// Set when the framebuffer changed size and needs drawing again.
+bool framebufferResized = false;
+// Whether the cube spins, toggled with space.
+bool animating = true;
 double lastMouseX = 0.0;
 double lastMouseY = 0.0;
+// When the oldest input event not yet sampled by a frame was delivered, the
+// epoch if there is none. GLFW gives no event times, so latencies are measured
+// from the poll that delivered the event.
+std::chrono::steady_clock::time_point inputTime{};
 
 Camera camera(
     glm::vec3(0.0f, 0.0f, 3.0f), Camera::DefaultWorldUp, Camera::DefaultYaw, Camera::DefaultPitch,
     Camera::DefaultFieldOfView
 );
 
+SceneGraph scene{};
+// The spinning cube and the wall behind it come first, as they are the
+// occluders of every frame.
+SceneGraph::Node cubeNode = scene.addNode(SceneGraph::NoParent);
+SceneGraph::Node wallNode = scene.addNode(
+    SceneGraph::NoParent, glm::vec3(0.0f, 0.0f, -4.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+    glm::vec3(6.0f, 4.0f, 0.5f)
+);
+constexpr std::size_t OCCLUDER_COUNT = 2;
+
 void framebufferSizeCallback(GLFWwindow* window, int width, int height);
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int modifiers);
 void cursorPosCallback(GLFWwindow* window, double xPosition, double yPosition);
 void scrollCallback(GLFWwindow* window, double xOffset, double yOffset);
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int modifiers);
+void noteInput();
 
-void processInput(GLFWwindow* window, const Timer& timer);
+// State advanced in fixed simulation ticks. Frames render an interpolation of
+// the last two states, so the simulation does not depend on the frame rate.
+struct SimulationState
+{
+    glm::vec3 cameraPosition;
+    double time;
+};
+
+// Fill the space behind the wall with cubes, which occlusion culling keeps
+// from being drawn until the camera moves around the wall.
+void addHiddenCubes();
+// Direction the camera is asked to move in by the keys held down.
+glm::vec3 processInput(GLFWwindow* window);
+void addHiddenCubes()
+{
+    for (int row = 0; row < 4; row++)
+    {
+        for (int column = 0; column < 5; column++)
+        {
+            scene.addNode(
+                SceneGraph::NoParent,
+                glm::vec3(static_cast<float>(column) - 2.0f, static_cast<float>(row) - 1.5f, -8.0f),
+                glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                glm::vec3(0.5f)
+            );
+        }
+    }
+    scene.update();
+}
 
-void APIENTRY glLogDebugInfo(
-    GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message,
-    const void* userParam
-);
+void simulateTick(SimulationState& state, const glm::vec3& cameraMovement, double step);
+// Pose the scene at the given time.
+void animate(double time);
+// Fill the frame from the posed scene and the camera.
+void snapshotFrame(FrameSnapshot& frame);
+void simulateFrame(FrameSnapshot& frame, double time);
 
-int main()
+int main(int argc, char* argv[])
 {
-#ifdef _DEBUG
     auto& logger = logging::Logger::Instance();
     logging::ConsoleSink consoleSink{};
+#ifdef _DEBUG
     logging::FileSink fileSink{"debug.log"};
     logger.addSink(logging::Severity::Debug, &consoleSink);
     logger.addSink(logging::Severity::Debug, &fileSink);
 #endif
 
+    PROFILER_THREAD_NAME("Main");
+    addHiddenCubes();
+
+    std::vector<std::string_view> arguments(argv + 1, argv + argc);
+    if (!arguments.empty())
+    {
+#ifndef _DEBUG
+        // Command line options report on the console.
+        logger.addSink(logging::Severity::Info, &consoleSink);
+#endif
+        std::span<const std::string_view> options = std::span(arguments).subspan(1);
+        if (arguments[0] == "--bench-transforms")
+        {
+            return benchTransforms(options);
+        }
+        if (arguments[0] == "--headless")
+        {
+            HeadlessOptions headlessOptions{};
+            if (!parseHeadlessOptions(options, headlessOptions))
+            {
+                return 1;
+            }
+            ThreadPool threadPool{};
+            return runHeadless(headlessOptions, threadPool, simulateFrame);
+        }
+    }
+
+    // The interactive mode takes frame pacing options and the Chrome trace
+    // written on exit.
+    FramePacingOptions pacing{};
+    std::string tracePath;
+    for (std::string_view argument : arguments)
+    {
+        std::size_t separator = argument.find('=');
+        std::string_view name = argument.substr(0, separator);
+        std::string_view value;
+        if (separator != std::string_view::npos)
+        {
+            value = argument.substr(separator + 1);
+        }
+        if (name == "--trace" && !profiling::Enabled)
+        {
+            logging::error("Cannot trace, built without PROFILER_ENABLED");
+            return 1;
+        }
+        if (name == "--trace" && !value.empty())
+        {
+            tracePath = value;
+        }
+        else if (!parseFramePacingOption(name, value, pacing))
+        {
+            logging::error(std::format(
+                "Invalid option {}, expected --vsync=off|on|adaptive, --fps=<rate>, "
+                "--frames-in-flight=<count>, --low-latency, --on-demand, --trace=<file.json>, "
+                "--headless [options] or --bench-transforms [counts]",
+                argument
+            ));
+            return 1;
+        }
+    }
+    if (!tracePath.empty())
+    {
+        profiling::startRecording();
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -68,184 +203,134 @@ int main()
         glfwTerminate();
         return -1;
     }
-    glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     glfwSetCursorPosCallback(window, cursorPosCallback);
     glfwSetScrollCallback(window, scrollCallback);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    glfwSetKeyCallback(window, keyCallback);
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+
+    // The render thread takes over the window's context; input, timing and
+    // simulation stay on this thread and run one frame ahead of rendering.
+    ThreadPool threadPool{};
+    FramePipeline pipeline{};
+    RenderThread renderThread(window, pipeline, threadPool, pacing);
+    if (!renderThread.start())
     {
-        logging::error("Error: Failed to initialize GLAD");
+        renderThread.join();
+        glfwDestroyWindow(window);
         glfwTerminate();
         return -1;
     }
 
-#ifdef _DEBUG
-    GLint contextFlags{};
-    glGetIntegerv(GL_CONTEXT_FLAGS, &contextFlags);
-    if (contextFlags & GL_CONTEXT_FLAG_DEBUG_BIT)
-    {
-        glEnable(GL_DEBUG_OUTPUT);
-        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-        glDebugMessageCallback(glLogDebugInfo, nullptr);
-        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
-    }
-#endif
-
-    glEnable(GL_DEPTH_TEST);
-
-    Shader shader("res/main.vert.glsl", "res/main.frag.glsl");
-
-    // Vertex data layout
-    // +-----------------+-----------------------------+
-    // | Position (vec3) |  Texture coordinates (vec2) |
-    // +-----------------+-----------------------------+
-    // clang-format off
-    GLfloat vertices[] = {
-        -0.5f,  0.5f, -0.5f,   0.0f, 1.0f,
-        -0.5f, -0.5f, -0.5f,   0.0f, 0.0f,
-         0.5f, -0.5f, -0.5f,   1.0f, 0.0f,
-         0.5f,  0.5f, -0.5f,   1.0f, 1.0f,
-
-         0.5f,  0.5f,  0.5f,   0.0f, 1.0f,
-         0.5f, -0.5f,  0.5f,   0.0f, 0.0f,
-        -0.5f, -0.5f,  0.5f,   1.0f, 0.0f,
-        -0.5f,  0.5f,  0.5f,   1.0f, 1.0f,
-
-        -0.5f,  0.5f,  0.5f,   0.0f, 1.0f,
-        -0.5f, -0.5f,  0.5f,   0.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f,   1.0f, 0.0f,
-        -0.5f,  0.5f, -0.5f,   1.0f, 1.0f,
-
-         0.5f,  0.5f, -0.5f,   0.0f, 1.0f,
-         0.5f, -0.5f, -0.5f,   0.0f, 0.0f,
-         0.5f, -0.5f,  0.5f,   1.0f, 0.0f,
-         0.5f,  0.5f,  0.5f,   1.0f, 1.0f,
-
-        -0.5f,  0.5f,  0.5f,   0.0f, 1.0f,
-        -0.5f,  0.5f, -0.5f,   0.0f, 0.0f,
-         0.5f,  0.5f, -0.5f,   1.0f, 0.0f,
-         0.5f,  0.5f,  0.5f,   1.0f, 1.0f,
-
-         0.5f, -0.5f,  0.5f,   0.0f, 1.0f,
-         0.5f, -0.5f, -0.5f,   0.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f,   1.0f, 0.0f,
-        -0.5f, -0.5f,  0.5f,   1.0f, 1.0f,
-    };
-    GLuint indices[] = {
-        0, 1, 2,
-        2, 3, 0,
-
-        4, 5, 6,
-        6, 7, 4,
-
-        8, 9, 10,
-        10, 11, 8,
-        
-        12, 13, 14,
-        14, 15, 12,
-
-        16, 17, 18,
-        18, 19, 16,
-
-        20, 21, 22,
-        22, 23, 20,
-    };
-    // clang-format on
-
-    GLuint VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(
-        1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat))
-    );
-    glEnableVertexAttribArray(1);
-
-    int width, height, colorChannelCount;
-    stbi_set_flip_vertically_on_load(1);
-    auto data = stbi_load("res/container.jpg", &width, &height, &colorChannelCount, 0);
-
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    if (data != nullptr)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        logging::error("Error: Failed to load texture");
-    }
-
-    stbi_image_free(data);
-
     Timer timer{};
+    FixedTimestep timestep{};
+    SimulationState previousState{camera.position(), 0.0};
+    SimulationState state = previousState;
+    // What the last submitted frame showed, to tell on demand whether anything
+    // changed since. The scene time is negative until the scene is first posed.
+    std::uint64_t drawnCameraVersion = 0;
+    std::uint64_t drawnSceneVersion = 0;
+    double sceneTime = -1.0;
+    bool drawn = false;
 
     while (!glfwWindowShouldClose(window))
     {
-        processInput(window, timer);
-
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Low latency mode samples input only once the previous frame is done,
+        // so that nothing queues between sampling and display.
+        if (pacing.lowLatency)
+        {
+            if (!pipeline.waitForIdle())
+            {
+                break;
+            }
+            glfwPollEvents();
+        }
+        glm::vec3 cameraMovement = processInput(window);
 
         timer.update();
+        for (std::uint32_t ticks = timestep.advance(timer.delta()); ticks > 0; ticks--)
+        {
+            previousState = state;
+            simulateTick(state, cameraMovement, timestep.tickSeconds());
+        }
 
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::rotate(model, timer.time() * glm::radians(50.0f), glm::vec3(0.5f, 1.0f, 0.0f));
-        glm::mat4 view = camera.getViewMatrix();
-        glm::mat4 projection = glm::perspective(
-            glm::radians(camera.fieldOfView()),
-            static_cast<float>(DEFAULT_WIDTH) / static_cast<float>(DEFAULT_HEIGHT),
-            0.1f,
-            100.0f
-        );
-        shader.use();
-        shader.setUniformMat4("model", model);
-        shader.setUniformMat4("view", view);
-        shader.setUniformMat4("projection", projection);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, sizeof(indices) / sizeof(GLuint), GL_UNSIGNED_INT, 0);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // Frames show the simulation up to a tick late, between its last two states.
+        double alpha = timestep.alpha();
+        camera.position(glm::mix(
+            previousState.cameraPosition, state.cameraPosition, static_cast<float>(alpha)
+        ));
+        double time = previousState.time + (state.time - previousState.time) * alpha;
+        if (time != sceneTime)
+        {
+            animate(time);
+            sceneTime = time;
+        }
+
+        // On demand, a frame is only drawn when it would differ from the last:
+        // the camera or scene changed, the window resized, input arrived that
+        // should be timed, or the last frame still waited on loading resources.
+        // Held movement keys keep the loop awake for the ticks that move the camera.
+        bool redrawRequested = renderThread.consumeRedrawRequest();
+        if (pacing.onDemand && drawn && cameraMovement == glm::vec3{} &&
+            camera.version() == drawnCameraVersion && scene.version() == drawnSceneVersion &&
+            !framebufferResized && !redrawRequested &&
+            inputTime == std::chrono::steady_clock::time_point{})
+        {
+            glfwWaitEventsTimeout(IDLE_TIMEOUT);
+            // The time spent waiting was idle, not simulation to catch up on
+            // or a frame time.
+            timer.restart();
+            continue;
+        }
+
+        FrameSnapshot* frame = pipeline.beginFrame();
+        if (frame == nullptr)
+        {
+            break;
+        }
+        frame->framebufferWidth = framebufferWidth;
+        frame->framebufferHeight = framebufferHeight;
+        frame->inputTime = std::exchange(inputTime, {});
+        snapshotFrame(*frame);
+        pipeline.submitFrame();
+        drawnCameraVersion = camera.version();
+        drawnSceneVersion = scene.version();
+        framebufferResized = false;
+        drawn = true;
+
+        if (!pacing.lowLatency)
+        {
+            glfwPollEvents();
+        }
     }
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    pipeline.close();
+    renderThread.join();
+
+    logging::info(std::format("Simulation, last {}", formatFrameTimes(timer.statistics())));
 
     glfwDestroyWindow(window);
     glfwTerminate();
+    if (!tracePath.empty() && !profiling::writeChromeTrace(tracePath))
+    {
+        return 1;
+    }
     return 0;
 }
 
 void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+    framebufferWidth = width;
+    framebufferHeight = height;
+    framebufferResized = true;
 }
 
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int modifiers)
 {
     if (button == GLFW_MOUSE_BUTTON_LEFT)
     {
+        noteInput();
         if (action == GLFW_PRESS)
         {
             mousePressed = true;
@@ -261,6 +346,7 @@ void cursorPosCallback(GLFWwindow* window, double xPosition, double yPosition)
 {
     if (mousePressed)
     {
+        noteInput();
         float deltaX = static_cast<float>(lastMouseX - xPosition);
         float deltaY = static_cast<float>(yPosition - lastMouseY);
         deltaX *= camera.Sensitivity;
@@ -273,124 +359,104 @@ void cursorPosCallback(GLFWwindow* window, double xPosition, double yPosition)
 
 void scrollCallback(GLFWwindow* window, double xOffset, double yOffset)
 {
+    noteInput();
     camera.fieldOfView(camera.fieldOfView() - static_cast<float>(yOffset));
 }
 
-void processInput(GLFWwindow* window, const Timer& timer)
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int modifiers)
 {
+    // Held keys are sampled by processInput; only presses and releases are new input.
+    if (action != GLFW_REPEAT)
+    {
+        noteInput();
+    }
+    if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
+    {
+        animating = !animating;
+    }
+}
+
+void noteInput()
+{
+    if (inputTime == std::chrono::steady_clock::time_point{})
+    {
+        inputTime = std::chrono::steady_clock::now();
+    }
+}
+
+glm::vec3 processInput(GLFWwindow* window)
+{
+    ZONE("processInput");
+    glm::vec3 cameraMovement{};
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
     {
         glfwSetWindowShouldClose(window, 1);
-        return;
+        return cameraMovement;
     }
-    glm::vec3 cameraTranslation{};
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
     {
-        cameraTranslation += camera.front();
+        cameraMovement += camera.front();
     }
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
     {
-        cameraTranslation -= camera.front();
+        cameraMovement -= camera.front();
     }
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
     {
-        cameraTranslation -= camera.right();
+        cameraMovement -= camera.right();
     }
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
     {
-        cameraTranslation += camera.right();
-    }
-    if (cameraTranslation.x || cameraTranslation.y || cameraTranslation.z)
-    {
-        camera.translate(cameraTranslation * camera.Speed * timer.deltaTime());
+        cameraMovement += camera.right();
     }
+    return cameraMovement;
 }
 
-void APIENTRY glLogDebugInfo(
-    GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message,
-    const void* userParam
-)
+void simulateTick(SimulationState& state, const glm::vec3& cameraMovement, double step)
 {
-    std::stringstream debugInfo{};
-
-    switch (source)
+    ZONE("simulateTick");
+    state.cameraPosition += cameraMovement * Camera::Speed * static_cast<float>(step);
+    if (animating)
     {
-    case GL_DEBUG_SOURCE_API:
-        debugInfo << "[GL::Source::API]";
-        break;
-    case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
-        debugInfo << "[GL::Source::WindowSystem]";
-        break;
-    case GL_DEBUG_SOURCE_SHADER_COMPILER:
-        debugInfo << "[GL::Source::ShaderCompiler]";
-        break;
-    case GL_DEBUG_SOURCE_THIRD_PARTY:
-        debugInfo << "[GL::Source::ThirdParty]";
-        break;
-    case GL_DEBUG_SOURCE_APPLICATION:
-        debugInfo << "[GL::Source::Application]";
-        break;
-    case GL_DEBUG_SOURCE_OTHER:
-        debugInfo << "[GL::Source::Other]";
-        break;
-    default:
-        debugInfo << std::format("[GL::Source::Unkown({})]", source);
-        break;
+        state.time += step;
     }
+}
 
-    switch (type)
-    {
-    case GL_DEBUG_TYPE_ERROR:
-        debugInfo << "[GL::Type::Error]";
-        break;
-    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
-        debugInfo << "[GL::Type::DeprecatedBehavior]";
-        break;
-    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
-        debugInfo << "[GL::Type::UndefinedBehavior]";
-        break;
-    case GL_DEBUG_TYPE_PORTABILITY:
-        debugInfo << "[GL::Type::Portability]";
-        break;
-    case GL_DEBUG_TYPE_PERFORMANCE:
-        debugInfo << "[GL::Type::Performance]";
-        break;
-    case GL_DEBUG_TYPE_MARKER:
-        debugInfo << "[GL::Type::Marker]";
-        break;
-    case GL_DEBUG_TYPE_PUSH_GROUP:
-        debugInfo << "[GL::Type::PushGroup]";
-        break;
-    case GL_DEBUG_TYPE_POP_GROUP:
-        debugInfo << "[GL::Type::PopGroup]";
-        break;
-    case GL_DEBUG_TYPE_OTHER:
-        debugInfo << "[GL::Type::Other]";
-        break;
-    default:
-        debugInfo << std::format("[GL::Type::Unknown({})]", type);
-        break;
-    }
+void animate(double time)
+{
+    ZONE("animate");
+    // Wrap the angle in double precision so a float never holds a large time.
+    auto angle = static_cast<float>(std::fmod(time * 50.0, 360.0));
+    scene.setRotation(
+        cubeNode, glm::angleAxis(glm::radians(angle), glm::normalize(glm::vec3(0.5f, 1.0f, 0.0f)))
+    );
+    scene.update();
+}
 
-    switch (severity)
+void snapshotFrame(FrameSnapshot& frame)
+{
+    ZONE("snapshotFrame");
+    frame.clearColor = glm::vec4(0.2f, 0.3f, 0.3f, 1.0f);
+    std::span<const glm::mat4> worldMatrices = scene.worldMatrices();
+    frame.instances.assign(worldMatrices.begin(), worldMatrices.end());
+    frame.occluderCount = OCCLUDER_COUNT;
+    // A minimized window has no framebuffer; keep the last aspect then.
+    if (frame.framebufferWidth > 0 && frame.framebufferHeight > 0)
     {
-    case GL_DEBUG_SEVERITY_HIGH:
-        debugInfo << "[GL::Severity::High]";
-        break;
-    case GL_DEBUG_SEVERITY_MEDIUM:
-        debugInfo << "[GL::Severity::Medium]";
-        break;
-    case GL_DEBUG_SEVERITY_LOW:
-        debugInfo << "[GL::Severity::Low]";
-        break;
-    case GL_DEBUG_SEVERITY_NOTIFICATION:
-        debugInfo << "[GL::Severity::Notification]";
-        break;
-    default:
-        debugInfo << std::format("[GL::Severity::Unknown({})]", severity);
-        break;
+        camera.aspectRatio(
+            static_cast<float>(frame.framebufferWidth) / static_cast<float>(frame.framebufferHeight)
+        );
     }
+    frame.view = camera.getViewMatrix();
+    frame.projection = camera.getProjectionMatrix();
+    frame.viewProjection = camera.getViewProjectionMatrix();
+    frame.frustum = camera.frustum();
+    frame.cameraPosition = camera.position();
+    frame.fieldOfView = camera.fieldOfView();
+}
 
-    debugInfo << std::format(" Debug Message ({}): ", id) << message;
-    logging::debug(debugInfo.view());
+void simulateFrame(FrameSnapshot& frame, double time)
+{
+    animate(time);
+    snapshotFrame(frame);
 }
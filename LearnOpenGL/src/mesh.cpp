@@ -0,0 +1,177 @@
+#include "mesh.h"
+#include <glad/glad.h>
+#include <logging/logs.h>
+#include <assets/mapped_file.h>
+#include <algorithm>
+#include <cstdint>
+#include <format>
+
+namespace
+{
+
+GLenum componentType(assets::VertexComponentType type)
+{
+    switch (type)
+    {
+    case assets::VertexComponentType::Float16:
+        return GL_HALF_FLOAT;
+    case assets::VertexComponentType::SNorm16:
+        return GL_SHORT;
+    case assets::VertexComponentType::UNorm16:
+        return GL_UNSIGNED_SHORT;
+    default:
+        return GL_FLOAT;
+    }
+}
+
+bool normalized(assets::VertexComponentType type)
+{
+    return type == assets::VertexComponentType::SNorm16 ||
+           type == assets::VertexComponentType::UNorm16;
+}
+
+}
+
+Mesh::Mesh(const std::string& path)
+    : _vertexArray(),
+      _vertexBuffer(),
+      _indexBuffer(),
+      _loaded{},
+      _indexType{},
+      _indexSize{},
+      _byteSize{},
+      _submeshes(),
+      _lods(),
+      _boundsMin{},
+      _boundsMax{},
+      _positionScale{1.0f},
+      _positionBias{},
+      _quantized{}
+{
+    assets::MappedFile file(path);
+    assets::MeshHeader header{};
+    assets::MeshView mesh{};
+    if (!file.isOpen())
+    {
+        logging::error(std::format("Failed to open mesh {}", path));
+        return;
+    }
+    if (!assets::readMeshContainer(file.bytes(), header, mesh))
+    {
+        logging::error(std::format("Invalid mesh container {}", path));
+        return;
+    }
+
+    // The data never changes, which immutable storage tells the driver.
+    _vertexBuffer.storage(static_cast<GLsizeiptr>(mesh.vertices.size()), mesh.vertices.data(), 0);
+    _indexBuffer.storage(static_cast<GLsizeiptr>(mesh.indices.size()), mesh.indices.data(), 0);
+    // Every attribute reads from the one vertex buffer at binding point 0.
+    _vertexArray.vertexBuffer(0, _vertexBuffer, 0, static_cast<GLsizei>(header.vertexStride));
+    _vertexArray.elementBuffer(_indexBuffer);
+
+    for (const assets::VertexAttribute& attribute : mesh.attributes)
+    {
+        _vertexArray.attribute(
+            static_cast<GLuint>(attribute.semantic),
+            0,
+            static_cast<GLint>(attribute.componentCount),
+            componentType(attribute.componentType),
+            normalized(attribute.componentType) ? GL_TRUE : GL_FALSE,
+            attribute.offset
+        );
+        if (attribute.semantic == assets::VertexSemantic::Position &&
+            attribute.componentType != assets::VertexComponentType::Float32)
+        {
+            _quantized = true;
+        }
+    }
+
+    _indexType = header.indexFormat == assets::IndexFormat::UInt16 ? GL_UNSIGNED_SHORT
+                                                                   : GL_UNSIGNED_INT;
+    _indexSize = static_cast<GLsizei>(assets::indexSize(header.indexFormat));
+    _byteSize = mesh.vertices.size() + mesh.indices.size();
+    _loaded = true;
+    _submeshes.assign(mesh.submeshes.begin(), mesh.submeshes.end());
+    _lods.assign(mesh.lods.begin(), mesh.lods.end());
+    _boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    _boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    _positionScale =
+        glm::vec3(header.positionScale[0], header.positionScale[1], header.positionScale[2]);
+    _positionBias =
+        glm::vec3(header.positionBias[0], header.positionBias[1], header.positionBias[2]);
+    logging::debug(std::format(
+        "Mesh loaded: {} ({} vertices of {} bytes, {} indices, {} submeshes, {} levels of detail)",
+        path,
+        header.vertexCount,
+        header.vertexStride,
+        header.indexCount,
+        _submeshes.size(),
+        _lods.size()
+    ));
+}
+
+bool Mesh::loaded() const
+{
+    return _loaded;
+}
+
+const std::vector<assets::Submesh>& Mesh::submeshes() const
+{
+    return _submeshes;
+}
+
+const std::vector<assets::MeshLod>& Mesh::lods() const
+{
+    return _lods;
+}
+
+glm::vec3 Mesh::boundsMin() const
+{
+    return _boundsMin;
+}
+
+glm::vec3 Mesh::boundsMax() const
+{
+    return _boundsMax;
+}
+
+glm::vec3 Mesh::positionScale() const
+{
+    return _positionScale;
+}
+
+glm::vec3 Mesh::positionBias() const
+{
+    return _positionBias;
+}
+
+bool Mesh::quantized() const
+{
+    return _quantized;
+}
+
+std::size_t Mesh::byteSize() const
+{
+    return _byteSize;
+}
+
+void Mesh::draw(GLsizei instanceCount, std::size_t lod) const
+{
+    if (!loaded())
+    {
+        return;
+    }
+    const assets::MeshLod& level = _lods[std::min(lod, _lods.size() - 1)];
+    _vertexArray.bind();
+    for (std::uint32_t i = 0; i < level.submeshCount; i++)
+    {
+        const assets::Submesh& submesh = _submeshes[level.firstSubmesh + i];
+        glDrawElementsInstanced(
+            GL_TRIANGLES,
+            static_cast<GLsizei>(submesh.indexCount),
+            _indexType,
+            reinterpret_cast<const void*>(std::uintptr_t{submesh.firstIndex} * _indexSize),
+            instanceCount
+        );
+    }
+}
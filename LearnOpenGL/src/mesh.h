@@ -0,0 +1,60 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <assets/mesh_container.h>
+#include <string>
+#include <vector>
+
+#include "gl_objects.h"
+
+// Mesh read from a mesh container (.lmesh) written by the asset tool. The file is
+// memory mapped and OpenGL copies the vertex and index data straight from the
+// mapping into buffer storage. The vertex layout stored in the file sets up the
+// vertex array, each attribute bound to the location given by its semantic.
+//
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+class Mesh
+{
+  public:
+    explicit Mesh(const std::string& path);
+    ~Mesh() = default;
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // False if the file could not be read, nothing is drawn then.
+    bool loaded() const;
+    const std::vector<assets::Submesh>& submeshes() const;
+    // Levels of detail from full detail on, each drawing a range of the submeshes.
+    const std::vector<assets::MeshLod>& lods() const;
+    glm::vec3 boundsMin() const;
+    glm::vec3 boundsMax() const;
+    // Dequantization of the stored positions, which the vertex shader applies
+    // as position * scale + bias. Identity for unquantized meshes.
+    glm::vec3 positionScale() const;
+    glm::vec3 positionBias() const;
+    // True if the mesh needs the quantized vertex shader, which also decodes
+    // octahedral normals.
+    bool quantized() const;
+    // Bytes of vertex and index buffer storage.
+    std::size_t byteSize() const;
+
+    // Draw every submesh of a level of detail with the given number of instances.
+    void draw(GLsizei instanceCount = 1, std::size_t lod = 0) const;
+
+  private:
+    VertexArray _vertexArray;
+    Buffer _vertexBuffer;
+    Buffer _indexBuffer;
+    bool _loaded;
+    GLenum _indexType;
+    GLsizei _indexSize;
+    std::size_t _byteSize;
+    std::vector<assets::Submesh> _submeshes;
+    std::vector<assets::MeshLod> _lods;
+    glm::vec3 _boundsMin;
+    glm::vec3 _boundsMax;
+    glm::vec3 _positionScale;
+    glm::vec3 _positionBias;
+    bool _quantized;
+};
@@ -0,0 +1,416 @@
+#include "occlusion_culler.h"
+#include <logging/logs.h>
+#include <assets/mapped_file.h>
+#include <assets/mesh_container.h>
+#include <emmintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <latch>
+
+bool loadOccluder(const std::string& path, std::size_t lod, Occluder& occluder)
+{
+    assets::MappedFile file(path);
+    assets::MeshHeader header{};
+    assets::MeshView mesh{};
+    if (!file.isOpen() || !assets::readMeshContainer(file.bytes(), header, mesh))
+    {
+        logging::error(std::format("Failed to read occluder {}", path));
+        return false;
+    }
+    std::vector<float> positions;
+    assets::readPositions(header, mesh, positions);
+    occluder.positions.resize(header.vertexCount);
+    for (std::size_t vertex = 0; vertex < occluder.positions.size(); vertex++)
+    {
+        occluder.positions[vertex] = glm::vec3(
+            positions[vertex * 3], positions[vertex * 3 + 1], positions[vertex * 3 + 2]
+        );
+    }
+    if (!assets::readLodIndices(
+            header, mesh, std::min(lod, mesh.lods.size() - 1), occluder.indices
+        ))
+    {
+        logging::error(std::format("Occluder {} indexes missing vertices", path));
+        occluder = {};
+        return false;
+    }
+    return true;
+}
+
+OcclusionCuller::OcclusionCuller(ThreadPool& threadPool, int width, int height)
+    : _threadPool(threadPool),
+      _width{},
+      _height{},
+      _tilesX{(std::max(width, 1) + TileWidth - 1) / TileWidth},
+      _tilesY{(std::max(height, 1) + TileHeight - 1) / TileHeight},
+      _viewProjection(1.0f),
+      _batches(),
+      _occluded{},
+      _pyramid()
+{
+    _width = _tilesX * TileWidth;
+    _height = _tilesY * TileHeight;
+    int levelWidth = _width;
+    int levelHeight = _height;
+    while (true)
+    {
+        _pyramid.push_back(DepthLevel{
+            levelWidth, levelHeight, std::vector<float>(std::size_t(levelWidth) * levelHeight, 1.0f)
+        });
+        if (levelWidth == 1 && levelHeight == 1)
+        {
+            break;
+        }
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4& viewProjection)
+{
+    _viewProjection = viewProjection;
+    _batches.clear();
+    // Only a frame with occluders leaves depth behind.
+    if (_occluded)
+    {
+        std::fill(_pyramid[0].depth.begin(), _pyramid[0].depth.end(), 1.0f);
+        _occluded = false;
+    }
+}
+
+void OcclusionCuller::addOccluder(const Occluder& occluder, const glm::mat4& model)
+{
+    std::size_t triangleCount = occluder.indices.size() / 3;
+    for (std::size_t first = 0; first < triangleCount; first += BatchTriangleCount)
+    {
+        _batches.push_back(Batch{
+            &occluder,
+            _viewProjection * model,
+            first,
+            std::min(BatchTriangleCount, triangleCount - first),
+        });
+    }
+}
+
+void OcclusionCuller::rasterize()
+{
+    if (_batches.empty())
+    {
+        return;
+    }
+    _occluded = true;
+    // Binning writes only to its own batch and rasterizing only to its own
+    // tile, so neither step needs locking.
+    runParallel(_batches.size(), [this](std::size_t batch) {
+        setupBatch(_batches[batch]);
+    });
+    runParallel(std::size_t(_tilesX) * _tilesY, [this](std::size_t tile) {
+        rasterizeTile(static_cast<int>(tile));
+    });
+    buildPyramid();
+}
+
+bool OcclusionCuller::visible(
+    const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model
+) const
+{
+    return visibleProjected(boundsMin, boundsMax, _viewProjection * model);
+}
+
+bool OcclusionCuller::visibleProjected(
+    const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelViewProjection
+) const
+{
+    glm::vec3 ndcMin(std::numeric_limits<float>::max());
+    glm::vec3 ndcMax(std::numeric_limits<float>::lowest());
+    for (int corner = 0; corner < 8; corner++)
+    {
+        glm::vec4 position(
+            corner & 1 ? boundsMax.x : boundsMin.x,
+            corner & 2 ? boundsMax.y : boundsMin.y,
+            corner & 4 ? boundsMax.z : boundsMin.z,
+            1.0f
+        );
+        glm::vec4 clip = modelViewProjection * position;
+        if (clip.z < -clip.w || clip.w <= 0.0f)
+        {
+            return true;
+        }
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+    if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f ||
+        ndcMin.z > 1.0f)
+    {
+        return false;
+    }
+    if (!_occluded)
+    {
+        return true;
+    }
+
+    float nearestDepth = ndcMin.z * 0.5f + 0.5f;
+    auto toPixel = [](float ndc, int size) {
+        return std::clamp(static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * size)), 0, size - 1);
+    };
+    int minX = toPixel(ndcMin.x, _width);
+    int maxX = toPixel(ndcMax.x, _width);
+    int minY = toPixel(ndcMin.y, _height);
+    int maxY = toPixel(ndcMax.y, _height);
+
+    // The first level where the box spans at most four texels each way.
+    std::size_t level = 0;
+    while (level + 1 < _pyramid.size() &&
+           ((maxX >> level) - (minX >> level) > 3 || (maxY >> level) - (minY >> level) > 3))
+    {
+        level++;
+    }
+    const DepthLevel& depth = _pyramid[level];
+    for (int y = minY >> level; y <= maxY >> level; y++)
+    {
+        for (int x = minX >> level; x <= maxX >> level; x++)
+        {
+            if (depth.depth[std::size_t(y) * depth.width + x] >= nearestDepth)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int OcclusionCuller::width() const
+{
+    return _width;
+}
+
+int OcclusionCuller::height() const
+{
+    return _height;
+}
+
+std::span<const float> OcclusionCuller::depth() const
+{
+    return _pyramid[0].depth;
+}
+
+void OcclusionCuller::setupBatch(Batch& batch) const
+{
+    batch.triangles.clear();
+    batch.bins.assign(std::size_t(_tilesX) * _tilesY, {});
+    const Occluder& occluder = *batch.occluder;
+    for (std::size_t triangle = batch.firstTriangle;
+         triangle < batch.firstTriangle + batch.triangleCount;
+         triangle++)
+    {
+        glm::vec4 clip[4];
+        float nearDistance[3];
+        int insideCount = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            glm::vec3 position = occluder.positions[occluder.indices[triangle * 3 + k]];
+            clip[k] = batch.transform * glm::vec4(position, 1.0f);
+            nearDistance[k] = clip[k].z + clip[k].w;
+            insideCount += nearDistance[k] >= 0.0f;
+        }
+        if (insideCount == 3)
+        {
+            addTriangle(batch, clip);
+            continue;
+        }
+        if (insideCount == 0)
+        {
+            continue;
+        }
+
+        // Clip against the near plane, leaving a triangle or a quad.
+        glm::vec4 polygon[4];
+        int vertexCount = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            int next = (k + 1) % 3;
+            if (nearDistance[k] >= 0.0f)
+            {
+                polygon[vertexCount++] = clip[k];
+            }
+            if ((nearDistance[k] >= 0.0f) != (nearDistance[next] >= 0.0f))
+            {
+                float t = nearDistance[k] / (nearDistance[k] - nearDistance[next]);
+                polygon[vertexCount++] = clip[k] + (clip[next] - clip[k]) * t;
+            }
+        }
+        addTriangle(batch, polygon);
+        if (vertexCount == 4)
+        {
+            glm::vec4 second[3] = {polygon[0], polygon[2], polygon[3]};
+            addTriangle(batch, second);
+        }
+    }
+}
+
+void OcclusionCuller::addTriangle(Batch& batch, const glm::vec4* clip) const
+{
+    float x[3];
+    float y[3];
+    float z[3];
+    for (int k = 0; k < 3; k++)
+    {
+        x[k] = (clip[k].x / clip[k].w * 0.5f + 0.5f) * _width;
+        y[k] = (clip[k].y / clip[k].w * 0.5f + 0.5f) * _height;
+        z[k] = clip[k].z / clip[k].w * 0.5f + 0.5f;
+    }
+    // Counter-clockwise triangles face the camera, the others are hidden by them.
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (!(area > 0.0f))
+    {
+        return;
+    }
+
+    // Pixels whose centre lies within the bounds of the triangle.
+    ScreenTriangle screen{};
+    screen.minX = std::max(static_cast<int>(std::ceil(std::min({x[0], x[1], x[2]}) - 0.5f)), 0);
+    screen.minY = std::max(static_cast<int>(std::ceil(std::min({y[0], y[1], y[2]}) - 0.5f)), 0);
+    screen.maxX =
+        std::min(static_cast<int>(std::floor(std::max({x[0], x[1], x[2]}) - 0.5f)), _width - 1);
+    screen.maxY =
+        std::min(static_cast<int>(std::floor(std::max({y[0], y[1], y[2]}) - 0.5f)), _height - 1);
+    if (screen.minX > screen.maxX || screen.minY > screen.maxY)
+    {
+        return;
+    }
+
+    for (int k = 0; k < 3; k++)
+    {
+        int next = (k + 1) % 3;
+        screen.edgeA[k] = y[k] - y[next];
+        screen.edgeB[k] = x[next] - x[k];
+        screen.edgeC[k] = x[k] * y[next] - y[k] * x[next];
+    }
+    screen.depthDx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+    screen.depthDy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+    screen.depth = z[0] - screen.depthDx * x[0] - screen.depthDy * y[0];
+
+    auto index = static_cast<std::uint32_t>(batch.triangles.size());
+    batch.triangles.push_back(screen);
+    for (int tileY = screen.minY / TileHeight; tileY <= screen.maxY / TileHeight; tileY++)
+    {
+        for (int tileX = screen.minX / TileWidth; tileX <= screen.maxX / TileWidth; tileX++)
+        {
+            batch.bins[std::size_t(tileY) * _tilesX + tileX].push_back(index);
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeTile(int tile)
+{
+    int tileMinX = tile % _tilesX * TileWidth;
+    int tileMinY = tile / _tilesX * TileHeight;
+    int tileMaxX = tileMinX + TileWidth - 1;
+    int tileMaxY = tileMinY + TileHeight - 1;
+    float* depth = _pyramid[0].depth.data();
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (const Batch& batch : _batches)
+    {
+        for (std::uint32_t index : batch.bins[tile])
+        {
+            const ScreenTriangle& triangle = batch.triangles[index];
+            // Start on a multiple of four pixels so every store stays within the tile.
+            int startX = tileMinX + ((std::max(triangle.minX, tileMinX) - tileMinX) & ~3);
+            int endX = std::min(triangle.maxX, tileMaxX);
+            int startY = std::max(triangle.minY, tileMinY);
+            int endY = std::min(triangle.maxY, tileMaxY);
+
+            __m128 x = _mm_add_ps(_mm_set1_ps(static_cast<float>(startX)), laneOffsets);
+            __m128 edgeStep[3];
+            __m128 edgeRow[3];
+            for (int k = 0; k < 3; k++)
+            {
+                edgeStep[k] = _mm_set1_ps(triangle.edgeA[k] * 4.0f);
+                edgeRow[k] = _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(triangle.edgeA[k]), x),
+                    _mm_set1_ps(triangle.edgeB[k] * (startY + 0.5f) + triangle.edgeC[k])
+                );
+            }
+            __m128 depthStep = _mm_set1_ps(triangle.depthDx * 4.0f);
+            __m128 depthRow = _mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(triangle.depthDx), x),
+                _mm_set1_ps(triangle.depthDy * (startY + 0.5f) + triangle.depth)
+            );
+
+            for (int y = startY; y <= endY; y++)
+            {
+                __m128 edge0 = edgeRow[0];
+                __m128 edge1 = edgeRow[1];
+                __m128 edge2 = edgeRow[2];
+                __m128 z = depthRow;
+                float* row = depth + std::size_t(y) * _width;
+                for (int pixelX = startX; pixelX <= endX; pixelX += 4)
+                {
+                    __m128 inside = _mm_and_ps(
+                        _mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)),
+                        _mm_cmpge_ps(edge2, zero)
+                    );
+                    __m128 stored = _mm_loadu_ps(row + pixelX);
+                    __m128 closer = _mm_and_ps(inside, _mm_cmplt_ps(z, stored));
+                    _mm_storeu_ps(
+                        row + pixelX,
+                        _mm_or_ps(_mm_and_ps(closer, z), _mm_andnot_ps(closer, stored))
+                    );
+                    edge0 = _mm_add_ps(edge0, edgeStep[0]);
+                    edge1 = _mm_add_ps(edge1, edgeStep[1]);
+                    edge2 = _mm_add_ps(edge2, edgeStep[2]);
+                    z = _mm_add_ps(z, depthStep);
+                }
+                for (int k = 0; k < 3; k++)
+                {
+                    edgeRow[k] = _mm_add_ps(edgeRow[k], _mm_set1_ps(triangle.edgeB[k]));
+                }
+                depthRow = _mm_add_ps(depthRow, _mm_set1_ps(triangle.depthDy));
+            }
+        }
+    }
+}
+
+void OcclusionCuller::buildPyramid()
+{
+    for (std::size_t level = 1; level < _pyramid.size(); level++)
+    {
+        const DepthLevel& source = _pyramid[level - 1];
+        DepthLevel& target = _pyramid[level];
+        for (int y = 0; y < target.height; y++)
+        {
+            int y0 = y * 2;
+            int y1 = std::min(y0 + 1, source.height - 1);
+            for (int x = 0; x < target.width; x++)
+            {
+                int x0 = x * 2;
+                int x1 = std::min(x0 + 1, source.width - 1);
+                target.depth[std::size_t(y) * target.width + x] = std::max(
+                    {source.depth[std::size_t(y0) * source.width + x0],
+                     source.depth[std::size_t(y0) * source.width + x1],
+                     source.depth[std::size_t(y1) * source.width + x0],
+                     source.depth[std::size_t(y1) * source.width + x1]}
+                );
+            }
+        }
+    }
+}
+
+void OcclusionCuller::runParallel(
+    std::size_t count, const std::function<void(std::size_t)>& task
+)
+{
+    std::latch done(static_cast<std::ptrdiff_t>(count));
+    for (std::size_t i = 0; i < count; i++)
+    {
+        _threadPool.submit([&task, &done, i] {
+            task(i);
+            done.count_down();
+        });
+    }
+    done.wait();
+}
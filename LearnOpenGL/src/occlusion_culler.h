@@ -0,0 +1,127 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+
+// Triangle mesh kept on the CPU to occlude other objects.
+struct Occluder
+{
+    std::vector<glm::vec3> positions;
+    std::vector<std::uint32_t> indices;
+};
+
+// Read a level of detail of a mesh container as an occluder. Coarse levels are
+// cheaper to rasterize but may stick out of the surface and hide visible objects.
+bool loadOccluder(const std::string& path, std::size_t lod, Occluder& occluder);
+
+// Software occlusion culling. Occluders are rasterized on the CPU into a small
+// depth buffer split into tiles, which the thread pool fills independently with
+// SSE, four pixels at a time. A pyramid holding the farthest depth of every
+// block then tells whether a bounding box is hidden, by testing a few texels of
+// the level that matches its size on screen. Nothing involves OpenGL, so draws
+// are culled before submission without any readback, and without a GPU at all.
+class OcclusionCuller
+{
+  public:
+    static constexpr int DefaultWidth = 256;
+    static constexpr int DefaultHeight = 128;
+
+    // The resolution is rounded up to whole tiles.
+    explicit OcclusionCuller(
+        ThreadPool& threadPool, int width = DefaultWidth, int height = DefaultHeight
+    );
+
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    // Forget the occluders of the last frame and start one seen through viewProjection.
+    void beginFrame(const glm::mat4& viewProjection);
+    // Queue an occluder placed by the model matrix. It must stay alive until rasterize returns.
+    void addOccluder(const Occluder& occluder, const glm::mat4& model);
+    // Rasterize the queued occluders and build the depth pyramid. Blocks until
+    // done. Returns at once without occluders, as nothing can be hidden.
+    void rasterize();
+    // False if the box, given in model space, is certainly outside the view or
+    // behind the occluders. Boxes crossing the near plane always count as visible.
+    bool visible(
+        const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model
+    ) const;
+    // The same for a box already combined with the frame's view projection.
+    bool visibleProjected(
+        const glm::vec3& boundsMin,
+        const glm::vec3& boundsMax,
+        const glm::mat4& modelViewProjection
+    ) const;
+
+    int width() const;
+    int height() const;
+    // Nearest occluder depth of every pixel from 0 at the near plane to 1 at the
+    // far plane, in rows from the bottom of the view.
+    std::span<const float> depth() const;
+
+  private:
+    static constexpr int TileWidth = 64;
+    static constexpr int TileHeight = 32;
+    // Triangles transformed and binned by one task.
+    static constexpr std::size_t BatchTriangleCount = 4096;
+
+    // Front facing triangle in pixels, with depth as a plane over the screen.
+    struct ScreenTriangle
+    {
+        // Edge functions A * x + B * y + C, positive inside.
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float depth;
+        float depthDx;
+        float depthDy;
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+    };
+
+    struct DepthLevel
+    {
+        int width;
+        int height;
+        std::vector<float> depth;
+    };
+
+    struct Batch
+    {
+        const Occluder* occluder;
+        glm::mat4 transform;
+        std::size_t firstTriangle;
+        std::size_t triangleCount;
+        std::vector<ScreenTriangle> triangles;
+        // Triangles overlapping each tile.
+        std::vector<std::vector<std::uint32_t>> bins;
+    };
+
+    ThreadPool& _threadPool;
+    int _width;
+    int _height;
+    int _tilesX;
+    int _tilesY;
+    glm::mat4 _viewProjection;
+    std::vector<Batch> _batches;
+    // Whether the frame rasterized any occluders, else the pyramid is stale.
+    bool _occluded;
+    // Level 0 is the depth buffer, each further level holds the farthest depth
+    // of 2x2 texels of the one before.
+    std::vector<DepthLevel> _pyramid;
+
+    void setupBatch(Batch& batch) const;
+    void addTriangle(Batch& batch, const glm::vec4* clip) const;
+    void rasterizeTile(int tile);
+    void buildPyramid();
+    // Run task(index) for every index on the thread pool and wait for all of them.
+    void runParallel(std::size_t count, const std::function<void(std::size_t)>& task);
+};
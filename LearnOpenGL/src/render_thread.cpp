@@ -0,0 +1,226 @@
+#include "render_thread.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <logging/logs.h>
+#include <format>
+#include <sstream>
+#include <utility>
+
+#include "cpu_profiler.h"
+#include "renderer.h"
+#include "timer.h"
+
+void APIENTRY glLogDebugInfo(
+    GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message,
+    const void* userParam
+);
+
+RenderThread::RenderThread(
+    GLFWwindow* window,
+    FramePipeline& pipeline,
+    ThreadPool& threadPool,
+    const FramePacingOptions& pacing
+)
+    : _window(window),
+      _pipeline(pipeline),
+      _threadPool(threadPool),
+      _pacing(pacing),
+      _redrawRequested(false),
+      _thread()
+{
+}
+
+RenderThread::~RenderThread()
+{
+    join();
+}
+
+bool RenderThread::start()
+{
+    std::promise<bool> initialized;
+    std::future<bool> result = initialized.get_future();
+    _thread = std::thread(&RenderThread::run, this, std::move(initialized));
+    return result.get();
+}
+
+void RenderThread::join()
+{
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+bool RenderThread::consumeRedrawRequest()
+{
+    return _redrawRequested.exchange(false, std::memory_order_relaxed);
+}
+
+void RenderThread::run(std::promise<bool> initialized)
+{
+    PROFILER_THREAD_NAME("Render");
+    glfwMakeContextCurrent(_window);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        logging::error("Error: Failed to initialize GLAD");
+        glfwMakeContextCurrent(nullptr);
+        initialized.set_value(false);
+        return;
+    }
+
+#ifdef _DEBUG
+    GLint contextFlags{};
+    glGetIntegerv(GL_CONTEXT_FLAGS, &contextFlags);
+    if (contextFlags & GL_CONTEXT_FLAG_DEBUG_BIT)
+    {
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDebugMessageCallback(glLogDebugInfo, nullptr);
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    }
+#endif
+
+    applyVsync(_pacing.vsync);
+
+    {
+        Renderer renderer(_threadPool, (GLADloadproc)glfwGetProcAddress);
+        FrameLimiter limiter(_pacing.targetFrameRate);
+        FrameFences fences(_pacing.lowLatency ? 1 : _pacing.maxFramesInFlight);
+        // Measures the intervals between presented frames.
+        Timer presentTimer{};
+        FrameTimeHistory inputLatencies{};
+        initialized.set_value(true);
+
+        while (const FrameSnapshot* frame = _pipeline.acquireFrame())
+        {
+            renderer.render(*frame);
+            limiter.wait();
+            {
+                ZONE("glfwSwapBuffers");
+                glfwSwapBuffers(_window);
+            }
+            presentTimer.update();
+            if (frame->inputTime != std::chrono::steady_clock::time_point{})
+            {
+                inputLatencies.add(std::chrono::steady_clock::now() - frame->inputTime);
+            }
+            // In low latency mode the frame is only released, letting the next
+            // one sample input, once the GPU finished it.
+            if (_pacing.lowLatency)
+            {
+                fences.endFrame();
+            }
+            _pipeline.releaseFrame();
+            if (!_pacing.lowLatency)
+            {
+                fences.endFrame();
+            }
+            // Wakes the main thread should it be waiting for events.
+            if (!renderer.settled())
+            {
+                _redrawRequested.store(true, std::memory_order_relaxed);
+                glfwPostEmptyEvent();
+            }
+        }
+        logging::info(
+            std::format("Frame delivery, last {}", formatFrameTimes(presentTimer.statistics()))
+        );
+        logging::info(std::format(
+            "Input to swap latency, last {}", formatFrameTimes(inputLatencies.statistics())
+        ));
+        renderer.logCulling();
+        renderer.logResourceMemory();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+void APIENTRY glLogDebugInfo(
+    GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message,
+    const void* userParam
+)
+{
+    std::stringstream debugInfo{};
+
+    switch (source)
+    {
+    case GL_DEBUG_SOURCE_API:
+        debugInfo << "[GL::Source::API]";
+        break;
+    case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+        debugInfo << "[GL::Source::WindowSystem]";
+        break;
+    case GL_DEBUG_SOURCE_SHADER_COMPILER:
+        debugInfo << "[GL::Source::ShaderCompiler]";
+        break;
+    case GL_DEBUG_SOURCE_THIRD_PARTY:
+        debugInfo << "[GL::Source::ThirdParty]";
+        break;
+    case GL_DEBUG_SOURCE_APPLICATION:
+        debugInfo << "[GL::Source::Application]";
+        break;
+    case GL_DEBUG_SOURCE_OTHER:
+        debugInfo << "[GL::Source::Other]";
+        break;
+    default:
+        debugInfo << std::format("[GL::Source::Unkown({})]", source);
+        break;
+    }
+
+    switch (type)
+    {
+    case GL_DEBUG_TYPE_ERROR:
+        debugInfo << "[GL::Type::Error]";
+        break;
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+        debugInfo << "[GL::Type::DeprecatedBehavior]";
+        break;
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+        debugInfo << "[GL::Type::UndefinedBehavior]";
+        break;
+    case GL_DEBUG_TYPE_PORTABILITY:
+        debugInfo << "[GL::Type::Portability]";
+        break;
+    case GL_DEBUG_TYPE_PERFORMANCE:
+        debugInfo << "[GL::Type::Performance]";
+        break;
+    case GL_DEBUG_TYPE_MARKER:
+        debugInfo << "[GL::Type::Marker]";
+        break;
+    case GL_DEBUG_TYPE_PUSH_GROUP:
+        debugInfo << "[GL::Type::PushGroup]";
+        break;
+    case GL_DEBUG_TYPE_POP_GROUP:
+        debugInfo << "[GL::Type::PopGroup]";
+        break;
+    case GL_DEBUG_TYPE_OTHER:
+        debugInfo << "[GL::Type::Other]";
+        break;
+    default:
+        debugInfo << std::format("[GL::Type::Unknown({})]", type);
+        break;
+    }
+
+    switch (severity)
+    {
+    case GL_DEBUG_SEVERITY_HIGH:
+        debugInfo << "[GL::Severity::High]";
+        break;
+    case GL_DEBUG_SEVERITY_MEDIUM:
+        debugInfo << "[GL::Severity::Medium]";
+        break;
+    case GL_DEBUG_SEVERITY_LOW:
+        debugInfo << "[GL::Severity::Low]";
+        break;
+    case GL_DEBUG_SEVERITY_NOTIFICATION:
+        debugInfo << "[GL::Severity::Notification]";
+        break;
+    default:
+        debugInfo << std::format("[GL::Severity::Unknown({})]", severity);
+        break;
+    }
+
+    debugInfo << std::format(" Debug Message ({}): ", id) << message;
+    logging::debug(debugInfo.view());
+}
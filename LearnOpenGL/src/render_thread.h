@@ -0,0 +1,47 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "frame_pacing.h"
+#include "frame_pipeline.h"
+#include "thread_pool.h"
+
+// Thread owning the window's OpenGL context. It loads OpenGL, creates the
+// renderer and then submits every frame published to the pipeline, paced as
+// configured.
+class RenderThread
+{
+  public:
+    RenderThread(
+        GLFWwindow* window,
+        FramePipeline& pipeline,
+        ThreadPool& threadPool,
+        const FramePacingOptions& pacing
+    );
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Start the thread and wait until OpenGL has been initialized on it.
+    // The window's context must not be current on the calling thread.
+    bool start();
+    // Wait for the thread to finish. Close the pipeline first.
+    void join();
+    // Whether the last frame rendered is not final, as resources it uses are
+    // still loading, and another frame should follow even if nothing changed.
+    // Clears the request. The thread posts an empty event when it requests one.
+    bool consumeRedrawRequest();
+
+  private:
+    GLFWwindow* _window;
+    FramePipeline& _pipeline;
+    ThreadPool& _threadPool;
+    FramePacingOptions _pacing;
+    std::atomic<bool> _redrawRequested;
+    std::thread _thread;
+
+    void run(std::promise<bool> initialized);
+};
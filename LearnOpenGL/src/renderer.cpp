@@ -0,0 +1,251 @@
+#include "renderer.h"
+#include <glad/glad.h>
+#include <logging/logs.h>
+#include <algorithm>
+#include <cstdint>
+#include <format>
+
+#include "cpu_profiler.h"
+
+Renderer::Renderer(ThreadPool& threadPool, GLADloadproc loadProc)
+    : _resources(),
+      _textures(threadPool),
+      _residency(loadProc, AllowBindlessTextures),
+      _mesh(_resources.loadMesh(MeshPath)),
+      _instanceLods(),
+      _occlusion(threadPool),
+      _occluder(),
+      _shader(_resources.loadShader(
+          _resources.get(_mesh)->quantized() ? "res/main_quantized.vert.glsl"
+                                             : "res/main_indexed.vert.glsl",
+          _residency.bindless() ? "res/main_bindless.frag.glsl" : "res/main_array.frag.glsl"
+      )),
+      _packedInstances(),
+      _instances(),
+      _worldMins(),
+      _worldMaxs(),
+      _selectedLods(),
+      _lodOffsets(),
+      _instanceBuffer(),
+      _instanceBufferSize{},
+      _texture{},
+      _textureSlot{},
+      _placeholderSlot{},
+      _viewportWidth{},
+      _viewportHeight{},
+      _gpuProfiler(),
+      _testedCount{},
+      _frustumCulledCount{},
+      _occlusionCulledCount{}
+{
+    glEnable(GL_DEPTH_TEST);
+
+    _texture = _textures.request("res/container.jpg");
+    // Until the texture is resident the streamer hands out its placeholder.
+    _placeholderSlot = _residency.add(_textures.texture(_texture), _textures.info(_texture));
+    _textureSlot = _placeholderSlot;
+
+    // Without an occluder nothing is culled behind other instances, which is
+    // only slower.
+    loadOccluder(MeshPath, OccluderLod, _occluder);
+}
+
+Renderer::~Renderer()
+{
+    _resources.release(_shader);
+    _resources.release(_mesh);
+}
+
+void Renderer::render(const FrameSnapshot& frame)
+{
+    ZONE("Renderer::render");
+    _gpuProfiler.beginFrame();
+    {
+        GpuProfiler::Scope frameScope(_gpuProfiler, "Frame");
+        drawFrame(frame);
+    }
+    _gpuProfiler.endFrame();
+    _resources.collect();
+}
+
+const GpuProfiler& Renderer::gpuProfiler() const
+{
+    return _gpuProfiler;
+}
+
+bool Renderer::settled() const
+{
+    return _textures.pendingCount() == 0;
+}
+
+void Renderer::logResourceMemory() const
+{
+    constexpr double KiB = 1024.0;
+    ResourceMemory meshes = _resources.meshMemory();
+    ResourceMemory shaders = _resources.shaderMemory();
+    logging::info(std::format(
+        "Resource memory: {} meshes {:.1f} KiB, {} shaders {:.1f} KiB, {} textures {:.1f} KiB",
+        meshes.count,
+        static_cast<double>(meshes.bytes) / KiB,
+        shaders.count,
+        static_cast<double>(shaders.bytes) / KiB,
+        _textures.textureCount(),
+        static_cast<double>(_textures.memoryBytes()) / KiB
+    ));
+}
+
+void Renderer::logCulling() const
+{
+    logging::info(std::format(
+        "Culling: {} instances tested, {} outside the frustum, {} behind occluders",
+        _testedCount,
+        _frustumCulledCount,
+        _occlusionCulledCount
+    ));
+}
+
+void Renderer::drawFrame(const FrameSnapshot& frame)
+{
+    Mesh& mesh = *_resources.get(_mesh);
+    Shader& shader = *_resources.get(_shader);
+    {
+        GpuProfiler::Scope uploadScope(_gpuProfiler, "Texture upload");
+        _textures.update(TextureUploadBudget);
+    }
+    if (_textureSlot == _placeholderSlot && _textures.resident(_texture))
+    {
+        _textureSlot = _residency.add(_textures.texture(_texture), _textures.info(_texture));
+        // Array pools keep their own copy, so the streamed texture would only
+        // take the same memory twice.
+        if (!_residency.bindless())
+        {
+            _textures.release(_texture);
+        }
+    }
+
+    if (frame.framebufferWidth != _viewportWidth || frame.framebufferHeight != _viewportHeight)
+    {
+        _viewportWidth = frame.framebufferWidth;
+        _viewportHeight = frame.framebufferHeight;
+        glViewport(
+            0, 0, static_cast<GLsizei>(_viewportWidth), static_cast<GLsizei>(_viewportHeight)
+        );
+    }
+
+    {
+        GpuProfiler::Scope clearScope(_gpuProfiler, "Clear");
+        glClearColor(
+            frame.clearColor.x, frame.clearColor.y, frame.clearColor.z, frame.clearColor.w
+        );
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    // Cull every instance, pick its level of detail and group the survivors by level.
+    const glm::mat4& viewProjection = frame.viewProjection;
+    std::size_t instanceCount = frame.instances.size();
+    std::size_t occluderCount = _occluder.indices.empty() ? 0 : frame.occluderCount;
+    occluderCount = std::min(occluderCount, instanceCount);
+    _occlusion.beginFrame(viewProjection);
+    for (std::size_t i = 0; i < occluderCount; i++)
+    {
+        _occlusion.addOccluder(_occluder, frame.instances[i]);
+    }
+    _occlusion.rasterize();
+
+    // Draws are batched by texture pool. With bindless handles everything is in one pool.
+    std::uint32_t textureIndex = _residency.shaderIndex(_textureSlot);
+    _packedInstances.resize(instanceCount);
+    packInstances(viewProjection, frame.instances, textureIndex, _packedInstances);
+    _worldMins.resize(instanceCount);
+    _worldMaxs.resize(instanceCount);
+    transformBounds(mesh.boundsMin(), mesh.boundsMax(), frame.instances, _worldMins, _worldMaxs);
+
+    _testedCount += instanceCount;
+    _instanceLods.resize(instanceCount);
+    _selectedLods.resize(instanceCount);
+    _lodOffsets.assign(std::max<std::size_t>(mesh.lods().size(), 1) + 1, 0);
+    for (std::size_t i = 0; i < instanceCount; i++)
+    {
+        const glm::mat4& model = frame.instances[i];
+        const glm::mat4& modelViewProjection = _packedInstances[i].modelViewProjection;
+        // The frustum test is cheaper, so it goes first. Occluders are not
+        // tested against their own depth, which rounding could make hide them.
+        if (!frame.frustum.intersects(_worldMins[i], _worldMaxs[i]))
+        {
+            _selectedLods[i] = Culled;
+            _frustumCulledCount++;
+            continue;
+        }
+        if (i >= occluderCount &&
+            !_occlusion.visibleProjected(mesh.boundsMin(), mesh.boundsMax(), modelViewProjection))
+        {
+            _selectedLods[i] = Culled;
+            _occlusionCulledCount++;
+            continue;
+        }
+        std::size_t lod = _instanceLods[i].select(
+            mesh, model, frame.cameraPosition, frame.fieldOfView, _viewportHeight
+        );
+        _selectedLods[i] = lod;
+        _lodOffsets[lod + 1]++;
+    }
+    for (std::size_t lod = 1; lod < _lodOffsets.size(); lod++)
+    {
+        _lodOffsets[lod] += _lodOffsets[lod - 1];
+    }
+    if (_lodOffsets.back() == 0)
+    {
+        return;
+    }
+
+    _instances.resize(_lodOffsets.back());
+    for (std::size_t i = 0; i < instanceCount; i++)
+    {
+        if (_selectedLods[i] != Culled)
+        {
+            std::size_t& slot = _lodOffsets[_selectedLods[i]];
+            _instances[slot++] = _packedInstances[i];
+        }
+    }
+
+    {
+        GpuProfiler::Scope uploadScope(_gpuProfiler, "Instance upload");
+        // Grow the instance buffer as needed, then replace its contents in one upload.
+        auto instanceBytes = static_cast<GLsizeiptr>(_instances.size() * sizeof(PackedInstance));
+        if (instanceBytes > _instanceBufferSize)
+        {
+            _instanceBufferSize = std::max(instanceBytes, _instanceBufferSize * 2);
+            _instanceBuffer.data(_instanceBufferSize, nullptr, GL_DYNAMIC_DRAW);
+        }
+        _instanceBuffer.subData(0, instanceBytes, _instances.data());
+        _instanceBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, InstanceDataBinding);
+    }
+
+    GpuProfiler::Scope drawScope(_gpuProfiler, "Draw");
+    shader.use();
+    if (mesh.quantized())
+    {
+        shader.setUniformVec3("positionScale", mesh.positionScale());
+        shader.setUniformVec3("positionBias", mesh.positionBias());
+    }
+    if (_residency.bindless())
+    {
+        _residency.bindHandles(TextureHandleBinding);
+    }
+    else
+    {
+        _residency.bindPool(_residency.pool(_textureSlot), 0);
+    }
+
+    // Grouping moved every offset to the end of its level.
+    std::size_t first = 0;
+    for (std::size_t lod = 0; lod + 1 < _lodOffsets.size(); lod++)
+    {
+        if (_lodOffsets[lod] > first)
+        {
+            shader.setUniformInt("firstInstance", static_cast<GLint>(first));
+            mesh.draw(static_cast<GLsizei>(_lodOffsets[lod] - first), lod);
+        }
+        first = _lodOffsets[lod];
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <glad/glad.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frame_snapshot.h"
+#include "gl_objects.h"
+#include "gpu_profiler.h"
+#include "lod_selector.h"
+#include "mesh.h"
+#include "occlusion_culler.h"
+#include "resource_manager.h"
+#include "texture_residency.h"
+#include "texture_streamer.h"
+#include "thread_pool.h"
+#include "transform_batch.h"
+
+// Owns the scene's OpenGL resources and draws frame snapshots.
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+class Renderer
+{
+  public:
+    // OpenGL extension functions are looked up through loadProc.
+    Renderer(ThreadPool& threadPool, GLADloadproc loadProc);
+    ~Renderer();
+
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    // Submit the draw calls for the given frame to the current context.
+    void render(const FrameSnapshot& frame);
+
+    // GPU time of the passes of recent frames.
+    const GpuProfiler& gpuProfiler() const;
+    // Whether drawing the same frame again would show the same image, which
+    // is not the case while streamed textures are still loading.
+    bool settled() const;
+    // Report the memory taken by each resource type.
+    void logResourceMemory() const;
+    // Report how many instances the frustum and the occluders culled so far.
+    void logCulling() const;
+
+  private:
+    // Time per frame spent uploading streamed textures.
+    static constexpr std::chrono::microseconds TextureUploadBudget{2000};
+    static constexpr bool AllowBindlessTextures = true;
+    // Shader storage buffer bindings used by the indexed shaders.
+    static constexpr GLuint InstanceDataBinding = 0;
+    static constexpr GLuint TextureHandleBinding = 1;
+    static constexpr std::size_t Culled = SIZE_MAX;
+    static constexpr const char* MeshPath = "res/cube.lmesh";
+    // Occluders use the first simplified level, which is cheaper to rasterize
+    // and still close enough to the surface not to hide visible draws.
+    static constexpr std::size_t OccluderLod = 1;
+
+    ResourceManager _resources;
+    TextureStreamer _textures;
+    TextureResidency _residency;
+    MeshHandle _mesh;
+    // Level of detail state of every instance of the frame.
+    std::vector<LodSelector> _instanceLods;
+    OcclusionCuller _occlusion;
+    // The mesh as rasterized on the CPU for the instances acting as occluders,
+    // empty if it failed to load.
+    Occluder _occluder;
+    // Vertex shader picked by the mesh's vertex format, fragment shader by texture residency.
+    ShaderHandle _shader;
+    // Every instance of the frame, then the visible ones grouped by level of
+    // detail, which are uploaded to the instance buffer.
+    std::vector<PackedInstance> _packedInstances;
+    std::vector<PackedInstance> _instances;
+    // World bounds of every instance of the frame, for the frustum test.
+    std::vector<glm::vec3> _worldMins;
+    std::vector<glm::vec3> _worldMaxs;
+    // Level of detail picked for each instance of the frame, Culled if not drawn.
+    std::vector<std::size_t> _selectedLods;
+    // First instance of each level of detail, the last element being the visible count.
+    std::vector<std::size_t> _lodOffsets;
+    Buffer _instanceBuffer;
+    GLsizeiptr _instanceBufferSize;
+    TextureStreamer::TextureId _texture;
+    // Residency slot of the texture, the placeholder's slot until it is resident.
+    TextureResidency::Slot _textureSlot;
+    TextureResidency::Slot _placeholderSlot;
+    int _viewportWidth;
+    int _viewportHeight;
+    GpuProfiler _gpuProfiler;
+    // Instances tested and culled since creation.
+    std::uint64_t _testedCount;
+    std::uint64_t _frustumCulledCount;
+    std::uint64_t _occlusionCulledCount;
+
+    void drawFrame(const FrameSnapshot& frame);
+};
@@ -0,0 +1,70 @@
+#include "resource_manager.h"
+#include <logging/logs.h>
+#include <assets/hash.h>
+#include <assets/mapped_file.h>
+#include <format>
+
+namespace
+{
+
+// Hash of the file's content continuing from the seed, zero if it cannot be read.
+std::uint64_t hashFile(const std::string& path, std::uint64_t seed = assets::HashOffsetBasis)
+{
+    assets::MappedFile file(path);
+    return file.isOpen() ? assets::hashBytes(file.bytes(), seed) : 0;
+}
+
+}
+
+MeshHandle ResourceManager::loadMesh(const std::string& path)
+{
+    if (MeshHandle handle = _meshes.find(path))
+    {
+        return handle;
+    }
+    std::uint64_t contentHash = hashFile(path);
+    if (MeshHandle handle = _meshes.findContent(contentHash))
+    {
+        logging::debug(std::format("Mesh {} has the content of a loaded mesh", path));
+        _meshes.addPath(handle, path);
+        return handle;
+    }
+    return _meshes.emplace(path, contentHash, path);
+}
+
+ShaderHandle ResourceManager::loadShader(
+    const std::string& vertexPath, const std::string& fragmentPath
+)
+{
+    // Programs are identified by both stages.
+    std::string path = std::format("{}|{}", vertexPath, fragmentPath);
+    if (ShaderHandle handle = _shaders.find(path))
+    {
+        return handle;
+    }
+    std::uint64_t vertexHash = hashFile(vertexPath);
+    std::uint64_t contentHash = vertexHash != 0 ? hashFile(fragmentPath, vertexHash) : 0;
+    if (ShaderHandle handle = _shaders.findContent(contentHash))
+    {
+        logging::debug(std::format("Shader {} has the content of a loaded shader", path));
+        _shaders.addPath(handle, path);
+        return handle;
+    }
+    return _shaders.emplace(path, contentHash, vertexPath, fragmentPath);
+}
+
+void ResourceManager::collect()
+{
+    _meshes.collect();
+    _shaders.collect();
+}
+
+ResourceMemory ResourceManager::meshMemory() const
+{
+    return _meshes.memory();
+}
+
+ResourceMemory ResourceManager::shaderMemory() const
+{
+    return _shaders.memory();
+}
@@ -0,0 +1,273 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mesh.h"
+#include "shader.h"
+
+// Typed reference to a resource of a ResourceManager. Slots are reused, and a
+// slot's generation changes whenever its resource is released, so handles to
+// released resources are told apart from handles to whatever took the slot.
+template <typename T>
+struct Handle
+{
+    std::uint32_t index = 0;
+    // Zero for the null handle, slots start at generation one.
+    std::uint32_t generation = 0;
+
+    explicit operator bool() const
+    {
+        return generation != 0;
+    }
+    bool operator==(const Handle&) const = default;
+};
+
+using MeshHandle = Handle<Mesh>;
+using ShaderHandle = Handle<Shader>;
+
+// Resources of one type currently alive and the bytes they take.
+struct ResourceMemory
+{
+    std::size_t count;
+    std::size_t bytes;
+};
+
+// Slots of one resource type. Resources are constructed in place and never
+// move, as the slots live in a deque; freed slots are reused before new ones
+// are added. Each resource is found by every path it was loaded from and by the
+// hash of its content, and is reference counted. A released resource may still
+// be used by frames the GPU has not finished, so it is only destroyed once a
+// fence placed at its release has signaled.
+//
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+template <typename T>
+class ResourcePool
+{
+  public:
+    ResourcePool() = default;
+    ~ResourcePool()
+    {
+        for (const Retired& retired : _retired)
+        {
+            glDeleteSync(retired.fence);
+        }
+    }
+
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    // Reference to the resource loaded from the path or with the content hash,
+    // a null handle if there is none. A found resource gains a reference.
+    Handle<T> find(const std::string& path)
+    {
+        auto found = _byPath.find(path);
+        return found == _byPath.end() ? Handle<T>{} : reference(found->second);
+    }
+    Handle<T> findContent(std::uint64_t contentHash)
+    {
+        auto found = _byContent.find(contentHash);
+        return found == _byContent.end() ? Handle<T>{} : reference(found->second);
+    }
+
+    // Also find the resource by another path with the same content.
+    void addPath(Handle<T> handle, const std::string& path)
+    {
+        _slots[handle.index].paths.push_back(path);
+        _byPath.emplace(path, handle.index);
+    }
+
+    // Construct a resource with one reference. A content hash of zero is not indexed.
+    // The slot is only taken once the resource is constructed, so a constructor
+    // that throws leaves it free.
+    template <typename... Arguments>
+    Handle<T> emplace(const std::string& path, std::uint64_t contentHash, Arguments&&... arguments)
+    {
+        if (_freeSlots.empty())
+        {
+            _freeSlots.push_back(static_cast<std::uint32_t>(_slots.size()));
+            _slots.emplace_back();
+        }
+        std::uint32_t index = _freeSlots.back();
+        Slot& slot = _slots[index];
+        slot.resource.emplace(std::forward<Arguments>(arguments)...);
+        _freeSlots.pop_back();
+        slot.references = 1;
+        slot.bytes = slot.resource->byteSize();
+        slot.paths.assign(1, path);
+        slot.contentHash = contentHash;
+        _byPath.emplace(path, index);
+        if (contentHash != 0)
+        {
+            _byContent.emplace(contentHash, index);
+        }
+        _memory.count++;
+        _memory.bytes += slot.bytes;
+        return Handle<T>{index, slot.generation};
+    }
+
+    // The resource, nullptr if the handle is null or was released.
+    T* get(Handle<T> handle)
+    {
+        return valid(handle) ? &*_slots[handle.index].resource : nullptr;
+    }
+
+    bool valid(Handle<T> handle) const
+    {
+        return handle && handle.index < _slots.size() &&
+               _slots[handle.index].generation == handle.generation;
+    }
+
+    void retain(Handle<T> handle)
+    {
+        if (valid(handle))
+        {
+            _slots[handle.index].references++;
+        }
+    }
+
+    // Drop a reference. Without references the resource can no longer be found
+    // or reached through its handles, and is destroyed by a later collect().
+    void release(Handle<T> handle)
+    {
+        if (!valid(handle))
+        {
+            return;
+        }
+        Slot& slot = _slots[handle.index];
+        if (--slot.references > 0)
+        {
+            return;
+        }
+        for (const std::string& path : slot.paths)
+        {
+            _byPath.erase(path);
+        }
+        if (slot.contentHash != 0)
+        {
+            _byContent.erase(slot.contentHash);
+        }
+        // Zero is the null handle's generation, skip it on wrap around.
+        slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+        _retired.push_back(Retired{handle.index, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+    }
+
+    // Destroy released resources whose fence has signaled and free their slots.
+    void collect()
+    {
+        std::erase_if(_retired, [this](const Retired& retired) {
+            if (glClientWaitSync(retired.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                return false;
+            }
+            glDeleteSync(retired.fence);
+            Slot& slot = _slots[retired.index];
+            _memory.count--;
+            _memory.bytes -= slot.bytes;
+            slot.resource.reset();
+            slot.paths.clear();
+            _freeSlots.push_back(retired.index);
+            return true;
+        });
+    }
+
+    // Every resource not yet destroyed, including released ones.
+    ResourceMemory memory() const
+    {
+        return _memory;
+    }
+
+  private:
+    struct Slot
+    {
+        std::optional<T> resource;
+        std::uint32_t generation = 1;
+        std::uint32_t references = 0;
+        std::size_t bytes = 0;
+        std::vector<std::string> paths;
+        std::uint64_t contentHash = 0;
+    };
+
+    struct Retired
+    {
+        std::uint32_t index;
+        GLsync fence;
+    };
+
+    std::deque<Slot> _slots;
+    std::vector<std::uint32_t> _freeSlots;
+    std::unordered_map<std::string, std::uint32_t> _byPath;
+    std::unordered_map<std::uint64_t, std::uint32_t> _byContent;
+    std::vector<Retired> _retired;
+    ResourceMemory _memory{};
+
+    Handle<T> reference(std::uint32_t index)
+    {
+        _slots[index].references++;
+        return Handle<T>{index, _slots[index].generation};
+    }
+};
+
+// Loads meshes and shaders once however often they are asked for: a repeated
+// path, or another path to the same content, returns the loaded resource.
+//
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+class ResourceManager
+{
+  public:
+    ResourceManager() = default;
+
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    // Each load returns a handle holding one reference, to be released when done.
+    MeshHandle loadMesh(const std::string& path);
+    ShaderHandle loadShader(const std::string& vertexPath, const std::string& fragmentPath);
+
+    template <typename T>
+    T* get(Handle<T> handle)
+    {
+        return pool<T>().get(handle);
+    }
+    template <typename T>
+    void retain(Handle<T> handle)
+    {
+        pool<T>().retain(handle);
+    }
+    template <typename T>
+    void release(Handle<T> handle)
+    {
+        pool<T>().release(handle);
+    }
+
+    // Destroy released resources the GPU is done with. Call once per frame.
+    void collect();
+
+    ResourceMemory meshMemory() const;
+    ResourceMemory shaderMemory() const;
+
+  private:
+    ResourcePool<Mesh> _meshes;
+    ResourcePool<Shader> _shaders;
+
+    template <typename T>
+    ResourcePool<T>& pool()
+    {
+        if constexpr (std::is_same_v<T, Mesh>)
+        {
+            return _meshes;
+        }
+        else
+        {
+            static_assert(std::is_same_v<T, Shader>, "Not a managed resource type");
+            return _shaders;
+        }
+    }
+};
@@ -0,0 +1,122 @@
+#include "scene_graph.h"
+#include <algorithm>
+
+void SceneGraph::reserve(std::size_t nodeCount)
+{
+    _parents.reserve(nodeCount);
+    _translations.reserve(nodeCount);
+    _rotations.reserve(nodeCount);
+    _scales.reserve(nodeCount);
+    _worldMatrices.reserve(nodeCount);
+    _dirty.reserve(nodeCount);
+}
+
+SceneGraph::Node SceneGraph::addNode(
+    Node parent, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale
+)
+{
+    auto node = static_cast<Node>(_parents.size());
+    _parents.push_back(parent < node ? parent : NoParent);
+    _translations.push_back(translation);
+    _rotations.push_back(rotation);
+    _scales.push_back(scale);
+    _worldMatrices.emplace_back(1.0f);
+    _dirty.push_back(0);
+    markDirty(node);
+    return node;
+}
+
+std::size_t SceneGraph::size() const
+{
+    return _parents.size();
+}
+
+SceneGraph::Node SceneGraph::parent(Node node) const
+{
+    return _parents[node];
+}
+
+const glm::vec3& SceneGraph::translation(Node node) const
+{
+    return _translations[node];
+}
+
+const glm::quat& SceneGraph::rotation(Node node) const
+{
+    return _rotations[node];
+}
+
+const glm::vec3& SceneGraph::scale(Node node) const
+{
+    return _scales[node];
+}
+
+void SceneGraph::setTranslation(Node node, const glm::vec3& translation)
+{
+    _translations[node] = translation;
+    markDirty(node);
+}
+
+void SceneGraph::setRotation(Node node, const glm::quat& rotation)
+{
+    _rotations[node] = rotation;
+    markDirty(node);
+}
+
+void SceneGraph::setScale(Node node, const glm::vec3& scale)
+{
+    _scales[node] = scale;
+    markDirty(node);
+}
+
+void SceneGraph::update()
+{
+    std::size_t nodeCount = _parents.size();
+    if (_firstDirty >= nodeCount)
+    {
+        return;
+    }
+    for (std::size_t node = _firstDirty; node < nodeCount; node++)
+    {
+        Node parent = _parents[node];
+        // Parents come first, so their flag is final by the time a child is reached.
+        if (parent != NoParent && _dirty[parent])
+        {
+            _dirty[node] = 1;
+        }
+        if (!_dirty[node])
+        {
+            continue;
+        }
+        glm::mat4 local = glm::mat4_cast(_rotations[node]);
+        local[0] *= _scales[node].x;
+        local[1] *= _scales[node].y;
+        local[2] *= _scales[node].z;
+        local[3] = glm::vec4(_translations[node], 1.0f);
+        _worldMatrices[node] = parent == NoParent ? local : _worldMatrices[parent] * local;
+    }
+    std::fill(_dirty.begin() + static_cast<std::ptrdiff_t>(_firstDirty), _dirty.end(), 0);
+    _firstDirty = nodeCount;
+    _version++;
+}
+
+std::uint64_t SceneGraph::version() const
+{
+    return _version;
+}
+
+std::span<const glm::mat4> SceneGraph::worldMatrices() const
+{
+    return _worldMatrices;
+}
+
+const glm::mat4& SceneGraph::worldMatrix(Node node) const
+{
+    return _worldMatrices[node];
+}
+
+void SceneGraph::markDirty(Node node)
+{
+    _dirty[node] = 1;
+    _firstDirty = std::min<std::size_t>(_firstDirty, node);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Transform hierarchy stored as structure of arrays. Nodes are only appended
+// and a parent always exists before its children, so index order is a
+// topological order: one forward pass sees every parent's world matrix before
+// the children need it. Moving a node marks it dirty; update() then recomputes
+// the dirty nodes and their descendants, starting at the first dirty index.
+class SceneGraph
+{
+  public:
+    using Node = std::uint32_t;
+    static constexpr Node NoParent = UINT32_MAX;
+
+    SceneGraph() = default;
+
+    void reserve(std::size_t nodeCount);
+    // Append a node below the parent, or a root node for NoParent. Parents that
+    // do not exist yet also make a root node.
+    Node addNode(
+        Node parent,
+        const glm::vec3& translation = glm::vec3(0.0f),
+        const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+        const glm::vec3& scale = glm::vec3(1.0f)
+    );
+    std::size_t size() const;
+
+    Node parent(Node node) const;
+    const glm::vec3& translation(Node node) const;
+    const glm::quat& rotation(Node node) const;
+    const glm::vec3& scale(Node node) const;
+    void setTranslation(Node node, const glm::vec3& translation);
+    void setRotation(Node node, const glm::quat& rotation);
+    void setScale(Node node, const glm::vec3& scale);
+
+    // Recompute the world matrices of moved nodes and everything below them.
+    void update();
+    // Number of updates that changed a world matrix, to tell whether the
+    // scene needs drawing again.
+    std::uint64_t version() const;
+    // World matrix of every node in node order, valid after update().
+    std::span<const glm::mat4> worldMatrices() const;
+    const glm::mat4& worldMatrix(Node node) const;
+
+  private:
+    std::vector<Node> _parents;
+    std::vector<glm::vec3> _translations;
+    std::vector<glm::quat> _rotations;
+    std::vector<glm::vec3> _scales;
+    std::vector<glm::mat4> _worldMatrices;
+    std::vector<std::uint8_t> _dirty;
+    // Nodes before this index are all up to date.
+    std::size_t _firstDirty = 0;
+    std::uint64_t _version = 0;
+
+    void markDirty(Node node);
+};
@@ -9,8 +9,11 @@
 #include <iostream>
 #include <utility>
 
+#include "cpu_profiler.h"
+
 Shader::Shader(const std::string& vertexFilename, const std::string& fragmentFilename) : _id{}
 {
+    ZONE("Shader::Shader");
     std::string vertexSource;
     std::string fragmentSource;
     std::ifstream vertexShaderFile;
@@ -144,6 +147,16 @@ GLuint Shader::id() const
     return _id;
 }
 
+std::size_t Shader::byteSize() const
+{
+    GLint length = 0;
+    if (_id != 0)
+    {
+        glGetProgramiv(_id, GL_PROGRAM_BINARY_LENGTH, &length);
+    }
+    return static_cast<std::size_t>(length);
+}
+
 GLint Shader::getUniformInt(const std::string& name) const
 {
     GLint value;
@@ -202,55 +215,66 @@ glm::mat4 Shader::getUniformMat4(const std::string& name) const
 
 void Shader::setUniformInt(const std::string& name, GLint value)
 {
+    ZONE("Shader::setUniformInt");
     glUniform1i(glGetUniformLocation(_id, name.c_str()), value);
 }
 
 void Shader::setUniformFloat(const std::string& name, GLfloat value)
 {
+    ZONE("Shader::setUniformFloat");
     glUniform1f(glGetUniformLocation(_id, name.c_str()), value);
 }
 
 void Shader::setUniformVec2(const std::string& name, const glm::vec2& vec)
 {
+    ZONE("Shader::setUniformVec2");
     glUniform2fv(glGetUniformLocation(_id, name.c_str()), 1, glm::value_ptr(vec));
 }
 
 void Shader::setUniformVec2(const std::string& name, GLfloat x, GLfloat y)
 {
+    ZONE("Shader::setUniformVec2");
     glUniform2f(glGetUniformLocation(_id, name.c_str()), x, y);
 }
 
 void Shader::setUniformVec3(const std::string& name, const glm::vec3& vec)
 {
+    ZONE("Shader::setUniformVec3");
     glUniform3fv(glGetUniformLocation(_id, name.c_str()), 1, glm::value_ptr(vec));
 }
 
 void Shader::setUniformVec3(const std::string& name, GLfloat x, GLfloat y, GLfloat z)
 {
+    ZONE("Shader::setUniformVec3");
     glUniform3f(glGetUniformLocation(_id, name.c_str()), x, y, z);
 }
 
 void Shader::setUniformVec4(const std::string& name, const glm::vec4& vec)
 {
+    ZONE("Shader::setUniformVec4");
     glUniform4fv(glGetUniformLocation(_id, name.c_str()), 1, glm::value_ptr(vec));
 }
 
 void Shader::setUniformVec4(const std::string& name, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
+    ZONE("Shader::setUniformVec4");
     glUniform4f(glGetUniformLocation(_id, name.c_str()), x, y, z, w);
 }
 
 void Shader::setUniformMat2(const std::string& name, const glm::mat2& mat)
 {
+    ZONE("Shader::setUniformMat2");
     glUniformMatrix2fv(glGetUniformLocation(_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setUniformMat3(const std::string& name, const glm::mat3& mat)
 {
+    ZONE("Shader::setUniformMat3");
     glUniformMatrix3fv(glGetUniformLocation(_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setUniformMat4(const std::string& name, const glm::mat4& mat)
 {
+    ZONE("Shader::setUniformMat4");
     glUniformMatrix4fv(glGetUniformLocation(_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstddef>
 #include <string>
 
 class Shader
@@ -20,6 +21,8 @@ class Shader
 
     // ID given by OpenGL for this program object.
     GLuint id() const;
+    // Size of the linked program binary, an estimate of the driver memory it takes.
+    std::size_t byteSize() const;
 
     // Get the value of the uniform with the given name in this shader program.
     GLint getUniformInt(const std::string& name) const;
@@ -0,0 +1,197 @@
+#include "texture_residency.h"
+#include <glad/glad.h>
+#include <logging/logs.h>
+#include <algorithm>
+#include <format>
+
+TextureResidency::TextureResidency(GLADloadproc loadProc, bool allowBindless)
+    : _getTextureHandle{},
+      _makeTextureHandleResident{},
+      _makeTextureHandleNonResident{},
+      _pools(),
+      _slots(),
+      _handles(),
+      _bindlessSlots(),
+      _handleBuffer(),
+      _uploadedHandleCount{},
+      _handleBufferCapacity{}
+{
+    if (allowBindless && hasExtension("GL_ARB_bindless_texture"))
+    {
+        _getTextureHandle =
+            reinterpret_cast<GetTextureHandle>(loadProc("glGetTextureHandleARB"));
+        _makeTextureHandleResident = reinterpret_cast<MakeTextureHandleResident>(
+            loadProc("glMakeTextureHandleResidentARB")
+        );
+        _makeTextureHandleNonResident = reinterpret_cast<MakeTextureHandleNonResident>(
+            loadProc("glMakeTextureHandleNonResidentARB")
+        );
+        if (_getTextureHandle == nullptr || _makeTextureHandleResident == nullptr ||
+            _makeTextureHandleNonResident == nullptr)
+        {
+            logging::error("GL_ARB_bindless_texture is advertised but its functions are missing");
+            _getTextureHandle = nullptr;
+        }
+    }
+
+    logging::info(
+        std::format("Texture residency: {}", bindless() ? "bindless handles" : "texture arrays")
+    );
+}
+
+TextureResidency::~TextureResidency()
+{
+    if (bindless())
+    {
+        for (GLuint64 handle : _handles)
+        {
+            _makeTextureHandleNonResident(handle);
+        }
+    }
+    for (const Pool& pool : _pools)
+    {
+        glDeleteTextures(1, &pool.texture);
+    }
+}
+
+bool TextureResidency::bindless() const
+{
+    return _getTextureHandle != nullptr;
+}
+
+TextureResidency::Slot TextureResidency::add(
+    GLuint texture, const TextureStreamer::TextureInfo& info
+)
+{
+    auto slot = static_cast<Slot>(_slots.size());
+    if (bindless())
+    {
+        auto [found, inserted] = _bindlessSlots.try_emplace(texture, slot);
+        if (!inserted)
+        {
+            return found->second;
+        }
+        // The texture's sampling state is baked into the handle and frozen from here on.
+        GLuint64 handle = _getTextureHandle(texture);
+        _makeTextureHandleResident(handle);
+        _handles.push_back(handle);
+        _slots.push_back(SlotEntry{0, slot});
+        return slot;
+    }
+
+    std::uint32_t poolIndex = findPool(info);
+    Pool& pool = _pools[poolIndex];
+    auto layer = static_cast<std::uint32_t>(pool.layerCount++);
+    for (GLsizei level = 0; level < info.levelCount; level++)
+    {
+        glCopyImageSubData(
+            texture,
+            GL_TEXTURE_2D,
+            level,
+            0,
+            0,
+            0,
+            pool.texture,
+            GL_TEXTURE_2D_ARRAY,
+            level,
+            0,
+            0,
+            static_cast<GLint>(layer),
+            std::max(info.width >> level, 1),
+            std::max(info.height >> level, 1),
+            1
+        );
+    }
+    _slots.push_back(SlotEntry{poolIndex, layer});
+    return slot;
+}
+
+std::uint32_t TextureResidency::shaderIndex(Slot slot) const
+{
+    return _slots[slot].layer;
+}
+
+std::uint32_t TextureResidency::pool(Slot slot) const
+{
+    return _slots[slot].pool;
+}
+
+std::size_t TextureResidency::poolCount() const
+{
+    return bindless() ? 1 : _pools.size();
+}
+
+void TextureResidency::bindHandles(GLuint binding)
+{
+    if (_uploadedHandleCount < _handles.size())
+    {
+        if (_handles.size() > _handleBufferCapacity)
+        {
+            _handleBufferCapacity = std::max<std::size_t>(_handleBufferCapacity * 2, 64);
+            _handleBufferCapacity = std::max(_handleBufferCapacity, _handles.size());
+            _handleBuffer.data(
+                static_cast<GLsizeiptr>(_handleBufferCapacity * sizeof(GLuint64)),
+                nullptr,
+                GL_DYNAMIC_DRAW
+            );
+            _uploadedHandleCount = 0;
+        }
+        _handleBuffer.subData(
+            static_cast<GLintptr>(_uploadedHandleCount * sizeof(GLuint64)),
+            static_cast<GLsizeiptr>((_handles.size() - _uploadedHandleCount) * sizeof(GLuint64)),
+            _handles.data() + _uploadedHandleCount
+        );
+        _uploadedHandleCount = _handles.size();
+    }
+    _handleBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, binding);
+}
+
+void TextureResidency::bindPool(std::uint32_t pool, GLuint unit) const
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _pools[pool].texture);
+}
+
+std::uint32_t TextureResidency::findPool(const TextureStreamer::TextureInfo& info)
+{
+    for (std::uint32_t i = 0; i < _pools.size(); i++)
+    {
+        const Pool& pool = _pools[i];
+        if (pool.info.width == info.width && pool.info.height == info.height &&
+            pool.info.internalFormat == info.internalFormat &&
+            pool.info.levelCount == info.levelCount && pool.layerCount < PoolLayerCount)
+        {
+            return i;
+        }
+    }
+
+    Pool pool{0, info, 0};
+    glGenTextures(1, &pool.texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, pool.texture);
+    glTexStorage3D(
+        GL_TEXTURE_2D_ARRAY,
+        info.levelCount,
+        info.internalFormat,
+        info.width,
+        info.height,
+        PoolLayerCount
+    );
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(
+        GL_TEXTURE_2D_ARRAY,
+        GL_TEXTURE_MIN_FILTER,
+        info.levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR
+    );
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    logging::debug(std::format(
+        "Texture array pool {} created: {}x{}, {} levels, {} layers",
+        _pools.size(),
+        info.width,
+        info.height,
+        info.levelCount,
+        PoolLayerCount
+    ));
+    _pools.push_back(pool);
+    return static_cast<std::uint32_t>(_pools.size() - 1);
+}
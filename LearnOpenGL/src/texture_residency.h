@@ -0,0 +1,90 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "gl_objects.h"
+#include "texture_streamer.h"
+
+// Makes textures addressable from shaders by index, so draws using different
+// textures do not need a texture bind between them.
+//
+// With GL_ARB_bindless_texture, every texture gets a resident 64-bit handle and
+// the handles are stored in a shader storage buffer indexed by slot. Without it,
+// textures are copied into GL_TEXTURE_2D_ARRAY pools shared by textures of the
+// same size, format and level count, and a slot is addressed by its pool and layer.
+// Draws can then be batched per pool.
+//
+// Must be created, used and destroyed on the thread owning the OpenGL context.
+class TextureResidency
+{
+  public:
+    using Slot = std::uint32_t;
+
+    // Uses bindless handles when allowed and supported by the current context.
+    // The extension functions are not part of the loader and are looked up
+    // through the given function.
+    TextureResidency(GLADloadproc loadProc, bool allowBindless);
+    ~TextureResidency();
+
+    TextureResidency(const TextureResidency&) = delete;
+    TextureResidency& operator=(const TextureResidency&) = delete;
+
+    bool bindless() const;
+
+    // Make the texture addressable. Bindless handles reference the texture,
+    // so it must outlive this object, and adding it again returns its slot, as
+    // streamed textures with the same content share one object. Array pools
+    // hold a copy of it, so the texture may be released once added.
+    Slot add(GLuint texture, const TextureStreamer::TextureInfo& info);
+
+    // Index shaders use to look up the slot's texture: the slot itself for
+    // bindless handles, the layer within its pool otherwise.
+    std::uint32_t shaderIndex(Slot slot) const;
+    // Pool holding the slot, always 0 for bindless handles.
+    std::uint32_t pool(Slot slot) const;
+    std::size_t poolCount() const;
+
+    // Bind the handle buffer as a shader storage buffer. Only for bindless handles.
+    void bindHandles(GLuint binding);
+    // Bind the texture array of the pool. Only for array pools.
+    void bindPool(std::uint32_t pool, GLuint unit) const;
+
+  private:
+    // Layers allocated for each texture array. Full pools get a sibling pool.
+    static constexpr GLsizei PoolLayerCount = 64;
+
+    using GetTextureHandle = GLuint64(APIENTRYP)(GLuint texture);
+    using MakeTextureHandleResident = void(APIENTRYP)(GLuint64 handle);
+    using MakeTextureHandleNonResident = void(APIENTRYP)(GLuint64 handle);
+
+    struct Pool
+    {
+        GLuint texture;
+        TextureStreamer::TextureInfo info;
+        GLsizei layerCount;
+    };
+
+    struct SlotEntry
+    {
+        std::uint32_t pool;
+        std::uint32_t layer;
+    };
+
+    GetTextureHandle _getTextureHandle;
+    MakeTextureHandleResident _makeTextureHandleResident;
+    MakeTextureHandleNonResident _makeTextureHandleNonResident;
+
+    std::vector<Pool> _pools;
+    std::vector<SlotEntry> _slots;
+    std::vector<GLuint64> _handles;
+    // Slot of each texture made resident, as a handle is made resident only once.
+    std::unordered_map<GLuint, Slot> _bindlessSlots;
+    Buffer _handleBuffer;
+    // Handles in the buffer and its capacity in handles.
+    std::size_t _uploadedHandleCount;
+    std::size_t _handleBufferCapacity;
+
+    std::uint32_t findPool(const TextureStreamer::TextureInfo& info);
+};
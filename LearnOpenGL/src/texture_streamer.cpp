@@ -0,0 +1,556 @@
+#include "texture_streamer.h"
+#include <glad/glad.h>
+#include <stb/stb_image.h>
+#include <logging/logs.h>
+#include <assets/bc_decoder.h>
+#include <assets/hash.h>
+#include <assets/image.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <system_error>
+#include <span>
+#include <utility>
+
+#include "cpu_profiler.h"
+
+// S3TC is not part of core OpenGL, so the loader does not define its tokens.
+// Without the extension these formats are decompressed before they get here.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace
+{
+
+constexpr const char* ContainerExtension = ".ltex";
+// Decoded images with their mip chains, relative to the working directory.
+constexpr const char* CacheDirectory = "cache/textures";
+// Revision of how cache entries are produced. Bump it whenever decoding or the
+// mip filter changes the texels written for the same image.
+constexpr std::uint32_t CachePipelineVersion = 1;
+// Rows are flipped on decode, as OpenGL expects them bottom to top.
+constexpr int FlipVertically = 1;
+
+// Everything besides the image file deciding the contents of a cache entry.
+struct CacheParameters
+{
+    std::uint32_t containerVersion;
+    std::uint32_t pipelineVersion;
+    assets::TextureFormat format;
+    std::int32_t flipVertically;
+};
+
+GLenum internalFormat(assets::TextureFormat format)
+{
+    switch (format)
+    {
+    case assets::TextureFormat::BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case assets::TextureFormat::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case assets::TextureFormat::BC7:
+        return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    default:
+        return GL_RGBA8;
+    }
+}
+
+}
+
+TextureStreamer::TextureStreamer(ThreadPool& threadPool)
+    : _threadPool(threadPool),
+      _entries(),
+      _idsByPath(),
+      _idsByContent(),
+      _textureObjects(),
+      _placeholder(),
+      _placeholderInfo{2, 2, GL_RGBA8, 1},
+      _uploadBuffers(),
+      _nextUploadBuffer{},
+      _uploadRing(UploadRingSize),
+      _s3tcSupported{hasExtension("GL_EXT_texture_compression_s3tc")},
+      _decoded(),
+      _decodingCount{}
+{
+    // 2x2 grey checkerboard shown while the real texture is in flight.
+    // clang-format off
+    const GLubyte placeholderPixels[] = {
+        160, 160, 160, 255,   96,  96,  96, 255,
+         96,  96,  96, 255,  160, 160, 160, 255,
+    };
+    // clang-format on
+    _placeholder.storage(1, GL_RGBA8, 2, 2);
+    _placeholder.subImage(0, 0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixels);
+    _placeholder.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+    _placeholder.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+    _placeholder.parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    _placeholder.parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    if (!_s3tcSupported)
+    {
+        logging::info("No S3TC support, BC1 and BC3 textures are decoded to RGBA8");
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(CacheDirectory, error);
+    if (error)
+    {
+        logging::error(
+            std::format("Failed to create texture cache directory: {}", error.message())
+        );
+    }
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    {
+        std::unique_lock lock(_decodedMutex);
+        _decodingFinished.wait(lock, [this] { return _decodingCount == 0; });
+        _decoded.clear();
+    }
+}
+
+TextureStreamer::TextureId TextureStreamer::request(const std::string& path)
+{
+    auto [found, inserted] = _idsByPath.emplace(path, static_cast<TextureId>(_entries.size()));
+    if (!inserted)
+    {
+        return found->second;
+    }
+    TextureId id = found->second;
+    _entries.push_back(Entry{path, _placeholder.id(), _placeholderInfo, State::Decoding, 0});
+    {
+        std::lock_guard lock(_decodedMutex);
+        _decodingCount++;
+    }
+    _threadPool.submit([this, id, path] { decode(id, path); });
+    return id;
+}
+
+void TextureStreamer::update(std::chrono::microseconds budget)
+{
+    auto start = std::chrono::steady_clock::now();
+    _uploadRing.collect();
+    bool uploadedAny = false;
+    while (!uploadedAny || std::chrono::steady_clock::now() - start < budget)
+    {
+        DecodedImage image{};
+        {
+            std::lock_guard lock(_decodedMutex);
+            if (_decoded.empty())
+            {
+                break;
+            }
+            image = std::move(_decoded.front());
+            _decoded.pop_front();
+        }
+        upload(image);
+        uploadedAny = true;
+    }
+}
+
+GLuint TextureStreamer::texture(TextureId id) const
+{
+    return _entries[id].texture;
+}
+
+const TextureStreamer::TextureInfo& TextureStreamer::info(TextureId id) const
+{
+    return _entries[id].info;
+}
+
+bool TextureStreamer::resident(TextureId id) const
+{
+    return _entries[id].state == State::Resident;
+}
+
+void TextureStreamer::release(TextureId id)
+{
+    Entry& entry = _entries[id];
+    GLuint texture = entry.texture;
+    if (entry.state != State::Resident || texture == 0)
+    {
+        return;
+    }
+    entry.texture = 0;
+    auto content = std::find_if(_idsByContent.begin(), _idsByContent.end(), [&](const auto& pair) {
+        return pair.second == id;
+    });
+
+    // Another entry still using the object takes over its bytes, and later
+    // requests of the same content share the object through it.
+    auto sharer = std::find_if(_entries.begin(), _entries.end(), [&](const Entry& other) {
+        return other.texture == texture;
+    });
+    if (sharer != _entries.end())
+    {
+        sharer->bytes += std::exchange(entry.bytes, 0);
+        if (content != _idsByContent.end())
+        {
+            content->second = static_cast<TextureId>(sharer - _entries.begin());
+        }
+        return;
+    }
+
+    if (content != _idsByContent.end())
+    {
+        _idsByContent.erase(content);
+    }
+    entry.bytes = 0;
+    std::erase_if(_textureObjects, [&](const Texture2D& object) { return object.id() == texture; });
+    logging::debug(std::format("Texture released: {}", entry.path));
+}
+
+std::size_t TextureStreamer::pendingCount() const
+{
+    return std::count_if(_entries.begin(), _entries.end(), [](const Entry& entry) {
+        return entry.state == State::Decoding;
+    });
+}
+
+std::size_t TextureStreamer::textureCount() const
+{
+    return std::count_if(_entries.begin(), _entries.end(), [](const Entry& entry) {
+        return entry.bytes > 0;
+    });
+}
+
+std::size_t TextureStreamer::memoryBytes() const
+{
+    std::size_t bytes = 0;
+    for (const Entry& entry : _entries)
+    {
+        bytes += entry.bytes;
+    }
+    return bytes;
+}
+
+void TextureStreamer::decode(TextureId id, std::string path)
+{
+    DecodedImage image{id};
+    std::filesystem::path containerPath = std::filesystem::path(path).replace_extension(
+        ContainerExtension
+    );
+    std::error_code error;
+    bool loaded = std::filesystem::exists(containerPath, error)
+                      ? readContainer(containerPath.string(), image)
+                      : loadImage(path, image);
+    if (!loaded)
+    {
+        image.data = {};
+    }
+    else if (!_s3tcSupported && (image.format == assets::TextureFormat::BC1 ||
+                                 image.format == assets::TextureFormat::BC3))
+    {
+        decompress(image);
+    }
+    else if (image.mapping.isOpen())
+    {
+        // Copy containers into the upload ring here rather than on the OpenGL
+        // thread. Without room they stay mapped and are copied on upload.
+        if (std::optional<UploadRing::Region> region = _uploadRing.allocate(image.data.size()))
+        {
+            ZONE("Stage texture");
+            std::memcpy(region->memory.data(), image.data.data(), image.data.size());
+            image.data = region->memory;
+            image.staged = region;
+            image.mapping = {};
+        }
+    }
+
+    // Notify under the lock, the streamer may be destroyed as soon as it is released.
+    std::lock_guard lock(_decodedMutex);
+    _decoded.push_back(std::move(image));
+    _decodingCount--;
+    _decodingFinished.notify_all();
+}
+
+bool TextureStreamer::loadImage(const std::string& path, DecodedImage& image)
+{
+    assets::MappedFile file(path);
+    if (!file.isOpen())
+    {
+        logging::error(std::format("Failed to open texture {}", path));
+        return false;
+    }
+
+    // Cache entries are named after the hash of the encoded image and of the
+    // parameters producing the entry, so edited files or a changed pipeline get
+    // a new entry, and renamed or copied files share one.
+    std::uint64_t hash = assets::hashBytes(file.bytes());
+    image.contentHash = hash;
+    const CacheParameters parameters{
+        assets::TextureVersion, CachePipelineVersion, assets::TextureFormat::RGBA8, FlipVertically
+    };
+    std::uint64_t key = assets::hashBytes(std::as_bytes(std::span(&parameters, 1)), hash);
+    std::filesystem::path cachePath =
+        std::filesystem::path(CacheDirectory) / std::format("{:016x}{}", key, ContainerExtension);
+    std::error_code error;
+    if (std::filesystem::exists(cachePath, error) && readContainer(cachePath.string(), image))
+    {
+        logging::debug(std::format("Texture cache hit: {} ({})", path, cachePath.string()));
+        return true;
+    }
+
+    int width = 0, height = 0, colorChannelCount = 0;
+    unsigned char* pixels = nullptr;
+    {
+        ZONE("stbi_load_from_memory");
+        stbi_set_flip_vertically_on_load_thread(FlipVertically);
+        pixels = stbi_load_from_memory(
+            reinterpret_cast<const stbi_uc*>(file.bytes().data()),
+            static_cast<int>(file.bytes().size()),
+            &width,
+            &height,
+            &colorChannelCount,
+            STBI_rgb_alpha
+        );
+    }
+    if (pixels == nullptr)
+    {
+        logging::error(
+            std::format("Failed to decode texture {}: {}", path, stbi_failure_reason())
+        );
+        return false;
+    }
+    assets::Image base{static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)};
+    base.pixels.assign(pixels, pixels + std::size_t{base.width} * base.height * 4);
+    stbi_image_free(pixels);
+
+    std::vector<assets::Image> mipChain = assets::generateMipChain(std::move(base));
+    std::vector<std::vector<std::uint8_t>> levelData(mipChain.size());
+    image.format = parameters.format;
+    image.width = mipChain.front().width;
+    image.height = mipChain.front().height;
+    image.levels.resize(mipChain.size());
+    std::uint64_t offset = 0;
+    for (std::size_t level = 0; level < mipChain.size(); level++)
+    {
+        levelData[level] = std::move(mipChain[level].pixels);
+        image.levels[level] = assets::TextureLevel{offset, levelData[level].size()};
+        offset += levelData[level].size();
+    }
+    // Lay the levels out in the upload ring if it has room, so the OpenGL thread
+    // only has to start the transfer.
+    std::span<std::uint8_t> destination = reserve(image, offset);
+    for (std::size_t level = 0; level < levelData.size(); level++)
+    {
+        std::memcpy(
+            destination.data() + image.levels[level].offset,
+            levelData[level].data(),
+            levelData[level].size()
+        );
+    }
+    image.data = destination;
+
+    // Write under a temporary name first so other loaders never map a partial file.
+    std::string temporaryPath = std::format("{}.{}.tmp", cachePath.string(), image.id);
+    if (assets::writeTextureContainer(
+            temporaryPath, image.format, image.width, image.height, levelData
+        ))
+    {
+        std::filesystem::rename(temporaryPath, cachePath, error);
+    }
+    else
+    {
+        error = std::make_error_code(std::errc::io_error);
+    }
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        logging::debug(std::format("Failed to write texture cache entry for {}", path));
+    }
+    return true;
+}
+
+bool TextureStreamer::readContainer(const std::string& path, DecodedImage& image)
+{
+    image.mapping = assets::MappedFile(path);
+    if (!image.mapping.isOpen())
+    {
+        logging::error(std::format("Failed to open texture container {}", path));
+        return false;
+    }
+
+    assets::TextureHeader header{};
+    auto levels = assets::readTextureLevels(image.mapping.bytes(), header);
+    if (levels.empty())
+    {
+        logging::error(std::format("Invalid texture container {}", path));
+        image.mapping = {};
+        return false;
+    }
+    // Images read through the cache keep the hash of the image file.
+    if (image.contentHash == 0)
+    {
+        image.contentHash = assets::hashBytes(image.mapping.bytes());
+    }
+    image.format = header.format;
+    image.width = header.width;
+    image.height = header.height;
+    image.levels.assign(levels.begin(), levels.end());
+    image.data = std::span(
+        reinterpret_cast<const std::uint8_t*>(image.mapping.bytes().data()),
+        image.mapping.bytes().size()
+    );
+    return true;
+}
+
+void TextureStreamer::decompress(DecodedImage& image)
+{
+    ZONE("Decompress texture");
+    std::vector<assets::TextureLevel> levels(image.levels.size());
+    std::uint64_t offset = 0;
+    for (std::uint32_t level = 0; level < levels.size(); level++)
+    {
+        std::uint64_t size = assets::levelSize(
+            assets::TextureFormat::RGBA8,
+            assets::levelDimension(image.width, level),
+            assets::levelDimension(image.height, level)
+        );
+        levels[level] = assets::TextureLevel{offset, size};
+        offset += size;
+    }
+
+    std::span<std::uint8_t> destination = reserve(image, offset);
+    for (std::uint32_t level = 0; level < levels.size(); level++)
+    {
+        assets::decodeImage(
+            image.data.subspan(image.levels[level].offset, image.levels[level].size),
+            image.format,
+            assets::levelDimension(image.width, level),
+            assets::levelDimension(image.height, level),
+            destination.subspan(levels[level].offset, levels[level].size)
+        );
+    }
+    image.format = assets::TextureFormat::RGBA8;
+    image.levels = std::move(levels);
+    image.data = destination;
+    image.mapping = {};
+}
+
+std::span<std::uint8_t> TextureStreamer::reserve(DecodedImage& image, std::size_t size)
+{
+    image.staged = _uploadRing.allocate(size);
+    if (image.staged)
+    {
+        return image.staged->memory;
+    }
+    image.pixels.resize(size);
+    return image.pixels;
+}
+
+void TextureStreamer::upload(const DecodedImage& image)
+{
+    Entry& entry = _entries[image.id];
+    if (image.data.empty())
+    {
+        entry.state = State::Failed;
+        return;
+    }
+    auto [found, inserted] = _idsByContent.emplace(image.contentHash, image.id);
+    if (!inserted)
+    {
+        const Entry& original = _entries[found->second];
+        entry.texture = original.texture;
+        entry.info = original.info;
+        entry.state = State::Resident;
+        if (image.staged)
+        {
+            _uploadRing.retire(*image.staged);
+        }
+        logging::debug(
+            std::format("Texture resident: {} (shares {})", entry.path, original.path)
+        );
+        return;
+    }
+
+    // Texels staged by the decoding job are already in the upload ring. Others
+    // are copied into a freshly orphaned pixel buffer, so the transfer into the
+    // texture still happens asynchronously and never waits on earlier uploads.
+    const Buffer* source = &_uploadRing.buffer();
+    std::size_t sourceOffset = image.staged ? image.staged->offset : 0;
+    if (!image.staged)
+    {
+        auto size = static_cast<GLsizeiptr>(image.data.size());
+        Buffer& uploadBuffer = _uploadBuffers[_nextUploadBuffer];
+        _nextUploadBuffer = (_nextUploadBuffer + 1) % _uploadBuffers.size();
+        uploadBuffer.data(size, nullptr, GL_STREAM_DRAW);
+        void* mapped =
+            uploadBuffer.map(0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (mapped == nullptr)
+        {
+            logging::error(std::format("Failed to map pixel buffer for texture {}", entry.path));
+            _idsByContent.erase(found);
+            entry.state = State::Failed;
+            return;
+        }
+        std::memcpy(mapped, image.data.data(), image.data.size());
+        uploadBuffer.unmap();
+        source = &uploadBuffer;
+    }
+
+    // Only the transfer binds anything: texel sources are read from the bound
+    // pixel unpack buffer, with or without direct state access.
+    auto levelCount = static_cast<GLsizei>(image.levels.size());
+    GLenum format = internalFormat(image.format);
+    Texture2D texture{};
+    texture.storage(
+        levelCount, format, static_cast<GLsizei>(image.width), static_cast<GLsizei>(image.height)
+    );
+    source->bind(GL_PIXEL_UNPACK_BUFFER);
+    for (std::uint32_t level = 0; level < image.levels.size(); level++)
+    {
+        auto width = static_cast<GLsizei>(assets::levelDimension(image.width, level));
+        auto height = static_cast<GLsizei>(assets::levelDimension(image.height, level));
+        auto offset = reinterpret_cast<const void*>(sourceOffset + image.levels[level].offset);
+        if (assets::isBlockCompressed(image.format))
+        {
+            texture.compressedSubImage(
+                static_cast<GLint>(level),
+                0,
+                0,
+                width,
+                height,
+                format,
+                static_cast<GLsizei>(image.levels[level].size),
+                offset
+            );
+        }
+        else
+        {
+            texture.subImage(
+                static_cast<GLint>(level), 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, offset
+            );
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (image.staged)
+    {
+        _uploadRing.retire(*image.staged);
+    }
+    texture.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+    texture.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+    texture.parameter(GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    texture.parameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    entry.texture = texture.id();
+    _textureObjects.push_back(std::move(texture));
+    entry.info = TextureInfo{
+        static_cast<GLsizei>(image.width), static_cast<GLsizei>(image.height), format, levelCount
+    };
+    entry.state = State::Resident;
+    entry.bytes = 0;
+    for (const assets::TextureLevel& level : image.levels)
+    {
+        entry.bytes += static_cast<std::size_t>(level.size);
+    }
+    logging::debug(
+        std::format("Texture resident: {} ({}x{})", entry.path, image.width, image.height)
+    );
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <glad/glad.h>
+#include <assets/mapped_file.h>
+#include <assets/texture_container.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gl_objects.h"
+#include "thread_pool.h"
+#include "upload_ring.h"
+
+// Loads textures in the background. Files are decoded on the thread pool
+// straight into a persistently mapped pixel buffer, from which the OpenGL
+// thread transfers them into immutable texture storage, a few textures per
+// frame. When the buffer is full, or cannot be mapped persistently, texels are
+// decoded into memory of their own and copied into a pixel buffer on upload.
+// Until a texture is resident, a placeholder texture is handed out in its place.
+//
+// Texture containers (.ltex) written by the asset tool are uploaded as they are,
+// including block-compressed formats and all of their mip levels. Where the
+// driver lacks S3TC, BC1 and BC3 containers are decoded to RGBA8 on load. Requesting an
+// image for which a container with the same name exists loads the container.
+// Other images are decoded once, given a mip chain on the CPU and kept in an
+// on-disk cache keyed by the hash of the image file and of the parameters
+// decoding it, so later runs only map the cached container.
+//
+// Requesting a path twice returns the same id. Textures with the same content
+// under different paths share one texture object.
+//
+// All member functions except the decoding jobs must be called on the thread
+// owning the OpenGL context.
+class TextureStreamer
+{
+  public:
+    using TextureId = std::uint32_t;
+
+    // Immutable storage of a texture object.
+    struct TextureInfo
+    {
+        GLsizei width;
+        GLsizei height;
+        GLenum internalFormat;
+        GLsizei levelCount;
+    };
+
+    explicit TextureStreamer(ThreadPool& threadPool);
+    // Waits for decoding jobs still running on the thread pool.
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Queue the image file for decoding. The returned id is valid immediately.
+    TextureId request(const std::string& path);
+
+    // Upload decoded textures until the time budget is spent. At least one
+    // texture is uploaded per call if any is ready, so loading always progresses.
+    void update(std::chrono::microseconds budget);
+
+    // Texture object to bind for the given id, the placeholder until it is
+    // resident and zero once released.
+    GLuint texture(TextureId id) const;
+    // Storage of the texture returned by texture(id).
+    const TextureInfo& info(TextureId id) const;
+    bool resident(TextureId id) const;
+    // Drop the texture object of a resident texture whose texels were copied
+    // elsewhere, such as into a texture array. The texture stays resident with
+    // its info. An object shared with other entries lives until all of them
+    // are released.
+    void release(TextureId id);
+
+    // Number of requested textures that are not resident and have not failed.
+    std::size_t pendingCount() const;
+    // Texture objects created for resident textures and the bytes of their
+    // storage, the placeholder aside.
+    std::size_t textureCount() const;
+    std::size_t memoryBytes() const;
+
+  private:
+    static constexpr std::size_t UploadBufferCount = 4;
+    static constexpr std::size_t UploadRingSize = 64 << 20;
+
+    enum class State
+    {
+        Decoding,
+        Resident,
+        Failed,
+    };
+
+    struct Entry
+    {
+        std::string path;
+        GLuint texture;
+        TextureInfo info;
+        State state;
+        // Storage bytes of the texture object, zero if it is shared with an
+        // earlier entry of the same content or has been released.
+        std::size_t bytes;
+    };
+
+    struct DecodedImage
+    {
+        TextureId id;
+        // Hash of the file the texels come from.
+        std::uint64_t contentHash;
+        assets::TextureFormat format;
+        std::uint32_t width;
+        std::uint32_t height;
+        // Ranges of data holding each level.
+        std::vector<assets::TextureLevel> levels;
+        // Texel data, empty if loading failed. Views the staged region of the
+        // upload ring, or else the mapped container or the decoded pixels below,
+        // all of which keep their storage when moved.
+        std::span<const std::uint8_t> data;
+        std::optional<UploadRing::Region> staged;
+        std::vector<std::uint8_t> pixels;
+        assets::MappedFile mapping;
+    };
+
+    ThreadPool& _threadPool;
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string, TextureId> _idsByPath;
+    // Resident entries by the hash of their content.
+    std::unordered_map<std::uint64_t, TextureId> _idsByContent;
+    // Texture objects of resident entries, which entries of the same content share.
+    std::vector<Texture2D> _textureObjects;
+    Texture2D _placeholder;
+    TextureInfo _placeholderInfo;
+    std::array<Buffer, UploadBufferCount> _uploadBuffers;
+    std::size_t _nextUploadBuffer;
+    // Allocated from by the decoding jobs.
+    UploadRing _uploadRing;
+    // Whether BC1 and BC3 can be uploaded, read by the decoding jobs.
+    bool _s3tcSupported;
+
+    // Shared with the decoding jobs.
+    std::mutex _decodedMutex;
+    std::condition_variable _decodingFinished;
+    std::deque<DecodedImage> _decoded;
+    std::size_t _decodingCount;
+
+    void decode(TextureId id, std::string path);
+    // Load the image from the texture cache, or decode it and add it to the cache.
+    bool loadImage(const std::string& path, DecodedImage& image);
+    // Decode the block-compressed levels of a mapped container to RGBA8.
+    void decompress(DecodedImage& image);
+    // Memory for the image's texels: a region of the upload ring if it has
+    // room, the image's own pixels otherwise.
+    std::span<std::uint8_t> reserve(DecodedImage& image, std::size_t size);
+    static bool readContainer(const std::string& path, DecodedImage& image);
+    void upload(const DecodedImage& image);
+};
@@ -0,0 +1,68 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <utility>
+
+#include "cpu_profiler.h"
+
+ThreadPool::ThreadPool(std::size_t threadCount) : _workers(), _tasks(), _stopping(false)
+{
+    threadCount = std::max<std::size_t>(threadCount, 1);
+    _workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; i++)
+    {
+        _workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+    }
+    _taskAvailable.notify_all();
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+    _taskAvailable.notify_one();
+}
+
+std::size_t ThreadPool::threadCount() const
+{
+    return _workers.size();
+}
+
+std::size_t ThreadPool::defaultThreadCount()
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 3 ? hardwareThreads - 2 : 1;
+}
+
+void ThreadPool::work()
+{
+    PROFILER_THREAD_NAME("Worker");
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(_mutex);
+            _taskAvailable.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+            if (_tasks.empty())
+            {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads executing submitted tasks in FIFO order.
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(std::size_t threadCount = defaultThreadCount());
+    // Finish all queued tasks and join the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task for execution on one of the workers.
+    void submit(std::function<void()> task);
+
+    std::size_t threadCount() const;
+
+    // Hardware threads left after the main and render threads, at least one.
+    static std::size_t defaultThreadCount();
+
+  private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    bool _stopping;
+
+    void work();
+};
@@ -1,19 +1,122 @@
 #include "timer.h"
-#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numeric>
 
-float Timer::time() const
+#include "cpu_profiler.h"
+
+FrameTimeStatistics frameTimeStatistics(std::span<const double> frameTimes)
+{
+    if (frameTimes.empty())
+    {
+        return FrameTimeStatistics{};
+    }
+    std::vector<double> sorted(frameTimes.begin(), frameTimes.end());
+    std::sort(sorted.begin(), sorted.end());
+    double count = static_cast<double>(sorted.size());
+    double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / count;
+    double squaredDeviations = 0.0;
+    for (double frameTime : sorted)
+    {
+        squaredDeviations += (frameTime - mean) * (frameTime - mean);
+    }
+    // Nearest rank: the smallest time at least the given share of frames do not exceed.
+    auto percentile = [&](double share) {
+        auto rank = static_cast<std::size_t>(std::ceil(share * count));
+        return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    };
+    return FrameTimeStatistics{
+        sorted.size(),
+        mean,
+        std::sqrt(squaredDeviations / count),
+        percentile(0.50),
+        percentile(0.95),
+        percentile(0.99),
+        sorted.back(),
+    };
+}
+
+std::string formatFrameTimes(const FrameTimeStatistics& statistics)
+{
+    return std::format(
+        "{} frames: mean {:.3f} ms, standard deviation {:.3f} ms, p50 {:.3f} ms, "
+        "p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+        statistics.frameCount,
+        statistics.mean,
+        statistics.standardDeviation,
+        statistics.p50,
+        statistics.p95,
+        statistics.p99,
+        statistics.max
+    );
+}
+
+FrameTimeHistory::FrameTimeHistory(std::size_t size)
+    : _frameTimes(std::max<std::size_t>(size, 1)),
+      _next{},
+      _count{}
+{
+}
+
+void FrameTimeHistory::add(std::chrono::nanoseconds frameTime)
+{
+    _frameTimes[_next] = std::chrono::duration<double, std::milli>(frameTime).count();
+    _next = (_next + 1) % _frameTimes.size();
+    _count = std::min(_count + 1, _frameTimes.size());
+}
+
+FrameTimeStatistics FrameTimeHistory::statistics() const
+{
+    // Order does not matter to the statistics, so the ring needs no unwrapping.
+    return frameTimeStatistics(std::span(_frameTimes).first(_count));
+}
+
+Timer::Timer(std::size_t historySize)
+    : _start(Clock::now()),
+      _lastUpdateTime{},
+      _deltaTime{},
+      _history(historySize)
 {
-    return static_cast<float>(_lastUpdateTime);
 }
 
-float Timer::deltaTime() const
+std::chrono::nanoseconds Timer::elapsed() const
 {
-    return static_cast<float>(_deltaTime);
+    return _lastUpdateTime;
+}
+
+double Timer::time() const
+{
+    return std::chrono::duration<double>(_lastUpdateTime).count();
+}
+
+std::chrono::nanoseconds Timer::delta() const
+{
+    return _deltaTime;
+}
+
+double Timer::deltaTime() const
+{
+    return std::chrono::duration<double>(_deltaTime).count();
 }
 
 void Timer::update()
 {
-    double currentUpdateTime = glfwGetTime();
+    ZONE("Timer::update");
+    auto currentUpdateTime =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _start);
     _deltaTime = currentUpdateTime - _lastUpdateTime;
     _lastUpdateTime = currentUpdateTime;
+    _history.add(_deltaTime);
+}
+
+void Timer::restart()
+{
+    _lastUpdateTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _start);
+    _deltaTime = {};
+}
+
+FrameTimeStatistics Timer::statistics() const
+{
+    return _history.statistics();
 }
@@ -1,19 +1,74 @@
 #pragma once
-#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
 
+// Distribution of frame times in milliseconds.
+struct FrameTimeStatistics
+{
+    std::size_t frameCount;
+    double mean;
+    // Spread of frame delivery; uneven pacing shows here before it shows in the mean.
+    double standardDeviation;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+// Summarize frame times given in milliseconds, all zero if there are none.
+FrameTimeStatistics frameTimeStatistics(std::span<const double> frameTimes);
+// Describe the statistics on one line for the log.
+std::string formatFrameTimes(const FrameTimeStatistics& statistics);
+
+// Rolling window of the latest frame times.
+class FrameTimeHistory
+{
+  public:
+    static constexpr std::size_t DefaultSize = 240;
+
+    explicit FrameTimeHistory(std::size_t size = DefaultSize);
+
+    void add(std::chrono::nanoseconds frameTime);
+    FrameTimeStatistics statistics() const;
+
+  private:
+    // Ring of frame times in milliseconds, _next being the oldest once full.
+    std::vector<double> _frameTimes;
+    std::size_t _next;
+    std::size_t _count;
+};
+
+// Measures time since its construction with the steady clock, and keeps the
+// times of the latest frames.
 class Timer
 {
   public:
-    Timer() : _deltaTime{glfwGetTime()}, _lastUpdateTime{} {}
-    explicit Timer(float start) : _deltaTime{start}, _lastUpdateTime{} {}
-    // Get the time after last update in seconds.
-    float time() const;
-    // Time elapsed between the last two updates in seconds.
-    float deltaTime() const;
-    // Update the timer.
+    using Clock = std::chrono::steady_clock;
+
+    explicit Timer(std::size_t historySize = FrameTimeHistory::DefaultSize);
+    // Time at the last update in nanoseconds since construction.
+    std::chrono::nanoseconds elapsed() const;
+    // Time at the last update in seconds since construction. Doubles keep
+    // sub-microsecond precision after years, floats lose milliseconds in days.
+    double time() const;
+    // Time elapsed between the last two updates in nanoseconds and in seconds.
+    std::chrono::nanoseconds delta() const;
+    double deltaTime() const;
+    // Update the timer once per frame.
     void update();
+    // Update the time without counting a frame: the next delta starts now and
+    // the time since the last update is neither a delta nor a history sample.
+    // For time spent idle, which is not a frame to catch up on or to measure.
+    void restart();
+    // Frame times of the latest updates, up to the history size.
+    FrameTimeStatistics statistics() const;
 
   private:
-    double _deltaTime;
-    double _lastUpdateTime;
+    Clock::time_point _start;
+    std::chrono::nanoseconds _lastUpdateTime;
+    std::chrono::nanoseconds _deltaTime;
+    FrameTimeHistory _history;
 };
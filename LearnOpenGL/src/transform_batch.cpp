@@ -0,0 +1,318 @@
+#include "transform_batch.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TRANSFORM_BATCH_SSE2 1
+#endif
+// The AVX2 kernels are always built on x64 and only run on processors that have
+// AVX2, so the rest of the program keeps its baseline instruction set. MSVC
+// accepts the intrinsics anywhere, GCC and Clang only in functions targeting AVX2.
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define TRANSFORM_BATCH_AVX2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+
+#if TRANSFORM_BATCH_SSE2
+
+template <int Lane>
+__m128 splat(__m128 value)
+{
+    return _mm_shuffle_ps(value, value, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+}
+
+// Matrix columns as loaded into registers.
+struct Columns
+{
+    __m128 column[4];
+
+    explicit Columns(const glm::mat4& matrix)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            column[i] = _mm_loadu_ps(&matrix[i][0]);
+        }
+    }
+
+    __m128 transform(__m128 vector) const
+    {
+        __m128 result = _mm_mul_ps(column[0], splat<0>(vector));
+        result = _mm_add_ps(result, _mm_mul_ps(column[1], splat<1>(vector)));
+        result = _mm_add_ps(result, _mm_mul_ps(column[2], splat<2>(vector)));
+        return _mm_add_ps(result, _mm_mul_ps(column[3], splat<3>(vector)));
+    }
+};
+
+// The w lane is a.w * b.w twice over, so it cancels to zero.
+__m128 cross(__m128 a, __m128 b)
+{
+    __m128 aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYzx), _mm_mul_ps(aYzx, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+__m128 dot(__m128 a, __m128 b)
+{
+    __m128 product = _mm_mul_ps(a, b);
+    __m128 sum = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+void storeVec3(glm::vec3& target, __m128 value)
+{
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, value);
+    std::memcpy(&target, lanes, sizeof(target));
+}
+
+#endif
+
+#if TRANSFORM_BATCH_AVX2
+
+// Left matrix columns repeated in both halves, to transform two columns at once.
+struct WideColumns
+{
+    __m256 column[4];
+
+    TARGET_AVX2 explicit WideColumns(const glm::mat4& matrix)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            column[i] = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[i][0]));
+        }
+    }
+
+    TARGET_AVX2 void multiply(const glm::mat4& right, glm::mat4& result) const
+    {
+        for (int i = 0; i < 4; i += 2)
+        {
+            __m256 pair = _mm256_loadu_ps(&right[i][0]);
+            __m256 sum = _mm256_mul_ps(column[0], _mm256_permute_ps(pair, 0x00));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(column[1], _mm256_permute_ps(pair, 0x55)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(column[2], _mm256_permute_ps(pair, 0xAA)));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(column[3], _mm256_permute_ps(pair, 0xFF)));
+            _mm256_storeu_ps(&result[i][0], sum);
+        }
+    }
+};
+
+// AVX2 needs the processor to have it and the operating system to save the
+// upper register halves on context switches.
+bool hasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4];
+    __cpuid(registers, 0);
+    if (registers[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(registers, 1);
+    bool osSavesAvx = (registers[2] & (1 << 27)) != 0 && (registers[2] & (1 << 28)) != 0 &&
+                      (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(registers, 7, 0);
+    return osSavesAvx && (registers[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+const bool UseAvx2 = hasAvx2();
+
+#endif
+
+#if TRANSFORM_BATCH_SSE2
+
+struct Multiplier
+{
+    Columns left;
+
+    explicit Multiplier(const glm::mat4& matrix) : left(matrix) {}
+
+    void multiply(const glm::mat4& right, glm::mat4& result) const
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            _mm_storeu_ps(&result[i][0], left.transform(_mm_loadu_ps(&right[i][0])));
+        }
+    }
+};
+
+#else
+
+struct Multiplier
+{
+    glm::mat4 left;
+
+    explicit Multiplier(const glm::mat4& matrix) : left(matrix) {}
+
+    void multiply(const glm::mat4& right, glm::mat4& result) const
+    {
+        result = left * right;
+    }
+};
+
+#endif
+
+// Columns of the cofactor matrix divided by the determinant: the rows of the inverse.
+void normalMatrix(const glm::mat4& model, glm::vec4* columns)
+{
+#if TRANSFORM_BATCH_SSE2
+    __m128 axes[3];
+    for (int i = 0; i < 3; i++)
+    {
+        // Drop w so the cross products are plain 3D ones.
+        axes[i] = _mm_loadu_ps(&model[i][0]);
+        axes[i] = _mm_castsi128_ps(
+            _mm_and_si128(_mm_castps_si128(axes[i]), _mm_setr_epi32(-1, -1, -1, 0))
+        );
+    }
+    __m128 cofactors[3] = {
+        cross(axes[1], axes[2]), cross(axes[2], axes[0]), cross(axes[0], axes[1])
+    };
+    __m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), dot(axes[0], cofactors[0]));
+    for (int i = 0; i < 3; i++)
+    {
+        _mm_storeu_ps(&columns[i][0], _mm_mul_ps(cofactors[i], inverseDeterminant));
+    }
+#else
+    glm::mat3 inverseTranspose = glm::transpose(glm::inverse(glm::mat3(model)));
+    for (int i = 0; i < 3; i++)
+    {
+        columns[i] = glm::vec4(inverseTranspose[i], 0.0f);
+    }
+#endif
+}
+
+template <typename Product>
+void packWith(
+    const Product& product,
+    std::span<const glm::mat4> models,
+    std::uint32_t textureIndex,
+    std::span<PackedInstance> instances
+)
+{
+    std::size_t count = std::min(models.size(), instances.size());
+    for (std::size_t i = 0; i < count; i++)
+    {
+        PackedInstance& instance = instances[i];
+        product.multiply(models[i], instance.modelViewProjection);
+        normalMatrix(models[i], instance.normalMatrix);
+        instance.textureIndex = textureIndex;
+    }
+}
+
+#if TRANSFORM_BATCH_AVX2
+
+// The loop of packWith, repeated in a function built for AVX2 so the wide
+// products are inlined into it.
+TARGET_AVX2 void packWithAvx2(
+    const glm::mat4& viewProjection,
+    std::span<const glm::mat4> models,
+    std::uint32_t textureIndex,
+    std::span<PackedInstance> instances
+)
+{
+    WideColumns product(viewProjection);
+    std::size_t count = std::min(models.size(), instances.size());
+    for (std::size_t i = 0; i < count; i++)
+    {
+        PackedInstance& instance = instances[i];
+        product.multiply(models[i], instance.modelViewProjection);
+        normalMatrix(models[i], instance.normalMatrix);
+        instance.textureIndex = textureIndex;
+    }
+}
+
+#endif
+
+}
+
+const char* transformBatchInstructionSet()
+{
+#if TRANSFORM_BATCH_AVX2
+    if (UseAvx2)
+    {
+        return "AVX2";
+    }
+#endif
+#if TRANSFORM_BATCH_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void transformBounds(
+    const glm::vec3& boundsMin,
+    const glm::vec3& boundsMax,
+    std::span<const glm::mat4> models,
+    std::span<glm::vec3> worldMins,
+    std::span<glm::vec3> worldMaxs
+)
+{
+    // The box's center is transformed as a point, its half extent by the
+    // absolute value of the linear part.
+    glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+    std::size_t count = std::min({models.size(), worldMins.size(), worldMaxs.size()});
+#if TRANSFORM_BATCH_SSE2
+    __m128 centerPoint = _mm_setr_ps(center.x, center.y, center.z, 1.0f);
+    __m128 extentVector = _mm_setr_ps(extent.x, extent.y, extent.z, 0.0f);
+    __m128 absoluteMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (std::size_t i = 0; i < count; i++)
+    {
+        Columns model(models[i]);
+        __m128 worldCenter = model.transform(centerPoint);
+        Columns absolute = model;
+        for (__m128& column : absolute.column)
+        {
+            column = _mm_and_ps(column, absoluteMask);
+        }
+        __m128 worldExtent = absolute.transform(extentVector);
+        storeVec3(worldMins[i], _mm_sub_ps(worldCenter, worldExtent));
+        storeVec3(worldMaxs[i], _mm_add_ps(worldCenter, worldExtent));
+    }
+#else
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const glm::mat4& model = models[i];
+        glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+        glm::vec3 worldExtent = glm::abs(glm::vec3(model[0])) * extent.x +
+                                glm::abs(glm::vec3(model[1])) * extent.y +
+                                glm::abs(glm::vec3(model[2])) * extent.z;
+        worldMins[i] = worldCenter - worldExtent;
+        worldMaxs[i] = worldCenter + worldExtent;
+    }
+#endif
+}
+
+void packInstances(
+    const glm::mat4& viewProjection,
+    std::span<const glm::mat4> models,
+    std::uint32_t textureIndex,
+    std::span<PackedInstance> instances
+)
+{
+#if TRANSFORM_BATCH_AVX2
+    if (UseAvx2)
+    {
+        packWithAvx2(viewProjection, models, textureIndex, instances);
+        return;
+    }
+#endif
+    packWith(Multiplier(viewProjection), models, textureIndex, instances);
+}
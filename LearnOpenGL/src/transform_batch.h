@@ -0,0 +1,39 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+
+// Per-instance record read by the vertex shaders, laid out like their std430
+// Instance struct. The shader only multiplies positions by modelViewProjection.
+struct PackedInstance
+{
+    glm::mat4 modelViewProjection;
+    // Inverse transpose of the model's upper 3x3, in columns padded like a std430 mat3.
+    glm::vec4 normalMatrix[3];
+    std::uint32_t textureIndex;
+    std::uint32_t padding[3];
+};
+
+// Transform kernels working on arrays of objects. Matrix products use AVX2 on
+// x64 processors that support it, every kernel uses SSE2 on x86 and plain glm
+// elsewhere. All variants agree with the glm expressions up to rounding.
+
+// Name of the instruction set the kernels run with on this processor.
+const char* transformBatchInstructionSet();
+
+// Axis-aligned world bounds of a model-space box placed by every model matrix.
+void transformBounds(
+    const glm::vec3& boundsMin,
+    const glm::vec3& boundsMax,
+    std::span<const glm::mat4> models,
+    std::span<glm::vec3> worldMins,
+    std::span<glm::vec3> worldMaxs
+);
+
+// Fill the instance records of the models seen through viewProjection.
+void packInstances(
+    const glm::mat4& viewProjection,
+    std::span<const glm::mat4> models,
+    std::uint32_t textureIndex,
+    std::span<PackedInstance> instances
+);
@@ -0,0 +1,126 @@
+#include "upload_ring.h"
+#include <logging/logs.h>
+#include <format>
+
+namespace
+{
+
+// Regions start on cache lines, which also satisfies every unpack alignment.
+constexpr std::size_t RegionAlignment = 64;
+
+constexpr GLbitfield MappingFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+}
+
+UploadRing::UploadRing(std::size_t size)
+    : _buffer(),
+      _memory(nullptr),
+      _size{},
+      _mutex(),
+      _allocations(),
+      _firstSequence{},
+      _head{},
+      _tail{}
+{
+    if (!GLAD_GL_VERSION_4_4)
+    {
+        logging::info("No persistent buffer mapping, textures are staged on the OpenGL thread");
+        return;
+    }
+    _buffer.storage(static_cast<GLsizeiptr>(size), nullptr, MappingFlags);
+    _memory = static_cast<std::uint8_t*>(
+        _buffer.map(0, static_cast<GLsizeiptr>(size), MappingFlags)
+    );
+    if (_memory == nullptr)
+    {
+        logging::error(std::format("Failed to map {} byte upload ring", size));
+        return;
+    }
+    _size = size;
+}
+
+UploadRing::~UploadRing()
+{
+    for (const Allocation& allocation : _allocations)
+    {
+        glDeleteSync(allocation.fence);
+    }
+    if (_memory != nullptr)
+    {
+        _buffer.unmap();
+    }
+}
+
+std::optional<UploadRing::Region> UploadRing::allocate(std::size_t size)
+{
+    std::size_t length = (size + RegionAlignment - 1) / RegionAlignment * RegionAlignment;
+    std::lock_guard lock(_mutex);
+    if (length == 0 || length > _size)
+    {
+        return std::nullopt;
+    }
+
+    // The head never catches up with the tail, so equal positions always mean
+    // an empty ring.
+    std::size_t begin = 0;
+    if (_allocations.empty())
+    {
+        _head = 0;
+        _tail = 0;
+    }
+    else if (_head > _tail)
+    {
+        // Free space runs from the head to the end, then from the start to the tail.
+        if (_head + length <= _size)
+        {
+            begin = _head;
+        }
+        else if (length >= _tail)
+        {
+            return std::nullopt;
+        }
+    }
+    else if (_head + length < _tail)
+    {
+        begin = _head;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    _head = begin + length;
+    _allocations.push_back(Allocation{begin, _head, nullptr});
+    return Region{
+        _firstSequence + _allocations.size() - 1, begin, std::span(_memory + begin, size)
+    };
+}
+
+void UploadRing::retire(const Region& region)
+{
+    std::lock_guard lock(_mutex);
+    Allocation& allocation = _allocations[region.sequence - _firstSequence];
+    allocation.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void UploadRing::collect()
+{
+    std::lock_guard lock(_mutex);
+    while (!_allocations.empty())
+    {
+        GLsync fence = _allocations.front().fence;
+        if (fence == nullptr || glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        {
+            break;
+        }
+        glDeleteSync(fence);
+        _allocations.pop_front();
+        _firstSequence++;
+    }
+    _tail = _allocations.empty() ? _head : _allocations.front().begin;
+}
+
+const Buffer& UploadRing::buffer() const
+{
+    return _buffer;
+}
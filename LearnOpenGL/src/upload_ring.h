@@ -0,0 +1,73 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+
+#include "gl_objects.h"
+
+// Pixel unpack buffer that stays mapped for its whole lifetime (OpenGL 4.4),
+// handed out in regions so loader threads write texels straight into memory
+// the GPU reads from. The OpenGL thread then only issues the transfer.
+//
+// Regions are taken from the buffer like a ring. A region is reused once the
+// transfers sourcing it are fenced and the fence has signaled; regions may be
+// retired in any order, but space is only reclaimed up to the oldest region
+// still in use.
+//
+// allocate() may be called on any thread, everything else on the thread
+// owning the OpenGL context.
+class UploadRing
+{
+  public:
+    struct Region
+    {
+        std::uint64_t sequence;
+        // Offset into buffer(), the source offset of the transfer.
+        std::size_t offset;
+        std::span<std::uint8_t> memory;
+    };
+
+    // Without persistent mapping the ring stays empty and allocate() always fails.
+    explicit UploadRing(std::size_t size);
+    ~UploadRing();
+
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    // Region of at least size bytes, none if the ring has no room right now.
+    // Never waits for the GPU, callers fall back to their own memory instead.
+    std::optional<Region> allocate(std::size_t size);
+    // Fence the commands issued so far, the last of which read the region.
+    // Every allocated region must be retired, used or not.
+    void retire(const Region& region);
+    // Reclaim retired regions whose fence has signaled.
+    void collect();
+
+    const Buffer& buffer() const;
+
+  private:
+    struct Allocation
+    {
+        std::size_t begin;
+        std::size_t end;
+        // Null until retired.
+        GLsync fence;
+    };
+
+    Buffer _buffer;
+    std::uint8_t* _memory;
+    std::size_t _size;
+
+    std::mutex _mutex;
+    // Live regions in allocation order, which is their order in the ring.
+    std::deque<Allocation> _allocations;
+    // Sequence number of the front allocation.
+    std::uint64_t _firstSequence;
+    // Next free byte, and the start of the oldest live region.
+    std::size_t _head;
+    std::size_t _tail;
+};
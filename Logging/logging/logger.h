@@ -1,6 +1,7 @@
 #pragma once
 #include <string_view>
 #include <format>
+#include <mutex>
 
 #include "severity.h"
 #include "notifier.h"
@@ -26,11 +27,14 @@ class Logger
 
     void addSink(Severity severityThreshold, BaseSink* sink)
     {
+        std::lock_guard lock(_mutex);
         _notifier.addObserver(severityThreshold, sink);
     }
 
+    // Safe to call from any thread; sinks receive one message at a time.
     void log(Severity severity, std::string_view message)
     {
+        std::lock_guard lock(_mutex);
         _notifier.notify(severity, std::format("[{}] {}\n", severity_as_string(severity), message));
     }
 
@@ -43,6 +47,7 @@ class Logger
     Logger() = default;
 
     component::NotifierComponent<Severity> _notifier;
+    std::mutex _mutex;
 };
 
 }
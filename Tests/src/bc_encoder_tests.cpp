@@ -0,0 +1,239 @@
+#include <assets/bc_decoder.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+#include "bc_encoder.h"
+#include "test.h"
+
+namespace
+{
+
+// 4x4 RGBA8 texels, row-major.
+using Texels = std::array<std::uint8_t, 64>;
+
+Texels decodeBC1(const std::uint8_t* block)
+{
+    Texels texels{};
+    assets::decodeBC1Block(block, texels.data());
+    return texels;
+}
+
+Texels decodeBC3(const std::uint8_t* block)
+{
+    Texels texels{};
+    assets::decodeBC3Block(block, texels.data());
+    return texels;
+}
+
+// Reference decoder following the format specification. Mode 6 only, the one
+// mode the encoder writes.
+Texels decodeBC7Mode6(const std::uint8_t* block)
+{
+    int position = 0;
+    auto read = [&](int bitCount) {
+        int value = 0;
+        for (int bit = 0; bit < bitCount; bit++, position++)
+        {
+            value |= ((block[position / 8] >> (position % 8)) & 1) << bit;
+        }
+        return value;
+    };
+    read(7);
+    std::array<std::array<int, 2>, 4> endpoints{};
+    for (auto& channel : endpoints)
+    {
+        channel[0] = read(7);
+        channel[1] = read(7);
+    }
+    int pbit0 = read(1);
+    int pbit1 = read(1);
+    constexpr std::array<int, 16> Weights = {
+        0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64,
+    };
+    Texels texels{};
+    for (int texel = 0; texel < 16; texel++)
+    {
+        int weight = Weights[read(texel == 0 ? 3 : 4)];
+        for (int channel = 0; channel < 4; channel++)
+        {
+            int start = (endpoints[channel][0] << 1) | pbit0;
+            int end = (endpoints[channel][1] << 1) | pbit1;
+            texels[texel * 4 + channel] =
+                static_cast<std::uint8_t>(((64 - weight) * start + weight * end + 32) >> 6);
+        }
+    }
+    return texels;
+}
+
+int largestError(const Texels& a, const Texels& b, int channelCount)
+{
+    int error = 0;
+    for (int texel = 0; texel < 16; texel++)
+    {
+        for (int channel = 0; channel < channelCount; channel++)
+        {
+            error = std::max(error, std::abs(a[texel * 4 + channel] - b[texel * 4 + channel]));
+        }
+    }
+    return error;
+}
+
+Texels solidBlock(std::uint8_t red, std::uint8_t green, std::uint8_t blue, std::uint8_t alpha)
+{
+    Texels texels{};
+    for (int texel = 0; texel < 16; texel++)
+    {
+        texels[texel * 4 + 0] = red;
+        texels[texel * 4 + 1] = green;
+        texels[texel * 4 + 2] = blue;
+        texels[texel * 4 + 3] = alpha;
+    }
+    return texels;
+}
+
+// Texels along a line through color space, the case the endpoint fit is made for.
+Texels gradientBlock()
+{
+    Texels texels{};
+    for (int texel = 0; texel < 16; texel++)
+    {
+        texels[texel * 4 + 0] = static_cast<std::uint8_t>(texel * 17);
+        texels[texel * 4 + 1] = static_cast<std::uint8_t>(200 - texel * 8);
+        texels[texel * 4 + 2] = static_cast<std::uint8_t>(40 + texel * 4);
+        texels[texel * 4 + 3] = static_cast<std::uint8_t>(255 - texel * 12);
+    }
+    return texels;
+}
+
+}
+
+TEST(bc1EncodesSolidBlocks)
+{
+    Texels texels = solidBlock(200, 100, 50, 255);
+    std::array<std::uint8_t, 8> block{};
+    encodeBC1Block(texels.data(), block.data());
+    // Within half a step of the 5 and 6 bit channels.
+    CHECK(largestError(decodeBC1(block.data()), texels, 4) <= 4);
+}
+
+TEST(bc1EncodesGradients)
+{
+    Texels texels = gradientBlock();
+    std::array<std::uint8_t, 8> block{};
+    encodeBC1Block(texels.data(), block.data());
+    auto color0 = block[0] | (block[1] << 8);
+    auto color1 = block[2] | (block[3] << 8);
+    // The opaque four-color palette, never the one with transparent black.
+    CHECK(color0 > color1);
+    // Endpoints are inset by 1/16 of the red extent of 255, which leaves the
+    // palette entries 75 apart; every texel is within half of that.
+    CHECK(largestError(decodeBC1(block.data()), texels, 3) <= 38);
+}
+
+TEST(bc3EncodesAlpha)
+{
+    std::array<std::uint8_t, 16> block{};
+    Texels solid = solidBlock(10, 20, 30, 77);
+    encodeBC3Block(solid.data(), block.data());
+    Texels decoded = decodeBC3(block.data());
+    CHECK(largestError(decoded, solid, 3) <= 4);
+    for (int texel = 0; texel < 16; texel++)
+    {
+        CHECK(decoded[texel * 4 + 3] == 77);
+    }
+
+    Texels gradient = gradientBlock();
+    encodeBC3Block(gradient.data(), block.data());
+    decoded = decodeBC3(block.data());
+    CHECK(largestError(decoded, gradient, 3) <= 38);
+    // Eight alpha levels over a range of 180, each texel within half a step.
+    int alphaError = 0;
+    for (int texel = 0; texel < 16; texel++)
+    {
+        int error = std::abs(decoded[texel * 4 + 3] - gradient[texel * 4 + 3]);
+        alphaError = std::max(alphaError, error);
+    }
+    CHECK(alphaError <= 13);
+}
+
+TEST(bc7EncodesMode6)
+{
+    std::array<std::uint8_t, 16> block{};
+    Texels solid = solidBlock(200, 100, 51, 128);
+    encodeBC7Block(solid.data(), block.data());
+    CHECK((block[0] & 0x7F) == 0x40);
+    CHECK(largestError(decodeBC7Mode6(block.data()), solid, 4) <= 1);
+
+    Texels gradient = gradientBlock();
+    encodeBC7Block(gradient.data(), block.data());
+    CHECK((block[0] & 0x7F) == 0x40);
+    // Sixteen levels leave little rounding, the extremes are off by the inset of 15.
+    CHECK(largestError(decodeBC7Mode6(block.data()), gradient, 4) <= 16);
+}
+
+TEST(encodeImagePadsEdgeBlocks)
+{
+    // 5x3 texels make 2x1 blocks, the right one padded with the last column.
+    assets::Image image{5, 3, std::vector<std::uint8_t>(5 * 3 * 4)};
+    for (std::uint32_t y = 0; y < 3; y++)
+    {
+        for (std::uint32_t x = 0; x < 5; x++)
+        {
+            std::uint8_t* pixel = &image.pixels[(y * 5 + x) * 4];
+            pixel[0] = x == 4 ? 255 : 0;
+            pixel[1] = 0;
+            pixel[2] = 0;
+            pixel[3] = 255;
+        }
+    }
+    std::vector<std::uint8_t> encoded = encodeImage(image, assets::TextureFormat::BC1);
+    CHECK(encoded.size() == 16);
+    CHECK(largestError(decodeBC1(encoded.data() + 8), solidBlock(255, 0, 0, 255), 4) == 0);
+    CHECK(largestError(decodeBC1(encoded.data()), solidBlock(0, 0, 0, 255), 4) == 0);
+
+    CHECK(encodeImage(image, assets::TextureFormat::BC7).size() == 32);
+    CHECK(encodeImage(image, assets::TextureFormat::RGBA8) == image.pixels);
+}
+
+TEST(bc1DecodesTransparentPalette)
+{
+    // color0 <= color1 selects three colors and transparent black.
+    std::array<std::uint8_t, 8> block = {0x00, 0x00, 0xFF, 0xFF, 0xE4, 0xE4, 0xE4, 0xE4};
+    Texels texels = decodeBC1(block.data());
+    // Indices 0, 1, 2, 3 along every row.
+    CHECK(texels[0] == 0 && texels[3] == 255);
+    CHECK(texels[4] == 255 && texels[5] == 255 && texels[7] == 255);
+    CHECK(texels[8] == 127 && texels[11] == 255);
+    CHECK(texels[12] == 0 && texels[13] == 0 && texels[15] == 0);
+}
+
+TEST(decodeImageDropsEdgePadding)
+{
+    // 6x5 texels are 2x2 blocks; the decoder must only write the texels inside.
+    assets::Image image{6, 5, std::vector<std::uint8_t>(6 * 5 * 4)};
+    for (std::size_t texel = 0; texel < 6 * 5; texel++)
+    {
+        image.pixels[texel * 4 + 0] = static_cast<std::uint8_t>(texel * 8);
+        image.pixels[texel * 4 + 1] = 64;
+        image.pixels[texel * 4 + 2] = 0;
+        image.pixels[texel * 4 + 3] = static_cast<std::uint8_t>(255 - texel * 4);
+    }
+    std::vector<std::uint8_t> encoded = encodeImage(image, assets::TextureFormat::BC3);
+    std::vector<std::uint8_t> decoded(image.pixels.size() + 4, 0xCD);
+    assets::decodeImage(
+        encoded, assets::TextureFormat::BC3, 6, 5, std::span(decoded).first(image.pixels.size())
+    );
+
+    int error = 0;
+    for (std::size_t index = 0; index < image.pixels.size(); index++)
+    {
+        error = std::max(error, std::abs(decoded[index] - image.pixels[index]));
+    }
+    CHECK(error <= 38);
+    // Nothing written past the end.
+    CHECK(decoded.back() == 0xCD);
+}
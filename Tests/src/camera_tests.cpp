@@ -0,0 +1,46 @@
+#include <glm/glm.hpp>
+#include <cstdint>
+
+#include "camera.h"
+#include "test.h"
+
+TEST(cameraCountsMovesAndTurns)
+{
+    Camera camera;
+    std::uint64_t view = camera.viewVersion();
+    camera.translate(glm::vec3(1.0f, 0.0f, 0.0f));
+    CHECK(camera.viewVersion() == view + 1);
+    CHECK(camera.position() == glm::vec3(1.0f, 0.0f, 0.0f));
+    camera.rotate(10.0f, 5.0f);
+    CHECK(camera.viewVersion() == view + 2);
+    CHECK(camera.version() == view + 2 + camera.projectionVersion());
+}
+
+TEST(cameraIgnoresMovesThatChangeNothing)
+{
+    Camera camera;
+    std::uint64_t view = camera.viewVersion();
+    glm::vec3 front = camera.front();
+    camera.translate(glm::vec3(0.0f));
+    camera.rotate(0.0f, 0.0f);
+    camera.position(camera.position());
+    CHECK(camera.viewVersion() == view);
+    CHECK(camera.front() == front);
+}
+
+TEST(cameraIgnoresPitchPastTheClamp)
+{
+    Camera camera;
+    camera.rotate(0.0f, 120.0f);
+    std::uint64_t view = camera.viewVersion();
+    glm::vec3 front = camera.front();
+    camera.rotate(0.0f, 10.0f);
+    CHECK(camera.viewVersion() == view);
+    CHECK(camera.front() == front);
+    // Turning sideways at the clamp still counts.
+    camera.rotate(5.0f, 10.0f);
+    CHECK(camera.viewVersion() == view + 1);
+    camera.rotate(0.0f, -10.0f);
+    CHECK(camera.viewVersion() == view + 2);
+    CHECK(camera.front().y < front.y);
+}
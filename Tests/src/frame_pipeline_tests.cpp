@@ -0,0 +1,151 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "frame_pipeline.h"
+#include "test.h"
+
+namespace
+{
+
+// Long enough for a blocked thread to have returned if it was not blocked.
+constexpr auto SettleTime = std::chrono::milliseconds(50);
+
+}
+
+TEST(framePipelineHandsOffFramesInOrder)
+{
+    constexpr std::uint64_t FrameCount = 1000;
+    FramePipeline pipeline;
+    std::thread producer([&] {
+        for (std::uint64_t frame = 0; frame < FrameCount; frame++)
+        {
+            FrameSnapshot* snapshot = pipeline.beginFrame();
+            snapshot->framebufferWidth = static_cast<int>(frame);
+            snapshot->instances.assign(frame % 7, glm::mat4(static_cast<float>(frame)));
+            pipeline.submitFrame();
+        }
+    });
+
+    bool inOrder = true;
+    bool complete = true;
+    for (std::uint64_t frame = 0; frame < FrameCount; frame++)
+    {
+        const FrameSnapshot* snapshot = pipeline.acquireFrame();
+        inOrder = inOrder && snapshot->index == frame;
+        // The producer must not be writing the frame being read.
+        complete = complete && snapshot->framebufferWidth == static_cast<int>(frame) &&
+                   snapshot->instances.size() == frame % 7;
+        for (const glm::mat4& instance : snapshot->instances)
+        {
+            complete = complete && instance[0][0] == static_cast<float>(frame);
+        }
+        pipeline.releaseFrame();
+    }
+    producer.join();
+
+    CHECK(inOrder);
+    CHECK(complete);
+    CHECK(pipeline.waitForIdle());
+}
+
+TEST(framePipelineKeepsProducerOneFrameAhead)
+{
+    FramePipeline pipeline;
+    pipeline.beginFrame();
+    pipeline.submitFrame();
+    pipeline.beginFrame();
+    pipeline.submitFrame();
+
+    // Frame 2 reuses the slot of frame 0, which the consumer still has to release.
+    std::atomic<FrameSnapshot*> third{nullptr};
+    std::atomic<bool> returned{false};
+    std::thread producer([&] {
+        third = pipeline.beginFrame();
+        returned = true;
+    });
+    std::this_thread::sleep_for(SettleTime);
+    CHECK(!returned);
+
+    const FrameSnapshot* first = pipeline.acquireFrame();
+    CHECK(first != nullptr && first->index == 0);
+    pipeline.releaseFrame();
+    producer.join();
+    CHECK(returned);
+    CHECK(third.load() == first);
+    CHECK(third.load()->index == 2);
+}
+
+TEST(framePipelineWaitsForIdle)
+{
+    FramePipeline pipeline;
+    pipeline.beginFrame();
+    pipeline.submitFrame();
+
+    std::atomic<bool> idle{false};
+    std::thread producer([&] { idle = pipeline.waitForIdle(); });
+    std::this_thread::sleep_for(SettleTime);
+    CHECK(!idle);
+
+    pipeline.acquireFrame();
+    pipeline.releaseFrame();
+    producer.join();
+    CHECK(idle);
+}
+
+TEST(framePipelineCloseWakesConsumer)
+{
+    FramePipeline pipeline;
+    std::atomic<bool> returned{false};
+    const FrameSnapshot* acquired = nullptr;
+    std::thread consumer([&] {
+        acquired = pipeline.acquireFrame();
+        returned = true;
+    });
+    std::this_thread::sleep_for(SettleTime);
+    CHECK(!returned);
+
+    pipeline.close();
+    consumer.join();
+    CHECK(acquired == nullptr);
+    CHECK(pipeline.closed());
+}
+
+TEST(framePipelineCloseWakesProducer)
+{
+    FramePipeline pipeline;
+    pipeline.beginFrame();
+    pipeline.submitFrame();
+    pipeline.beginFrame();
+    pipeline.submitFrame();
+
+    std::atomic<bool> returned{false};
+    FrameSnapshot* third = nullptr;
+    std::thread producer([&] {
+        third = pipeline.beginFrame();
+        returned = true;
+    });
+    std::this_thread::sleep_for(SettleTime);
+    CHECK(!returned);
+
+    pipeline.close();
+    producer.join();
+    CHECK(third == nullptr);
+}
+
+TEST(framePipelineStaysClosed)
+{
+    FramePipeline pipeline;
+    pipeline.beginFrame();
+    pipeline.submitFrame();
+    pipeline.close();
+
+    // Neither side may overwrite the closed marker, and every wait returns at once.
+    pipeline.submitFrame();
+    pipeline.releaseFrame();
+    CHECK(pipeline.closed());
+    CHECK(pipeline.acquireFrame() == nullptr);
+    CHECK(pipeline.beginFrame() == nullptr);
+    CHECK(!pipeline.waitForIdle());
+}
@@ -0,0 +1,76 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "frustum.h"
+#include "test.h"
+
+namespace
+{
+
+// Camera at the origin looking down -z, seeing 0.1 to 100 units ahead.
+Frustum cameraFrustum()
+{
+    glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+    glm::mat4 view =
+        glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return extractFrustum(projection * view);
+}
+
+bool unitBoxVisibleAt(const Frustum& frustum, const glm::vec3& position)
+{
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    return frustum.intersects(glm::vec3(-0.5f), glm::vec3(0.5f), model);
+}
+
+}
+
+TEST(frustumPlanesAreNormalized)
+{
+    Frustum frustum = cameraFrustum();
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        CHECK_NEAR(glm::length(glm::vec3(plane)), 1.0, 1e-5);
+    }
+    // Plane equations give distances: the near plane is 0.1 ahead, the far one 100.
+    glm::vec4 point(0.0f, 0.0f, -10.0f, 1.0f);
+    CHECK_NEAR(glm::dot(frustum.planes[Frustum::Near], point), 9.9, 1e-4);
+    CHECK_NEAR(glm::dot(frustum.planes[Frustum::Far], point), 90.0, 1e-3);
+}
+
+TEST(frustumKeepsVisibleBoxes)
+{
+    Frustum frustum = cameraFrustum();
+    CHECK(unitBoxVisibleAt(frustum, glm::vec3(0.0f, 0.0f, -5.0f)));
+    // Poking in through a side plane, the near plane or the far plane.
+    CHECK(unitBoxVisibleAt(frustum, glm::vec3(5.4f, 0.0f, -5.0f)));
+    CHECK(unitBoxVisibleAt(frustum, glm::vec3(0.0f, 0.0f, 0.3f)));
+    CHECK(unitBoxVisibleAt(frustum, glm::vec3(0.0f, 0.0f, -100.4f)));
+}
+
+TEST(frustumRejectsHiddenBoxes)
+{
+    Frustum frustum = cameraFrustum();
+    CHECK(!unitBoxVisibleAt(frustum, glm::vec3(0.0f, 0.0f, 5.0f)));
+    CHECK(!unitBoxVisibleAt(frustum, glm::vec3(0.0f, 0.0f, -101.0f)));
+    CHECK(!unitBoxVisibleAt(frustum, glm::vec3(6.5f, 0.0f, -5.0f)));
+    CHECK(!unitBoxVisibleAt(frustum, glm::vec3(0.0f, -6.5f, -5.0f)));
+}
+
+TEST(frustumPlacesBoxesByModel)
+{
+    Frustum frustum = cameraFrustum();
+    // A box outside in object space, moved in front of the camera and scaled.
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -20.0f));
+    model = glm::scale(model, glm::vec3(0.1f));
+    CHECK(frustum.intersects(glm::vec3(40.0f), glm::vec3(60.0f), model));
+    CHECK(!frustum.intersects(glm::vec3(400.0f), glm::vec3(600.0f), model));
+}
+
+TEST(frustumTestsWorldBoxes)
+{
+    Frustum frustum = cameraFrustum();
+    CHECK(frustum.intersects(glm::vec3(-0.5f, -0.5f, -5.5f), glm::vec3(0.5f, 0.5f, -4.5f)));
+    CHECK(frustum.intersects(glm::vec3(4.9f, -0.5f, -5.5f), glm::vec3(5.9f, 0.5f, -4.5f)));
+    CHECK(!frustum.intersects(glm::vec3(-0.5f, -0.5f, 4.5f), glm::vec3(0.5f, 0.5f, 5.5f)));
+    CHECK(!frustum.intersects(glm::vec3(6.0f, -0.5f, -5.5f), glm::vec3(7.0f, 0.5f, -4.5f)));
+}
@@ -0,0 +1,72 @@
+#include <assets/image.h>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "test.h"
+
+namespace
+{
+
+assets::Image noiseImage(std::uint32_t width, std::uint32_t height)
+{
+    assets::Image image{width, height, std::vector<std::uint8_t>(std::size_t{width} * height * 4)};
+    std::uint32_t state = width * 31 + height;
+    for (std::uint8_t& channel : image.pixels)
+    {
+        state = state * 1664525 + 1013904223;
+        channel = static_cast<std::uint8_t>(state >> 24);
+    }
+    return image;
+}
+
+// Texel of the 2x2 box filter with clamped edges, rounded to nearest.
+std::uint8_t boxFilter(const assets::Image& image, std::uint32_t x, std::uint32_t y, int channel)
+{
+    auto texel = [&](std::uint32_t sourceX, std::uint32_t sourceY) {
+        sourceX = std::min(sourceX, image.width - 1);
+        sourceY = std::min(sourceY, image.height - 1);
+        return image.pixels[(std::size_t{sourceY} * image.width + sourceX) * 4 + channel];
+    };
+    int sum = texel(x * 2, y * 2) + texel(x * 2 + 1, y * 2) + texel(x * 2, y * 2 + 1) +
+              texel(x * 2 + 1, y * 2 + 1);
+    return static_cast<std::uint8_t>((sum + 2) / 4);
+}
+
+}
+
+TEST(downsampleMatchesScalarBoxFilter)
+{
+    // Even and odd sizes, below and above the two texel step of the vector loop.
+    for (auto [width, height] : {std::pair{64u, 64u}, {37u, 5u}, {3u, 9u}, {1u, 6u}, {2u, 1u}})
+    {
+        assets::Image image = noiseImage(width, height);
+        assets::Image result = assets::downsample(image);
+        CHECK(result.width == std::max(width / 2, 1u));
+        CHECK(result.height == std::max(height / 2, 1u));
+        bool identical = result.pixels.size() == std::size_t{result.width} * result.height * 4;
+        for (std::uint32_t y = 0; identical && y < result.height; y++)
+        {
+            for (std::uint32_t x = 0; x < result.width; x++)
+            {
+                for (int channel = 0; channel < 4; channel++)
+                {
+                    std::size_t index = (std::size_t{y} * result.width + x) * 4 + channel;
+                    identical = identical &&
+                                result.pixels[index] == boxFilter(image, x, y, channel);
+                }
+            }
+        }
+        CHECK(identical);
+    }
+}
+
+TEST(generateMipChainEndsAtOneTexel)
+{
+    std::vector<assets::Image> chain = assets::generateMipChain(noiseImage(12, 5));
+    CHECK(chain.size() == 4);
+    CHECK(chain[1].width == 6 && chain[1].height == 2);
+    CHECK(chain[2].width == 3 && chain[2].height == 1);
+    CHECK(chain[3].width == 1 && chain[3].height == 1);
+}
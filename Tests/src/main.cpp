@@ -0,0 +1,80 @@
+#include <logging/logs.h>
+#include <logging/logger.h>
+#include <logging/severity.h>
+#include <logging/sinks.h>
+
+#include <format>
+#include <string_view>
+#include <vector>
+
+#include "test.h"
+
+namespace
+{
+
+struct TestCase
+{
+    const char* name;
+    testing::TestFunction function;
+};
+
+// Filled during static initialization, so it must be constructed on first use.
+std::vector<TestCase>& testCases()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+std::size_t failureCount = 0;
+
+}
+
+bool testing::registerTest(const char* name, TestFunction function)
+{
+    testCases().push_back(TestCase{name, function});
+    return true;
+}
+
+void testing::fail(std::string_view expression, std::source_location location)
+{
+    failureCount++;
+    logging::error(
+        std::format("{}:{}: CHECK failed: {}", location.file_name(), location.line(), expression)
+    );
+}
+
+// Tests [name filter]
+// Runs every test case whose name contains the filter, all of them without one.
+// Returns 1 if any check failed.
+int main(int argc, char* argv[])
+{
+    auto& logger = logging::Logger::Instance();
+    logging::ConsoleSink consoleSink{};
+    logger.addSink(logging::Severity::Info, &consoleSink);
+
+    std::string_view filter = argc > 1 ? argv[1] : "";
+    std::size_t runCount = 0;
+    std::size_t failedCount = 0;
+    for (const TestCase& testCase : testCases())
+    {
+        if (std::string_view(testCase.name).find(filter) == std::string_view::npos)
+        {
+            continue;
+        }
+        std::size_t failuresBefore = failureCount;
+        testCase.function();
+        runCount++;
+        if (failureCount != failuresBefore)
+        {
+            failedCount++;
+            logging::error(std::format("FAILED {}", testCase.name));
+        }
+        else
+        {
+            logging::info(std::format("passed {}", testCase.name));
+        }
+    }
+
+    logging::info(std::format("{} of {} test cases passed", runCount - failedCount, runCount));
+    return failedCount == 0 && runCount > 0 ? 0 : 1;
+}
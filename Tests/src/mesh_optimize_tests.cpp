@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <vector>
+
+#include "mesh_optimize.h"
+#include "test.h"
+#include "test_meshes.h"
+
+TEST(analyzeVertexCacheCountsMisses)
+{
+    std::vector<std::uint32_t> triangle = {0, 1, 2};
+    VertexCacheStatistics statistics = analyzeVertexCache(triangle, 3);
+    CHECK(statistics.acmr == 3.0);
+    CHECK(statistics.atvr == 1.0);
+
+    // The second triangle hits the cache, the third misses on its vertex 3 only.
+    std::vector<std::uint32_t> strip = {0, 1, 2, 2, 1, 0, 1, 2, 3};
+    statistics = analyzeVertexCache(strip, 4);
+    CHECK_NEAR(statistics.acmr, 4.0 / 3.0, 1e-12);
+    CHECK(statistics.atvr == 1.0);
+
+    // With two entries the FIFO evicts vertex 0 before it comes back.
+    std::vector<std::uint32_t> evicting = {0, 1, 2, 0, 1, 2};
+    statistics = analyzeVertexCache(evicting, 3, 2);
+    CHECK(statistics.acmr == 3.0);
+    CHECK(statistics.atvr == 2.0);
+
+    CHECK(analyzeVertexCache({}, 0).acmr == 0.0);
+}
+
+TEST(optimizeMeshKeepsTriangles)
+{
+    ImportedMesh mesh = flatGridMesh(20);
+    shuffleTriangles(mesh, 1);
+    auto before = triangleSoup(mesh);
+    optimizeMesh(mesh);
+    CHECK(triangleSoup(mesh) == before);
+    CHECK(mesh.texCoords.size() == mesh.vertexCount() * 2);
+    CHECK(mesh.normals.size() == mesh.vertexCount() * 3);
+    // Texture coordinates moved along with their positions.
+    bool attributesFollow = true;
+    for (std::size_t vertex = 0; vertex < mesh.vertexCount(); vertex++)
+    {
+        attributesFollow = attributesFollow &&
+                           mesh.texCoords[vertex * 2] == mesh.positions[vertex * 3] &&
+                           mesh.texCoords[vertex * 2 + 1] == mesh.positions[vertex * 3 + 1];
+    }
+    CHECK(attributesFollow);
+}
+
+TEST(optimizeMeshImprovesVertexCache)
+{
+    ImportedMesh mesh = flatGridMesh(64);
+    shuffleTriangles(mesh, 2);
+    double shuffled = analyzeVertexCache(mesh.indices, mesh.vertexCount()).acmr;
+    optimizeMesh(mesh);
+    double optimized = analyzeVertexCache(mesh.indices, mesh.vertexCount()).acmr;
+    // A regular grid reaches about 0.7 with a 16 entry cache, random order about 2.
+    CHECK(shuffled > 1.5);
+    CHECK(optimized < 0.8);
+}
+
+TEST(optimizeMeshNumbersVerticesByFirstUse)
+{
+    ImportedMesh mesh = flatGridMesh(8);
+    // An unreferenced vertex at the end is dropped.
+    mesh.positions.insert(mesh.positions.end(), {5.0f, 5.0f, 5.0f});
+    mesh.texCoords.insert(mesh.texCoords.end(), {5.0f, 5.0f});
+    mesh.normals.insert(mesh.normals.end(), {0.0f, 0.0f, 1.0f});
+    shuffleTriangles(mesh, 3);
+    optimizeMesh(mesh);
+
+    CHECK(mesh.vertexCount() == 81);
+    std::uint32_t next = 0;
+    bool inOrder = true;
+    for (std::uint32_t index : mesh.indices)
+    {
+        inOrder = inOrder && index <= next;
+        if (index == next)
+        {
+            next++;
+        }
+    }
+    CHECK(inOrder);
+    CHECK(next == mesh.vertexCount());
+}
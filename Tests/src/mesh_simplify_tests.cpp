@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "mesh_simplify.h"
+#include "test.h"
+#include "test_meshes.h"
+
+namespace
+{
+
+// Bounds of the positions the indices use, as {minimum x, minimum y, maximum x, maximum y}.
+std::array<float, 4> usedBounds(const ImportedMesh& mesh, const std::vector<std::uint32_t>& indices)
+{
+    std::array<float, 4> bounds = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    for (std::uint32_t index : indices)
+    {
+        bounds[0] = std::min(bounds[0], mesh.positions[index * 3]);
+        bounds[1] = std::min(bounds[1], mesh.positions[index * 3 + 1]);
+        bounds[2] = std::max(bounds[2], mesh.positions[index * 3]);
+        bounds[3] = std::max(bounds[3], mesh.positions[index * 3 + 1]);
+    }
+    return bounds;
+}
+
+}
+
+TEST(simplifyTrianglesCollapsesFlatSurfaces)
+{
+    ImportedMesh mesh = flatGridMesh(16);
+    float error = -1.0f;
+    std::vector<std::uint32_t> simplified = simplifyTriangles(mesh, mesh.indices, 64, error);
+
+    CHECK(!simplified.empty());
+    CHECK(simplified.size() % 3 == 0);
+    CHECK(simplified.size() / 3 <= 64);
+    // Every collapse stays in the plane.
+    CHECK_NEAR(error, 0.0, 1e-6);
+    bool existing = std::all_of(simplified.begin(), simplified.end(), [&](std::uint32_t index) {
+        return index < mesh.vertexCount();
+    });
+    CHECK(existing);
+    // The open border only collapses along itself, so the outline stays.
+    std::array<float, 4> bounds = usedBounds(mesh, simplified);
+    CHECK(bounds[0] == 0.0f && bounds[1] == 0.0f && bounds[2] == 1.0f && bounds[3] == 1.0f);
+}
+
+TEST(simplifyTrianglesKeepsWinding)
+{
+    ImportedMesh mesh = flatGridMesh(16);
+    float error = 0.0f;
+    std::vector<std::uint32_t> simplified = simplifyTriangles(mesh, mesh.indices, 100, error);
+    // Every triangle of the grid faces +z, and so must every simplified one.
+    bool facingUp = true;
+    for (std::size_t triangle = 0; triangle * 3 < simplified.size(); triangle++)
+    {
+        const float* a = &mesh.positions[simplified[triangle * 3] * 3];
+        const float* b = &mesh.positions[simplified[triangle * 3 + 1] * 3];
+        const float* c = &mesh.positions[simplified[triangle * 3 + 2] * 3];
+        float normalZ = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+        facingUp = facingUp && normalZ > 0.0f;
+    }
+    CHECK(facingUp);
+}
+
+TEST(simplifyTrianglesReportsErrorOfCurvedSurfaces)
+{
+    ImportedMesh mesh = gridMesh(16, [](float x, float y) {
+        return 0.2f * std::sin(6.0f * x) * std::cos(6.0f * y);
+    });
+    float error = 0.0f;
+    std::vector<std::uint32_t> simplified = simplifyTriangles(mesh, mesh.indices, 32, error);
+    CHECK(simplified.size() / 3 <= 32);
+    // Somewhere between no deviation and the whole height of the surface.
+    CHECK(error > 0.0f);
+    CHECK(error < 0.4f);
+}
+
+TEST(generateLodsHalvesTriangles)
+{
+    ImportedMesh mesh =
+        gridMesh(32, [](float x, float y) { return 0.05f * std::sin(4.0f * x + 3.0f * y); });
+    std::size_t fullIndexCount = mesh.indices.size();
+    std::vector<assets::MeshLod> lods = generateLods(mesh);
+
+    CHECK(lods.size() >= 3);
+    CHECK(lods.size() <= MaxLodCount);
+    CHECK(lods[0].firstSubmesh == 0 && lods[0].submeshCount == 1 && lods[0].error == 0.0f);
+    std::size_t previousIndexCount = fullIndexCount;
+    for (std::size_t level = 1; level < lods.size(); level++)
+    {
+        const assets::MeshLod& lod = lods[level];
+        CHECK(lod.error >= lods[level - 1].error);
+        std::size_t indexCount = 0;
+        for (std::uint32_t submesh = 0; submesh < lod.submeshCount; submesh++)
+        {
+            indexCount += mesh.submeshes[lod.firstSubmesh + submesh].indexCount;
+        }
+        // Each level aims at half the triangles and keeps at most 80% of them.
+        CHECK(indexCount <= previousIndexCount * 4 / 5);
+        previousIndexCount = indexCount;
+    }
+    const assets::Submesh& last = mesh.submeshes.back();
+    CHECK(last.firstIndex + last.indexCount == mesh.indices.size());
+}
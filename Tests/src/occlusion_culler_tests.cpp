@@ -0,0 +1,188 @@
+#include <assets/mesh_container.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "occlusion_culler.h"
+#include "test.h"
+#include "thread_pool.h"
+
+// With an identity view projection, occluder positions are normalized device
+// coordinates and depth runs from 0 at z = -1 to 1 at z = 1.
+
+namespace
+{
+
+const glm::mat4 Identity(1.0f);
+
+// Counter-clockwise quad over [minX, maxX] x [minY, maxY], z given at its left and right edges.
+Occluder quad(float minX, float minY, float maxX, float maxY, float leftZ, float rightZ)
+{
+    return Occluder{
+        {{minX, minY, leftZ}, {maxX, minY, rightZ}, {maxX, maxY, rightZ}, {minX, maxY, leftZ}},
+        {0, 1, 2, 0, 2, 3},
+    };
+}
+
+float depthAt(const OcclusionCuller& culler, int x, int y)
+{
+    return culler.depth()[std::size_t(y) * culler.width() + x];
+}
+
+}
+
+TEST(occlusionCullerFillsCoveredPixels)
+{
+    ThreadPool pool(3);
+    OcclusionCuller culler(pool);
+    // Lower left half of the view, below the diagonal.
+    Occluder triangle{{{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}}, {0, 1, 2}};
+    culler.beginFrame(Identity);
+    culler.addOccluder(triangle, Identity);
+    culler.rasterize();
+
+    // A pixel is covered when its centre is inside: x / width + y / height <= 1.
+    bool matches = true;
+    for (int y = 0; y < culler.height(); y++)
+    {
+        for (int x = 0; x < culler.width(); x++)
+        {
+            float edge = (x + 0.5f) / culler.width() + (y + 0.5f) / culler.height();
+            if (std::abs(edge - 1.0f) < 1e-3f)
+            {
+                continue;
+            }
+            matches = matches && depthAt(culler, x, y) == (edge < 1.0f ? 0.5f : 1.0f);
+        }
+    }
+    CHECK(matches);
+}
+
+TEST(occlusionCullerInterpolatesDepth)
+{
+    ThreadPool pool(2);
+    OcclusionCuller culler(pool);
+    Occluder ramp = quad(-1.0f, -1.0f, 1.0f, 1.0f, -0.5f, 0.5f);
+    culler.beginFrame(Identity);
+    culler.addOccluder(ramp, Identity);
+    culler.rasterize();
+
+    // Depth rises from 0.25 on the left edge to 0.75 on the right one.
+    float largestError = 0.0f;
+    for (int y = 0; y < culler.height(); y += 7)
+    {
+        for (int x = 0; x < culler.width(); x++)
+        {
+            float expected = 0.25f + 0.5f * (x + 0.5f) / culler.width();
+            largestError = std::max(largestError, std::abs(depthAt(culler, x, y) - expected));
+        }
+    }
+    CHECK(largestError < 1e-4f);
+}
+
+TEST(occlusionCullerSkipsBackFaces)
+{
+    ThreadPool pool(2);
+    OcclusionCuller culler(pool);
+    Occluder clockwise{{{-1.0f, -1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}}, {0, 1, 2}};
+    culler.beginFrame(Identity);
+    culler.addOccluder(clockwise, Identity);
+    culler.rasterize();
+    CHECK(std::all_of(culler.depth().begin(), culler.depth().end(), [](float depth) {
+        return depth == 1.0f;
+    }));
+}
+
+TEST(occlusionCullerHidesBoxesBehindOccluders)
+{
+    ThreadPool pool(2);
+    OcclusionCuller culler(pool);
+    Occluder wall = quad(-1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+    culler.beginFrame(Identity);
+    culler.addOccluder(wall, Identity);
+    culler.rasterize();
+
+    glm::vec3 smallMin(-0.1f, -0.1f, 0.0f);
+    glm::vec3 smallMax(0.1f, 0.1f, 0.0f);
+    auto at = [](float x, float z) {
+        return glm::mat4(
+            glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
+            glm::vec4(0.0f, 1.0f, 0.0f, 0.0f),
+            glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
+            glm::vec4(x, 0.0f, z, 1.0f)
+        );
+    };
+    CHECK(!culler.visible(smallMin, smallMax, at(0.0f, 0.5f)));
+    CHECK(culler.visible(smallMin, smallMax, at(0.0f, -0.5f)));
+    // Straddling the wall counts as visible.
+    CHECK(culler.visible(smallMin, smallMax + glm::vec3(0.0f, 0.0f, 0.6f), at(0.0f, -0.3f)));
+    // Outside the view, occluded or not.
+    CHECK(!culler.visible(smallMin, smallMax, at(3.0f, -0.5f)));
+    // Large boxes are tested on coarser pyramid levels.
+    glm::vec3 largeMin(-0.9f, -0.9f, 0.0f);
+    glm::vec3 largeMax(0.9f, 0.9f, 0.1f);
+    CHECK(!culler.visible(largeMin, largeMax, at(0.0f, 0.5f)));
+}
+
+TEST(occlusionCullerWithoutOccludersHidesNothing)
+{
+    ThreadPool pool(2);
+    OcclusionCuller culler(pool);
+    Occluder wall = quad(-1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+    glm::vec3 behindMin(-0.1f, -0.1f, 0.5f);
+    glm::vec3 behindMax(0.1f, 0.1f, 0.6f);
+    culler.beginFrame(Identity);
+    culler.addOccluder(wall, Identity);
+    culler.rasterize();
+    CHECK(!culler.visible(behindMin, behindMax, Identity));
+
+    // The next frame has no occluders, so nothing of the last one may linger.
+    culler.beginFrame(Identity);
+    culler.rasterize();
+    CHECK(culler.visible(behindMin, behindMax, Identity));
+    CHECK(std::all_of(culler.depth().begin(), culler.depth().end(), [](float depth) {
+        return depth == 1.0f;
+    }));
+    CHECK(!culler.visible(behindMin + glm::vec3(3.0f), behindMax + glm::vec3(3.0f), Identity));
+}
+
+TEST(loadOccluderRejectsIndicesPastTheVertices)
+{
+    // One triangle over three float positions, the last index one past them.
+    std::vector<float> positions = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    std::vector<std::uint32_t> indices = {0, 1, 3};
+    assets::MeshData mesh{};
+    mesh.attributes = {
+        {assets::VertexSemantic::Position, assets::VertexComponentType::Float32, 3, 0},
+    };
+    mesh.submeshes = {{0, 3, 0, 0}};
+    mesh.lods = {{0, 1, 0.0f, 0}};
+    mesh.vertexStride = 12;
+    mesh.vertices.resize(positions.size() * sizeof(float));
+    std::memcpy(mesh.vertices.data(), positions.data(), mesh.vertices.size());
+    mesh.indexFormat = assets::IndexFormat::UInt32;
+    mesh.indices.resize(indices.size() * sizeof(std::uint32_t));
+    std::memcpy(mesh.indices.data(), indices.data(), mesh.indices.size());
+    mesh.boundsMin = {0.0f, 0.0f, 0.0f};
+    mesh.boundsMax = {1.0f, 1.0f, 0.0f};
+    mesh.positionScale = {1.0f, 1.0f, 1.0f};
+    mesh.positionBias = {0.0f, 0.0f, 0.0f};
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "occluder_tests.lmesh";
+    CHECK(assets::writeMeshContainer(path.string(), mesh));
+    Occluder occluder{};
+    CHECK(!loadOccluder(path.string(), 0, occluder));
+    CHECK(occluder.indices.empty());
+
+    indices[2] = 2;
+    std::memcpy(mesh.indices.data(), indices.data(), mesh.indices.size());
+    CHECK(assets::writeMeshContainer(path.string(), mesh));
+    CHECK(loadOccluder(path.string(), 0, occluder));
+    CHECK(occluder.indices == indices);
+    CHECK(occluder.positions.size() == 3 && occluder.positions[2] == glm::vec3(0.0f, 1.0f, 0.0f));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,90 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "scene_graph.h"
+#include "test.h"
+
+namespace
+{
+
+glm::vec3 origin(const glm::mat4& world)
+{
+    return glm::vec3(world[3]);
+}
+
+bool samePoint(const glm::vec3& value, const glm::vec3& expected)
+{
+    return glm::length(value - expected) < 1e-5f;
+}
+
+}
+
+TEST(sceneGraphComposesParentTransforms)
+{
+    SceneGraph graph;
+    SceneGraph::Node root = graph.addNode(
+        SceneGraph::NoParent,
+        glm::vec3(10.0f, 0.0f, 0.0f),
+        glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+        glm::vec3(2.0f)
+    );
+    SceneGraph::Node child = graph.addNode(root, glm::vec3(1.0f, 0.0f, 0.0f));
+    SceneGraph::Node grandchild = graph.addNode(child, glm::vec3(0.0f, 1.0f, 0.0f));
+    graph.update();
+
+    CHECK(graph.size() == 3);
+    CHECK(graph.parent(grandchild) == child);
+    CHECK(samePoint(origin(graph.worldMatrix(root)), glm::vec3(10.0f, 0.0f, 0.0f)));
+    // The root's rotation turns +x into -z and its scale doubles the offset.
+    CHECK(samePoint(origin(graph.worldMatrix(child)), glm::vec3(10.0f, 0.0f, -2.0f)));
+    CHECK(samePoint(origin(graph.worldMatrix(grandchild)), glm::vec3(10.0f, 2.0f, -2.0f)));
+    CHECK(graph.worldMatrices().size() == 3);
+}
+
+TEST(sceneGraphUpdatesDescendantsOfMovedNodes)
+{
+    SceneGraph graph;
+    SceneGraph::Node first = graph.addNode(SceneGraph::NoParent);
+    SceneGraph::Node firstChild = graph.addNode(first, glm::vec3(0.0f, 0.0f, 1.0f));
+    SceneGraph::Node second = graph.addNode(SceneGraph::NoParent, glm::vec3(5.0f, 0.0f, 0.0f));
+    SceneGraph::Node secondChild = graph.addNode(second, glm::vec3(0.0f, 1.0f, 0.0f));
+    graph.update();
+
+    graph.setTranslation(second, glm::vec3(-5.0f, 0.0f, 0.0f));
+    graph.setScale(first, glm::vec3(3.0f));
+    graph.update();
+    CHECK(samePoint(origin(graph.worldMatrix(firstChild)), glm::vec3(0.0f, 0.0f, 3.0f)));
+    CHECK(samePoint(origin(graph.worldMatrix(secondChild)), glm::vec3(-5.0f, 1.0f, 0.0f)));
+
+    graph.setRotation(second, glm::angleAxis(glm::radians(180.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+    graph.update();
+    CHECK(samePoint(origin(graph.worldMatrix(secondChild)), glm::vec3(-5.0f, -1.0f, 0.0f)));
+    CHECK(samePoint(origin(graph.worldMatrix(firstChild)), glm::vec3(0.0f, 0.0f, 3.0f)));
+}
+
+TEST(sceneGraphVersionCountsChangingUpdates)
+{
+    SceneGraph graph;
+    std::uint64_t version = graph.version();
+    graph.update();
+    CHECK(graph.version() == version);
+
+    SceneGraph::Node node = graph.addNode(SceneGraph::NoParent);
+    graph.update();
+    CHECK(graph.version() == version + 1);
+    graph.update();
+    CHECK(graph.version() == version + 1);
+
+    graph.setTranslation(node, glm::vec3(1.0f));
+    graph.update();
+    CHECK(graph.version() == version + 2);
+}
+
+TEST(sceneGraphMakesRootsOfMissingParents)
+{
+    SceneGraph graph;
+    SceneGraph::Node node = graph.addNode(7, glm::vec3(1.0f, 2.0f, 3.0f));
+    graph.update();
+    CHECK(graph.parent(node) == SceneGraph::NoParent);
+    CHECK(samePoint(origin(graph.worldMatrix(node)), glm::vec3(1.0f, 2.0f, 3.0f)));
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cmath>
+#include <source_location>
+#include <string_view>
+
+// Minimal test runner. TEST(name) defines a test case, registered before main
+// runs. A failing CHECK reports its expression and location, and the test case
+// carries on so one run shows every failure.
+
+namespace testing
+{
+
+using TestFunction = void (*)();
+
+bool registerTest(const char* name, TestFunction function);
+void fail(std::string_view expression, std::source_location location);
+
+inline bool withinTolerance(double value, double expected, double tolerance)
+{
+    return std::abs(value - expected) <= tolerance;
+}
+
+}
+
+#define TEST(name)                                                                                 \
+    static void name();                                                                            \
+    static const bool name##Registered = ::testing::registerTest(#name, &name);                    \
+    static void name()
+
+#define CHECK(condition)                                                                           \
+    ((condition) ? (void)0 : ::testing::fail(#condition, std::source_location::current()))
+
+#define CHECK_NEAR(value, expected, tolerance)                                                     \
+    (::testing::withinTolerance((value), (expected), (tolerance))                                  \
+         ? (void)0                                                                                 \
+         : ::testing::fail(                                                                        \
+               #value " near " #expected " within " #tolerance, std::source_location::current()    \
+           ))
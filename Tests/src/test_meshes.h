@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mesh_import.h"
+
+// Meshes generated for the mesh processing tests.
+
+// Square grid of quadsPerSide x quadsPerSide quads in the xy plane from 0 to 1,
+// raised along z by height(x, y). One submesh, with texture coordinates and normals.
+template <typename Height>
+ImportedMesh gridMesh(std::size_t quadsPerSide, Height height)
+{
+    ImportedMesh mesh;
+    std::size_t side = quadsPerSide + 1;
+    for (std::size_t row = 0; row < side; row++)
+    {
+        for (std::size_t column = 0; column < side; column++)
+        {
+            float x = static_cast<float>(column) / quadsPerSide;
+            float y = static_cast<float>(row) / quadsPerSide;
+            mesh.positions.insert(mesh.positions.end(), {x, y, height(x, y)});
+            mesh.texCoords.insert(mesh.texCoords.end(), {x, y});
+            mesh.normals.insert(mesh.normals.end(), {0.0f, 0.0f, 1.0f});
+        }
+    }
+    for (std::size_t row = 0; row < quadsPerSide; row++)
+    {
+        for (std::size_t column = 0; column < quadsPerSide; column++)
+        {
+            auto corner = static_cast<std::uint32_t>(row * side + column);
+            auto above = static_cast<std::uint32_t>(corner + side);
+            mesh.indices.insert(
+                mesh.indices.end(), {corner, corner + 1, above + 1, corner, above + 1, above}
+            );
+        }
+    }
+    mesh.submeshes.push_back(
+        assets::Submesh{0, static_cast<std::uint32_t>(mesh.indices.size()), 0, 0}
+    );
+    return mesh;
+}
+
+inline ImportedMesh flatGridMesh(std::size_t quadsPerSide)
+{
+    return gridMesh(quadsPerSide, [](float, float) { return 0.0f; });
+}
+
+// Triangles in random order, the worst case for the vertex cache.
+inline void shuffleTriangles(ImportedMesh& mesh, std::uint32_t seed)
+{
+    std::size_t triangleCount = mesh.indices.size() / 3;
+    std::vector<std::array<std::uint32_t, 3>> triangles(triangleCount);
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+    {
+        std::copy_n(&mesh.indices[triangle * 3], 3, triangles[triangle].begin());
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(seed));
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+    {
+        std::copy_n(triangles[triangle].begin(), 3, &mesh.indices[triangle * 3]);
+    }
+}
+
+// Corner positions of every triangle, rotated so the smallest corner comes
+// first and sorted, to compare meshes independently of vertex and triangle order.
+inline std::vector<std::array<float, 9>> triangleSoup(const ImportedMesh& mesh)
+{
+    std::vector<std::array<float, 9>> soup;
+    for (std::size_t triangle = 0; triangle * 3 < mesh.indices.size(); triangle++)
+    {
+        std::array<std::array<float, 3>, 3> corners;
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            std::copy_n(&mesh.positions[mesh.indices[triangle * 3 + k] * 3], 3, corners[k].begin());
+        }
+        // Rotating keeps the winding.
+        auto smallest = std::min_element(corners.begin(), corners.end());
+        std::rotate(corners.begin(), smallest, corners.end());
+        std::array<float, 9> flat;
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            std::copy_n(corners[k].begin(), 3, flat.begin() + k * 3);
+        }
+        soup.push_back(flat);
+    }
+    std::sort(soup.begin(), soup.end());
+    return soup;
+}
@@ -0,0 +1,75 @@
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "test.h"
+#include "thread_pool.h"
+
+TEST(threadPoolRunsEveryTask)
+{
+    constexpr int TaskCount = 10000;
+    std::atomic<int> sum{0};
+    std::latch done(TaskCount);
+    ThreadPool pool(4);
+    for (int task = 1; task <= TaskCount; task++)
+    {
+        pool.submit([&, task] {
+            sum += task;
+            done.count_down();
+        });
+    }
+    done.wait();
+    CHECK(sum == TaskCount * (TaskCount + 1) / 2);
+}
+
+TEST(threadPoolFinishesQueuedTasksOnDestruction)
+{
+    std::atomic<int> finished{0};
+    {
+        ThreadPool pool(1);
+        for (int task = 0; task < 100; task++)
+        {
+            pool.submit([&] {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                finished++;
+            });
+        }
+    }
+    CHECK(finished == 100);
+}
+
+TEST(threadPoolRunsTasksOnItsWorkers)
+{
+    constexpr std::size_t ThreadCount = 3;
+    ThreadPool pool(ThreadCount);
+    CHECK(pool.threadCount() == ThreadCount);
+
+    // Every worker blocks until all of them hold a task, so each task runs on its own worker.
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::latch started(ThreadCount);
+    for (std::size_t task = 0; task < ThreadCount; task++)
+    {
+        pool.submit([&] {
+            {
+                std::lock_guard lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            }
+            started.arrive_and_wait();
+        });
+    }
+    started.wait();
+    std::lock_guard lock(mutex);
+    CHECK(threads.size() == ThreadCount);
+    CHECK(!threads.contains(std::this_thread::get_id()));
+}
+
+TEST(threadPoolHasAtLeastOneThread)
+{
+    ThreadPool pool(0);
+    CHECK(pool.threadCount() == 1);
+    CHECK(ThreadPool::defaultThreadCount() >= 1);
+}
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "fixed_timestep.h"
+#include "test.h"
+#include "timer.h"
+
+using namespace std::chrono_literals;
+
+TEST(frameTimeStatisticsUsesNearestRank)
+{
+    std::vector<double> frameTimes;
+    for (int frame = 100; frame >= 1; frame--)
+    {
+        frameTimes.push_back(frame);
+    }
+    FrameTimeStatistics statistics = frameTimeStatistics(frameTimes);
+    CHECK(statistics.frameCount == 100);
+    CHECK_NEAR(statistics.mean, 50.5, 1e-9);
+    CHECK_NEAR(statistics.standardDeviation, 28.866070, 1e-5);
+    CHECK(statistics.p50 == 50.0);
+    CHECK(statistics.p95 == 95.0);
+    CHECK(statistics.p99 == 99.0);
+    CHECK(statistics.max == 100.0);
+
+    std::vector<double> single = {4.0};
+    statistics = frameTimeStatistics(single);
+    CHECK(statistics.p50 == 4.0 && statistics.p99 == 4.0 && statistics.standardDeviation == 0.0);
+    CHECK(frameTimeStatistics({}).frameCount == 0);
+}
+
+TEST(frameTimeHistoryKeepsLatestFrames)
+{
+    FrameTimeHistory history(4);
+    CHECK(history.statistics().frameCount == 0);
+    for (int frame = 1; frame <= 6; frame++)
+    {
+        history.add(std::chrono::milliseconds(frame));
+    }
+    // Frames 3 to 6 are left.
+    FrameTimeStatistics statistics = history.statistics();
+    CHECK(statistics.frameCount == 4);
+    CHECK_NEAR(statistics.mean, 4.5, 1e-9);
+    CHECK(statistics.max == 6.0);
+}
+
+TEST(timerMeasuresUpdates)
+{
+    Timer timer;
+    CHECK(timer.elapsed() == 0ns);
+    std::this_thread::sleep_for(2ms);
+    timer.update();
+    CHECK(timer.delta() >= 2ms);
+    CHECK(timer.elapsed() == timer.delta());
+    auto first = timer.elapsed();
+    timer.update();
+    CHECK(timer.elapsed() >= first);
+    CHECK(timer.elapsed() - first == timer.delta());
+    CHECK(timer.statistics().frameCount == 2);
+}
+
+TEST(timerRestartSkipsIdleTime)
+{
+    Timer timer;
+    timer.update();
+    std::this_thread::sleep_for(20ms);
+    timer.restart();
+    CHECK(timer.elapsed() >= 20ms);
+    CHECK(timer.delta() == 0ns);
+    auto restarted = timer.elapsed();
+    timer.update();
+    // Only the time since the restart counts, and the idle time adds no sample.
+    CHECK(timer.delta() == timer.elapsed() - restarted);
+    CHECK(timer.delta() < 20ms);
+    CHECK(timer.statistics().frameCount == 2);
+}
+
+TEST(fixedTimestepSpendsWholeTicks)
+{
+    FixedTimestep timestep(100.0);
+    CHECK(timestep.tickDuration() == 10ms);
+    CHECK(timestep.advance(4ms) == 0);
+    CHECK_NEAR(timestep.alpha(), 0.4, 1e-12);
+    CHECK(timestep.advance(7ms) == 1);
+    CHECK_NEAR(timestep.alpha(), 0.1, 1e-12);
+    CHECK(timestep.advance(29ms) == 3);
+    CHECK(timestep.alpha() == 0.0);
+    CHECK(timestep.tickCount() == 4);
+    // Negative frame times from clock adjustments add nothing.
+    CHECK(timestep.advance(-5ms) == 0);
+    CHECK(timestep.tickCount() == 4);
+}
+
+TEST(fixedTimestepIsDeterministic)
+{
+    // Frame times that do not divide the tick evenly give the same ticks every run.
+    auto run = [] {
+        FixedTimestep timestep;
+        std::vector<std::uint32_t> ticks;
+        for (int frame = 0; frame < 1000; frame++)
+        {
+            ticks.push_back(timestep.advance(std::chrono::nanoseconds(6944444 + frame % 3)));
+        }
+        return ticks;
+    };
+    std::vector<std::uint32_t> ticks = run();
+    CHECK(ticks == run());
+    std::uint64_t total = 0;
+    for (std::uint32_t frameTicks : ticks)
+    {
+        total += frameTicks;
+    }
+    // 1000 frames at 144 Hz are about 6.94 s, which is 416 ticks at 60 Hz.
+    CHECK(total == 416);
+}
+
+TEST(fixedTimestepDropsBacklog)
+{
+    FixedTimestep timestep(60.0, 5);
+    CHECK(timestep.advance(1s) == 5);
+    CHECK(timestep.droppedTicks() == 55);
+    CHECK(timestep.tickCount() == 5);
+    CHECK(timestep.alpha() >= 0.0 && timestep.alpha() < 1.0);
+}
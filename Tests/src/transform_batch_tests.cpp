@@ -0,0 +1,124 @@
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "test.h"
+#include "transform_batch.h"
+
+namespace
+{
+
+// Not a multiple of any vector width, so the kernels' remainders run too.
+constexpr std::size_t ObjectCount = 1001;
+
+// Rotated, non-uniformly scaled and translated models like the scene's.
+std::vector<glm::mat4> randomModels(std::size_t count)
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> offset(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+    std::uniform_real_distribution<float> scale(0.25f, 4.0f);
+    std::vector<glm::mat4> models(count);
+    for (glm::mat4& model : models)
+    {
+        glm::vec3 translation(offset(random), offset(random), offset(random));
+        model = glm::translate(glm::mat4(1.0f), translation);
+        model = glm::rotate(model, angle(random), glm::vec3(0.3f, 1.0f, 0.5f));
+        model = glm::scale(model, glm::vec3(scale(random), scale(random), scale(random)));
+    }
+    return models;
+}
+
+// Largest difference relative to the magnitude of the expected value, at least one.
+float relativeError(const float* values, const float* expected, std::size_t count)
+{
+    float error = 0.0f;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        float magnitude = std::max(std::abs(expected[i]), 1.0f);
+        error = std::max(error, std::abs(values[i] - expected[i]) / magnitude);
+    }
+    return error;
+}
+
+const glm::mat4 ViewProjection =
+    glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+    glm::lookAt(glm::vec3(3.0f, 4.0f, 20.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+}
+
+TEST(transformBoundsMatchesTransformedCorners)
+{
+    glm::vec3 boundsMin(-0.5f, -1.0f, -0.25f);
+    glm::vec3 boundsMax(0.5f, 2.0f, 0.75f);
+    std::vector<glm::mat4> models = randomModels(ObjectCount);
+    std::vector<glm::vec3> worldMins(ObjectCount);
+    std::vector<glm::vec3> worldMaxs(ObjectCount);
+    transformBounds(boundsMin, boundsMax, models, worldMins, worldMaxs);
+
+    float error = 0.0f;
+    for (std::size_t i = 0; i < ObjectCount; i++)
+    {
+        // The tight bounds of the eight transformed corners.
+        glm::vec3 expectedMin(INFINITY);
+        glm::vec3 expectedMax(-INFINITY);
+        for (int corner = 0; corner < 8; corner++)
+        {
+            glm::vec3 point(
+                corner & 1 ? boundsMax.x : boundsMin.x,
+                corner & 2 ? boundsMax.y : boundsMin.y,
+                corner & 4 ? boundsMax.z : boundsMin.z
+            );
+            glm::vec3 world = glm::vec3(models[i] * glm::vec4(point, 1.0f));
+            expectedMin = glm::min(expectedMin, world);
+            expectedMax = glm::max(expectedMax, world);
+        }
+        error = std::max(error, relativeError(&worldMins[i].x, &expectedMin.x, 3));
+        error = std::max(error, relativeError(&worldMaxs[i].x, &expectedMax.x, 3));
+    }
+    CHECK(error < 1e-5f);
+}
+
+TEST(packInstancesMatchesGlm)
+{
+    std::vector<glm::mat4> models = randomModels(ObjectCount);
+    std::vector<PackedInstance> instances(ObjectCount);
+    packInstances(ViewProjection, models, 42, instances);
+
+    float matrixError = 0.0f;
+    float normalError = 0.0f;
+    bool indices = true;
+    for (std::size_t i = 0; i < ObjectCount; i++)
+    {
+        const PackedInstance& instance = instances[i];
+        glm::mat4 expected = ViewProjection * models[i];
+        matrixError = std::max(
+            matrixError, relativeError(&instance.modelViewProjection[0][0], &expected[0][0], 16)
+        );
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(models[i])));
+        for (int column = 0; column < 3; column++)
+        {
+            normalError = std::max(
+                normalError,
+                relativeError(&instance.normalMatrix[column].x, &normalMatrix[column].x, 3)
+            );
+        }
+        indices = indices && instance.textureIndex == 42;
+    }
+    CHECK(matrixError < 1e-5f);
+    CHECK(normalError < 1e-5f);
+    CHECK(indices);
+}
+
+TEST(transformKernelsStopAtShortestSpan)
+{
+    std::vector<glm::mat4> models = randomModels(8);
+    std::vector<glm::vec3> worldMins(5, glm::vec3(0.0f));
+    std::vector<glm::vec3> worldMaxs(4, glm::vec3(0.0f));
+    transformBounds(glm::vec3(-1.0f), glm::vec3(1.0f), models, worldMins, worldMaxs);
+    CHECK(worldMins[3] != glm::vec3(0.0f));
+    CHECK(worldMins[4] == glm::vec3(0.0f));
+}
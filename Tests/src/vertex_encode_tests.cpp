@@ -0,0 +1,96 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "test.h"
+#include "vertex_encode.h"
+
+namespace
+{
+
+// The inverse of encodeOctahedral, as the vertex shader's decodeOctahedral does it.
+std::array<float, 3> decodeOctahedral(std::array<float, 2> encoded)
+{
+    float x = encoded[0];
+    float y = encoded[1];
+    float z = 1.0f - std::abs(x) - std::abs(y);
+    if (z < 0.0f)
+    {
+        float unfoldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float unfoldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = unfoldedX;
+        y = unfoldedY;
+    }
+    float length = std::sqrt(x * x + y * y + z * z);
+    return {x / length, y / length, z / length};
+}
+
+}
+
+TEST(encodeHalfRoundsToNearestEven)
+{
+    CHECK(encodeHalf(0.0f) == 0x0000);
+    CHECK(encodeHalf(-0.0f) == 0x8000);
+    CHECK(encodeHalf(1.0f) == 0x3C00);
+    CHECK(encodeHalf(-2.0f) == 0xC000);
+    CHECK(encodeHalf(0.1f) == 0x2E66);
+    CHECK(encodeHalf(65504.0f) == 0x7BFF);
+    // Halfway between 1 and the next half rounds to the even mantissa, below it rounds down.
+    CHECK(encodeHalf(1.0f + 1.0f / 2048.0f) == 0x3C00);
+    CHECK(encodeHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+}
+
+TEST(encodeHalfHandlesSpecialValues)
+{
+    CHECK(encodeHalf(65520.0f) == 0x7C00);
+    CHECK(encodeHalf(-1e10f) == 0xFC00);
+    CHECK(encodeHalf(std::numeric_limits<float>::infinity()) == 0x7C00);
+    CHECK(encodeHalf(std::numeric_limits<float>::quiet_NaN()) == 0x7E00);
+    // Smallest subnormal, the largest subnormal and values that round to zero.
+    CHECK(encodeHalf(std::ldexp(1.0f, -24)) == 0x0001);
+    CHECK(encodeHalf(std::ldexp(1023.0f, -24)) == 0x03FF);
+    CHECK(encodeHalf(std::ldexp(1.0f, -26)) == 0x0000);
+}
+
+TEST(encodeNormalizedIntegersClamp)
+{
+    CHECK(encodeSNorm16(1.0f) == 32767);
+    CHECK(encodeSNorm16(-1.0f) == -32767);
+    CHECK(encodeSNorm16(2.0f) == 32767);
+    CHECK(encodeSNorm16(0.0f) == 0);
+    CHECK(encodeUNorm16(1.0f) == 65535);
+    CHECK(encodeUNorm16(-1.0f) == 0);
+    CHECK(encodeUNorm16(0.5f) == 32768);
+}
+
+TEST(encodeOctahedralRoundTrips)
+{
+    constexpr int Steps = 24;
+    float largestError = 0.0f;
+    for (int i = 0; i <= Steps; i++)
+    {
+        for (int j = 0; j < Steps * 2; j++)
+        {
+            float polar = 3.14159265f * static_cast<float>(i) / Steps;
+            float azimuth = 3.14159265f * static_cast<float>(j) / Steps;
+            std::array<float, 3> normal = {
+                std::sin(polar) * std::cos(azimuth),
+                std::sin(polar) * std::sin(azimuth),
+                std::cos(polar),
+            };
+            std::array<float, 2> encoded = encodeOctahedral(normal.data());
+            CHECK(std::abs(encoded[0]) <= 1.0f && std::abs(encoded[1]) <= 1.0f);
+            std::array<float, 3> decoded = decodeOctahedral(encoded);
+            for (int axis = 0; axis < 3; axis++)
+            {
+                largestError = std::max(largestError, std::abs(decoded[axis] - normal[axis]));
+            }
+        }
+    }
+    CHECK(largestError < 1e-5f);
+
+    std::array<float, 3> zero{};
+    std::array<float, 2> encoded = encodeOctahedral(zero.data());
+    CHECK(encoded[0] == 0.0f && encoded[1] == 0.0f);
+}
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "test.h"
+#include "vertex_weld.h"
+
+namespace
+{
+
+// Values with many repeats, some of them far apart.
+std::vector<std::uint32_t> repeatingValues(std::size_t count)
+{
+    std::vector<std::uint32_t> values(count);
+    std::uint32_t state = 7;
+    for (std::uint32_t& value : values)
+    {
+        state = state * 1664525 + 1013904223;
+        value = (state >> 8) % 5000;
+    }
+    return values;
+}
+
+WeldResult weld(const std::vector<std::uint32_t>& values, std::size_t threadCount)
+{
+    return weldElements(
+        values.size(),
+        [&](std::size_t i) { return std::uint64_t{values[i]}; },
+        [&](std::size_t a, std::size_t b) { return values[a] == values[b]; },
+        threadCount
+    );
+}
+
+}
+
+TEST(weldElementsGroupsEqualElements)
+{
+    std::vector<std::uint32_t> values = repeatingValues(20000);
+    WeldResult result = weld(values, 4);
+
+    CHECK(result.remap.size() == values.size());
+    std::vector<bool> seen(5000);
+    bool grouped = true;
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        std::uint32_t representative = result.representatives[result.remap[i]];
+        grouped = grouped && values[representative] == values[i] && representative <= i;
+        seen[values[i]] = true;
+    }
+    CHECK(grouped);
+    // One representative per distinct value.
+    auto distinctCount = static_cast<std::size_t>(std::count(seen.begin(), seen.end(), true));
+    CHECK(result.representatives.size() == distinctCount);
+}
+
+TEST(weldElementsIgnoresThreadCount)
+{
+    std::vector<std::uint32_t> values = repeatingValues(50000);
+    WeldResult reference = weld(values, 1);
+    for (std::size_t threadCount : {2, 3, 8, 17})
+    {
+        WeldResult result = weld(values, threadCount);
+        CHECK(result.remap == reference.remap);
+        CHECK(result.representatives == reference.representatives);
+    }
+}
+
+TEST(weldElementsHandlesEmptyInput)
+{
+    WeldResult result = weld({}, 4);
+    CHECK(result.remap.empty());
+    CHECK(result.representatives.empty());
+}